@@ -12,7 +12,7 @@
 #include <queue>
 #include <unordered_set>
 
-int AbstractTreeModel::currentTreeId = 0;
+std::atomic<int> AbstractTreeModel::currentTreeId{0};
 AbstractTreeModel::AbstractTreeModel(QObject *parent)
     : QAbstractItemModel(parent)
 {
@@ -7,6 +7,7 @@
 
 #include "undohelper.hpp"
 #include <QAbstractItemModel>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 
@@ -104,5 +105,6 @@ protected:
 
     std::unordered_map<int, std::weak_ptr<TreeItem>> m_allItems;
 
-    static int currentTreeId;
+    /** @brief Atomic since effects may be built on worker threads while loading a timeline */
+    static std::atomic<int> currentTreeId;
 };
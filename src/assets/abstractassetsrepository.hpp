@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "assets/model/assetdescriptor.hpp"
 #include "definitions.h"
 #include <QSet>
 #include <memory>
@@ -47,6 +48,9 @@ public:
     /** @brief Returns a DomElement representing the asset's properties */
     QDomElement getXml(const QString &assetId) const;
 
+    /** @brief Returns the parsed definition of the asset's parameters, shared by all its instances. nullptr if the asset does not exist */
+    std::shared_ptr<const AssetDescriptor> getDescriptor(const QString &assetId) const;
+
 protected:
     struct Info
     {
@@ -96,11 +100,31 @@ protected:
     /** @brief Returns the path to the assets' preferred list*/
     virtual QString assetPreferredListPath() const = 0;
 
+    /** @brief Returns the name of the file caching the parsed assets between launches */
+    virtual QString assetCacheName() const = 0;
+
+    /** @brief Returns a hash of everything the parsed assets depend on: MLT and Kdenlive versions,
+       available MLT services and plugins, custom asset files and language. The cache is only used if it matches
+     */
+    QByteArray cacheSignature(const QStringList &assetDirectories) const;
+
+    /** @brief Fill m_assets from the cache file if its signature is @param signature
+       @return true on success
+     */
+    bool loadCache(const QString &path, const QByteArray &signature);
+
+    /** @brief Store m_assets in the cache file with @param signature */
+    void saveCache(const QString &path, const QByteArray &signature) const;
+
     std::unordered_map<QString, Info> m_assets;
 
     QSet<QString> m_blacklist;
 
     QSet<QString> m_preferred_list;
+
+    /** @brief The definitions parsed so far, they are rebuilt if the asset's xml changes */
+    mutable std::unordered_map<QString, std::shared_ptr<const AssetDescriptor>> m_descriptors;
+    mutable std::mutex m_descriptorsMutex;
 };
 
 #include "abstractassetsrepository.ipp"
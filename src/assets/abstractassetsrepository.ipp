@@ -6,9 +6,14 @@
 #include "xml/xml.hpp"
 #include "kdenlivesettings.h"
 #include "core.h"
+#include <config-kdenlive.h>
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QString>
 #include <QTextStream>
@@ -29,6 +34,16 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
     // Parse preferred list
     parseAssetList(assetPreferredListPath(), m_preferred_list);
 
+    // Set the directories to look into for effects.
+    const QStringList asset_dirs = assetDirs();
+
+    // Parsing all the MLT metadata and custom xml files is slow, reuse the result of the last launch if nothing changed
+    const QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/assets/") + assetCacheName();
+    const QByteArray signature = cacheSignature(asset_dirs);
+    if (loadCache(cachePath, signature)) {
+        return;
+    }
+
     // Retrieve the list of MLT's available assets.
     QScopedPointer<Mlt::Properties> assets(retrieveListFromMlt());
     QStringList emptyMetaAssets;
@@ -57,9 +72,6 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
 
     // We now parse custom effect xml
 
-    // Set the directories to look into for effects.
-    QStringList asset_dirs = assetDirs();
-
     /* Parsing of custom xml works as follows: we parse all custom files.
        Each of them contains a tag, which is the corresponding mlt asset, and an id that is the name of the asset. Note that several custom files can correspond
        to the same tag, and in that case they must have different ids. We do the parsing in a map from ids to parse info, and then we add them to the asset
@@ -123,6 +135,166 @@ template <typename AssetType> void AbstractAssetsRepository<AssetType>::init()
     for (const auto &invalid : qAsConst(emptyMetaAssets)) {
         m_assets.erase(invalid);
     }
+    saveCache(cachePath, signature);
+}
+
+template <typename AssetType> QByteArray AbstractAssetsRepository<AssetType>::cacheSignature(const QStringList &assetDirectories) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto addString = [&hash](const QString &value) {
+        hash.addData(value.toUtf8());
+        hash.addData("\n", 1);
+    };
+    auto addFile = [&addString](const QFileInfo &info) {
+        addString(QStringLiteral("%1:%2:%3").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()));
+    };
+    addString(QStringLiteral(KDENLIVE_VERSION));
+    addString(QString::fromLatin1(mlt_version_get_string()));
+    // Names and descriptions are translated
+    addString(KLocalizedString::languages().join(QLatin1Char(',')));
+    addString(QLocale().name());
+
+    // Available services, custom assets are validated against both lists
+    QScopedPointer<Mlt::Properties> filters(pCore->getMltRepository()->filters());
+    QScopedPointer<Mlt::Properties> transitions(pCore->getMltRepository()->transitions());
+    for (Mlt::Properties *services : {filters.data(), transitions.data()}) {
+        QStringList names;
+        for (int i = 0; i < services->count(); ++i) {
+            names << QString::fromUtf8(services->get_name(i));
+        }
+        names.sort();
+        addString(names.join(QLatin1Char(',')));
+    }
+    QStringList blacklist = m_blacklist.values();
+    blacklist.sort();
+    addString(blacklist.join(QLatin1Char(',')));
+
+    // Plugin upgrades can change the metadata without changing the service names
+    QStringList pluginDirs{QString::fromUtf8(mlt_environment("MLT_REPOSITORY"))};
+    QString frei0rPath = qEnvironmentVariable("FREI0R_PATH");
+    if (frei0rPath.isEmpty()) {
+        frei0rPath = QStringLiteral("/usr/lib/frei0r-1:/usr/lib64/frei0r-1:/usr/local/lib/frei0r-1:%1/.frei0r-1/lib").arg(QDir::homePath());
+    }
+    QString ladspaPath = qEnvironmentVariable("LADSPA_PATH");
+    if (ladspaPath.isEmpty()) {
+        ladspaPath = QStringLiteral("/usr/lib/ladspa:/usr/lib64/ladspa:/usr/local/lib/ladspa");
+    }
+    pluginDirs << frei0rPath.split(QDir::listSeparator(), Qt::SkipEmptyParts) << ladspaPath.split(QDir::listSeparator(), Qt::SkipEmptyParts);
+    for (const QString &path : qAsConst(pluginDirs)) {
+        QDir dir(path);
+        if (path.isEmpty() || !dir.exists()) {
+            continue;
+        }
+        addFile(QFileInfo(dir.absolutePath()));
+        const QFileInfoList plugins = dir.entryInfoList(QDir::Files, QDir::Name);
+        for (const QFileInfo &plugin : plugins) {
+            addFile(plugin);
+        }
+    }
+
+    // Custom asset definitions
+    for (const QString &path : assetDirectories) {
+        QDir dir(path);
+        addFile(QFileInfo(dir.absolutePath()));
+        const QFileInfoList files = dir.entryInfoList({QStringLiteral("*.xml")}, QDir::Files, QDir::Name);
+        for (const QFileInfo &file : files) {
+            addFile(file);
+        }
+    }
+    return hash.result();
+}
+
+static const quint32 assetCacheMagic = 0x4b444143;
+static const quint16 assetCacheVersion = 1;
+
+template <typename AssetType> bool AbstractAssetsRepository<AssetType>::loadCache(const QString &path, const QByteArray &signature)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+    quint32 magic;
+    quint16 version;
+    QByteArray cachedSignature;
+    in >> magic >> version;
+    if (magic != assetCacheMagic || version != assetCacheVersion) {
+        return false;
+    }
+    in >> cachedSignature;
+    if (cachedSignature != signature) {
+        return false;
+    }
+    qint32 count;
+    in >> count;
+    std::vector<std::pair<QString, Info>> assets;
+    std::vector<bool> hasXml;
+    assets.reserve(size_t(qMax(0, count)));
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        Info info;
+        qint32 type;
+        bool xml;
+        in >> key >> info.id >> info.mltId >> info.name >> info.description >> info.author >> info.version_str >> info.version >> type >> xml;
+        info.type = AssetType(type);
+        assets.emplace_back(key, info);
+        hasXml.push_back(xml);
+    }
+    // All the definitions are stored in a single document, parsed at once
+    QByteArray definitions;
+    in >> definitions;
+    QDomDocument doc;
+    if (in.status() != QDataStream::Ok || !doc.setContent(definitions)) {
+        qWarning() << "Invalid asset cache" << path;
+        return false;
+    }
+    QDomElement element = doc.documentElement().firstChildElement();
+    for (size_t i = 0; i < assets.size(); ++i) {
+        if (hasXml[i]) {
+            if (element.isNull()) {
+                qWarning() << "Invalid asset cache" << path;
+                return false;
+            }
+            assets[i].second.xml = element;
+            element = element.nextSiblingElement();
+        }
+    }
+    for (const auto &asset : assets) {
+        m_assets[asset.first] = asset.second;
+    }
+    return true;
+}
+
+template <typename AssetType> void AbstractAssetsRepository<AssetType>::saveCache(const QString &path, const QByteArray &signature) const
+{
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return;
+    }
+    QDomDocument doc;
+    QDomElement root = doc.createElement(QStringLiteral("assets"));
+    doc.appendChild(root);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write asset cache" << path;
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << assetCacheMagic << assetCacheVersion << signature << qint32(m_assets.size());
+    for (const auto &asset : m_assets) {
+        const Info &info = asset.second;
+        const bool hasXml = !info.xml.isNull();
+        out << asset.first << info.id << info.mltId << info.name << info.description << info.author << info.version_str << qint32(info.version) << qint32(info.type)
+            << hasXml;
+        if (hasXml) {
+            root.appendChild(doc.importNode(info.xml, true));
+        }
+    }
+    out << doc.toByteArray(-1);
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Cannot write asset cache" << path;
+    }
 }
 
 template <typename AssetType> void AbstractAssetsRepository<AssetType>::parseAssetList(const QString &filePath, QSet<QString> &destination)
@@ -380,3 +552,19 @@ template <typename AssetType> QDomElement AbstractAssetsRepository<AssetType>::g
     }
     return m_assets.at(assetId).xml.cloneNode().toElement();
 }
+
+template <typename AssetType> std::shared_ptr<const AssetDescriptor> AbstractAssetsRepository<AssetType>::getDescriptor(const QString &assetId) const
+{
+    std::lock_guard<std::mutex> lock(m_descriptorsMutex);
+    if (m_assets.count(assetId) == 0) {
+        return nullptr;
+    }
+    const QDomElement &xml = m_assets.at(assetId).xml;
+    auto it = m_descriptors.find(assetId);
+    if (it != m_descriptors.end() && it->second->isBuiltFrom(xml)) {
+        return it->second;
+    }
+    auto descriptor = std::make_shared<const AssetDescriptor>(xml);
+    m_descriptors[assetId] = descriptor;
+    return descriptor;
+}
@@ -69,8 +69,8 @@ bool KeyframeModel::addKeyframe(GenTime pos, KeyframeType type, QVariant value,
             return true; // nothing to do
         }
         // In this case we simply change the type and value
-        KeyframeType oldType = m_keyframeList[pos].first;
-        QVariant oldValue = m_keyframeList[pos].second;
+        KeyframeType oldType = m_keyframeList.at(pos).first;
+        QVariant oldValue = m_keyframeList.at(pos).second;
         local_undo = updateKeyframe_lambda(pos, oldType, oldValue, notify);
         local_redo = updateKeyframe_lambda(pos, type, value, notify);
         if (local_redo()) {
@@ -89,6 +89,48 @@ bool KeyframeModel::addKeyframe(GenTime pos, KeyframeType type, QVariant value,
     return false;
 }
 
+bool KeyframeModel::addKeyframes(const std::vector<Keyframe> &keyframes, const QVector<QVariant> &values, Fun &undo, Fun &redo)
+{
+    QWriteLocker locker(&m_lock);
+    Q_ASSERT(int(keyframes.size()) == values.size());
+    // Remember the keyframes that are replaced to restore them on undo
+    std::vector<KeyframeStore::value_type> replaced;
+    std::vector<GenTime> added;
+    for (const Keyframe &keyframe : keyframes) {
+        auto it = m_keyframeList.find(keyframe.first);
+        if (it != m_keyframeList.end()) {
+            replaced.push_back(*it);
+        } else {
+            added.push_back(keyframe.first);
+        }
+    }
+    Fun local_redo = [this, keyframes, values]() {
+        beginResetModel();
+        for (size_t i = 0; i < keyframes.size(); ++i) {
+            m_keyframeList.set(keyframes[i].first, keyframes[i].second, values.at(int(i)));
+        }
+        endResetModel();
+        return true;
+    };
+    Fun local_undo = [this, replaced, added]() {
+        beginResetModel();
+        // Remove from the end, which is cheap in the keyframe store
+        for (auto pos = added.crbegin(); pos != added.crend(); ++pos) {
+            m_keyframeList.erase(*pos);
+        }
+        for (const auto &keyframe : replaced) {
+            m_keyframeList.set(keyframe.first, keyframe.second.first, keyframe.second.second);
+        }
+        endResetModel();
+        return true;
+    };
+    if (local_redo()) {
+        UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+        return true;
+    }
+    return false;
+}
+
 bool KeyframeModel::addKeyframe(int frame, double normalizedValue)
 {
     QVariant result = getNormalizedValue(normalizedValue);
@@ -116,11 +158,10 @@ bool KeyframeModel::addKeyframe(GenTime pos, KeyframeType type, QVariant value)
 bool KeyframeModel::removeKeyframe(GenTime pos, Fun &undo, Fun &redo, bool notify, bool updateSelection)
 {
     qDebug() << "Going to remove keyframe at " << pos.frames(pCore->getCurrentFps()) << " NOTIFY: " << notify;
-    qDebug() << "before" << getAnimProperty();
     QWriteLocker locker(&m_lock);
     Q_ASSERT(m_keyframeList.count(pos) > 0);
-    KeyframeType oldType = m_keyframeList[pos].first;
-    QVariant oldValue = m_keyframeList[pos].second;
+    KeyframeType oldType = m_keyframeList.at(pos).first;
+    QVariant oldValue = m_keyframeList.at(pos).second;
     Fun select_undo = []() { return true; };
     Fun select_redo = []() { return true; };
     if (updateSelection) {
@@ -157,7 +198,6 @@ bool KeyframeModel::removeKeyframe(GenTime pos, Fun &undo, Fun &redo, bool notif
         Fun local_undo = addKeyframe_lambda(pos, oldType, oldValue, true);
         Fun local_redo = deleteKeyframe_lambda(pos, true);
         select_redo();
-        qDebug() << "after" << getAnimProperty();
         UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
         UPDATE_UNDO_REDO(select_redo, select_undo, undo, redo);
         return true;
@@ -169,8 +209,8 @@ bool KeyframeModel::duplicateKeyframe(GenTime srcPos, GenTime dstPos, Fun &undo,
 {
     QWriteLocker locker(&m_lock);
     Q_ASSERT(m_keyframeList.count(srcPos) > 0);
-    KeyframeType oldType = m_keyframeList[srcPos].first;
-    QVariant oldValue = m_keyframeList[srcPos].second;
+    KeyframeType oldType = m_keyframeList.at(srcPos).first;
+    QVariant oldValue = m_keyframeList.at(srcPos).second;
     Fun local_redo = addKeyframe_lambda(dstPos, oldType, oldValue, true);
     Fun local_undo = deleteKeyframe_lambda(dstPos, true);
     if (local_redo()) {
@@ -332,15 +372,13 @@ bool KeyframeModel::moveOneKeyframe(GenTime oldPos, GenTime pos, QVariant newVal
         qDebug() << "==== MOVE REJECTED!!";
         return false;
     }
-    KeyframeType oldType = m_keyframeList[oldPos].first;
-    QVariant oldValue = m_keyframeList[oldPos].second;
+    KeyframeType oldType = m_keyframeList.at(oldPos).first;
+    QVariant oldValue = m_keyframeList.at(oldPos).second;
     Fun local_undo = []() { return true; };
     Fun local_redo = []() { return true; };
-    qDebug() << getAnimProperty();
     // TODO: use the new Animation::key_set_frame to move a keyframe
     bool res = removeKeyframe(oldPos, local_undo, local_redo, true, false);
     qDebug() << "Move keyframe finished deletion:" << res;
-    qDebug() << getAnimProperty();
     if (res) {
         if (m_paramType == ParamType::AnimatedRect) {
             if (!newVal.isValid()) {
@@ -356,7 +394,6 @@ bool KeyframeModel::moveOneKeyframe(GenTime oldPos, GenTime pos, QVariant newVal
             res = addKeyframe(pos, oldType, oldValue, updateView, local_undo, local_redo);
         }
         qDebug() << "Move keyframe finished insertion:" << res;
-        qDebug() << getAnimProperty();
     }
     if (res) {
         UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
@@ -423,7 +460,7 @@ bool KeyframeModel::directUpdateKeyframe(GenTime pos, QVariant value)
 {
     QWriteLocker locker(&m_lock);
     Q_ASSERT(m_keyframeList.count(pos) > 0);
-    KeyframeType type = m_keyframeList[pos].first;
+    KeyframeType type = m_keyframeList.at(pos).first;
     auto operation = updateKeyframe_lambda(pos, type, std::move(value), true);
     return operation();
 }
@@ -432,8 +469,8 @@ bool KeyframeModel::updateKeyframe(GenTime pos, const QVariant &value, Fun &undo
 {
     QWriteLocker locker(&m_lock);
     Q_ASSERT(m_keyframeList.count(pos) > 0);
-    KeyframeType type = m_keyframeList[pos].first;
-    QVariant oldValue = m_keyframeList[pos].second;
+    KeyframeType type = m_keyframeList.at(pos).first;
+    QVariant oldValue = m_keyframeList.at(pos).second;
     // Check if keyframe is different
     if (m_paramType == ParamType::KeyframeParam || m_paramType == ParamType::ColorWheel) {
         if (qFuzzyCompare(oldValue.toDouble(), value.toDouble())) return true;
@@ -507,9 +544,9 @@ bool KeyframeModel::updateKeyframeType(GenTime pos, int type, Fun &undo, Fun &re
 {
     QWriteLocker locker(&m_lock);
     Q_ASSERT(m_keyframeList.count(pos) > 0);
-    KeyframeType oldType = m_keyframeList[pos].first;
+    KeyframeType oldType = m_keyframeList.at(pos).first;
     KeyframeType newType = convertFromMltType(mlt_keyframe_type(type));
-    QVariant value = m_keyframeList[pos].second;
+    QVariant value = m_keyframeList.at(pos).second;
     // Check if keyframe is different
     if (m_paramType == ParamType::KeyframeParam || m_paramType == ParamType::ColorWheel) {
         if (oldType == newType) return true;
@@ -530,8 +567,7 @@ Fun KeyframeModel::updateKeyframe_lambda(GenTime pos, KeyframeType type, const Q
         // qDebug() << "update lambda" << pos.frames(pCore->getCurrentFps()) << value << notify;
         Q_ASSERT(m_keyframeList.count(pos) > 0);
         int row = static_cast<int>(std::distance(m_keyframeList.begin(), m_keyframeList.find(pos)));
-        m_keyframeList[pos].first = type;
-        m_keyframeList[pos].second = value;
+        m_keyframeList.set(pos, type, value);
         if (notify) Q_EMIT dataChanged(index(row), index(row), {ValueRole, NormalizedValueRole, TypeRole});
         return true;
     };
@@ -550,8 +586,7 @@ Fun KeyframeModel::addKeyframe_lambda(GenTime pos, KeyframeType type, const QVar
             insertionRow = static_cast<int>(std::distance(m_keyframeList.begin(), insertionIt));
         }
         if (notify) beginInsertRows(QModelIndex(), insertionRow, insertionRow);
-        m_keyframeList[pos].first = type;
-        m_keyframeList[pos].second = value;
+        m_keyframeList.set(pos, type, value);
         if (notify) endInsertRows();
         return true;
     };
@@ -562,14 +597,12 @@ Fun KeyframeModel::deleteKeyframe_lambda(GenTime pos, bool notify)
     QWriteLocker locker(&m_lock);
     return [this, pos, notify]() {
         qDebug() << "delete lambda" << pos.frames(pCore->getCurrentFps()) << notify;
-        qDebug() << "before" << getAnimProperty();
         Q_ASSERT(m_keyframeList.count(pos) > 0);
         // Q_ASSERT(pos != GenTime()); // cannot delete initial point
         int row = static_cast<int>(std::distance(m_keyframeList.begin(), m_keyframeList.find(pos)));
         if (notify) beginRemoveRows(QModelIndex(), row, row);
         m_keyframeList.erase(pos);
         if (notify) endRemoveRows();
-        qDebug() << "after" << getAnimProperty();
         return true;
     };
 }
@@ -758,6 +791,39 @@ bool KeyframeModel::hasKeyframe(const GenTime &pos) const
     return m_keyframeList.count(pos) > 0;
 }
 
+QVariantList KeyframeModel::curvePoints(int startFrame, int endFrame, int maxPoints) const
+{
+    READ_LOCK();
+    QVariantList points;
+    if (m_keyframeList.size() == 0) {
+        return points;
+    }
+    const double fps = pCore->getCurrentFps();
+    const int step = qMax(1, (endFrame - startFrame) / qMax(1, maxPoints));
+    auto appendPoint = [this, &points, fps](KeyframeStore::const_iterator it) {
+        int row = int(std::distance(m_keyframeList.begin(), it));
+        points << it->first.frames(fps) << data(index(row), NormalizedValueRole) << int(it->second.first);
+    };
+    // Start from the last keyframe before the range so that the curve is continuous
+    auto it = m_keyframeList.upper_bound(GenTime(startFrame, fps));
+    if (it != m_keyframeList.begin()) {
+        --it;
+    }
+    while (it != m_keyframeList.end()) {
+        int frame = it->first.frames(fps);
+        auto next = step > 1 ? m_keyframeList.lower_bound(GenTime(frame + step, fps)) : it + 1;
+        appendPoint(it);
+        if (next - 1 != it) {
+            appendPoint(next - 1);
+        }
+        if (frame > endFrame) {
+            break;
+        }
+        it = next;
+    }
+    return points;
+}
+
 bool KeyframeModel::removeAllKeyframes(Fun &undo, Fun &redo)
 {
     QWriteLocker locker(&m_lock);
@@ -795,13 +861,9 @@ bool KeyframeModel::removeAllKeyframes(Fun &undo, Fun &redo)
     QList<GenTime> all_pos = getKeyframePos();
     update_redo_start();
     bool res = true;
-    bool first = true;
-    for (const auto &p : qAsConst(all_pos)) {
-        if (first) { // skip first point
-            first = false;
-            continue;
-        }
-        res = removeKeyframe(p, local_undo, local_redo, false);
+    // Remove from the end, which is cheap in the keyframe store. Keep the first point
+    for (int i = all_pos.size() - 1; i > 0; --i) {
+        res = removeKeyframe(all_pos.at(i), local_undo, local_redo, false);
         if (!res) {
             bool undone = local_undo();
             Q_ASSERT(undone);
@@ -827,55 +889,13 @@ bool KeyframeModel::removeAllKeyframes()
     return res;
 }
 
-mlt_keyframe_type convertToMltType(KeyframeType type)
-{
-    switch (type) {
-    case KeyframeType::Linear:
-        return mlt_keyframe_linear;
-    case KeyframeType::Discrete:
-        return mlt_keyframe_discrete;
-    case KeyframeType::Curve:
-        return mlt_keyframe_smooth;
-    }
-    return mlt_keyframe_linear;
-}
-
 QString KeyframeModel::getAnimProperty() const
 {
     if (m_paramType == ParamType::Roto_spline) {
         return getRotoProperty();
     }
-    Mlt::Properties mlt_prop;
-    if (auto ptr = m_model.lock()) {
-        ptr->passProperties(mlt_prop);
-    }
-    int ix = 0;
-    bool first = true;
-    std::shared_ptr<Mlt::Animation> anim(nullptr);
-    for (const auto &keyframe : m_keyframeList) {
-        switch (m_paramType) {
-        case ParamType::AnimatedRect:
-        case ParamType::Color:
-            mlt_prop.anim_set("key", keyframe.second.second.toString().toUtf8().constData(), keyframe.first.frames(pCore->getCurrentFps()));
-            break;
-        default:
-            mlt_prop.anim_set("key", keyframe.second.second.toDouble(), keyframe.first.frames(pCore->getCurrentFps()));
-            break;
-        }
-        if (first) {
-            anim.reset(mlt_prop.get_anim("key"));
-            first = false;
-        }
-        anim->key_set_type(ix, convertToMltType(keyframe.second.first));
-        ix++;
-    }
-    QString ret;
-    if (anim) {
-        char *cut = anim->serialize_cut();
-        ret = QString(cut);
-        free(cut);
-    }
-    return ret;
+    bool stringValues = m_paramType == ParamType::AnimatedRect || m_paramType == ParamType::Color;
+    return m_keyframeList.animationString(pCore->getCurrentFps(), stringValues);
 }
 
 QString KeyframeModel::getRotoProperty() const
@@ -1118,7 +1138,7 @@ QVariant KeyframeModel::getInterpolatedValue(const GenTime &pos) const
         ptr->passProperties(mlt_prop);
         out = ptr->data(m_index, AssetParameterModel::ParentDurationRole).toInt();
         useOpacity = ptr->data(m_index, AssetParameterModel::OpacityRole).toBool();
-        animData = ptr->data(m_index, AssetParameterModel::ValueRole).toString();
+        animData = m_pendingModification ? getAnimProperty() : ptr->data(m_index, AssetParameterModel::ValueRole).toString();
     }
 
     if (!animData.isEmpty() && (m_paramType == ParamType::KeyframeParam || m_paramType == ParamType::ColorWheel)) {
@@ -1192,6 +1212,19 @@ QVariant KeyframeModel::getInterpolatedValue(const GenTime &pos) const
 
 void KeyframeModel::sendModification()
 {
+    if (m_pendingModification) {
+        return;
+    }
+    m_pendingModification = true;
+    QMetaObject::invokeMethod(this, &KeyframeModel::commitModification, Qt::QueuedConnection);
+}
+
+void KeyframeModel::commitModification()
+{
+    if (!m_pendingModification) {
+        return;
+    }
+    m_pendingModification = false;
     if (auto ptr = m_model.lock()) {
         Q_ASSERT(m_index.isValid());
         QString name = ptr->data(m_index, AssetParameterModel::NameRole).toString();
@@ -1246,6 +1279,8 @@ void KeyframeModel::refresh()
         // qDebug() << "// DATA WAS ALREADY PARSED, ABORTING REFRESH\n";
         return;
     }
+    // The asset was modified from outside, this replaces our uncommitted changes
+    m_pendingModification = false;
     if (m_paramType == ParamType::Roto_spline) {
         parseRotoProperty(animData);
     } else if (AssetParameterModel::isAnimated(m_paramType)) {
@@ -1280,6 +1315,7 @@ void KeyframeModel::reset()
         qDebug() << "// DATA WAS ALREADY PARSED, ABORTING\n_________________";
         return;
     }
+    m_pendingModification = false;
     if (m_paramType == ParamType::Roto_spline) {
         // TODO: resetRotoProperty(animData);
     } else if (AssetParameterModel::isAnimated(m_paramType)) {
@@ -1302,6 +1338,22 @@ void KeyframeModel::reset()
     m_lastData = animData;
 }
 
+bool KeyframeModel::shareKeyframes(const KeyframeModel &source)
+{
+    if (&source == this) {
+        return true;
+    }
+    QWriteLocker locker(&m_lock);
+    QReadLocker sourceLocker(&source.m_lock);
+    if (m_paramType != source.m_paramType || !(m_keyframeList == source.m_keyframeList)) {
+        return false;
+    }
+    if (!m_keyframeList.isSharedWith(source.m_keyframeList)) {
+        m_keyframeList = source.m_keyframeList;
+    }
+    return true;
+}
+
 QList<QPoint> KeyframeModel::getRanges(const QString &animData, const std::shared_ptr<AssetParameterModel> &model)
 {
     Mlt::Properties mlt_prop;
@@ -1431,8 +1483,9 @@ bool KeyframeModel::removeNextKeyframes(GenTime pos, Fun &undo, Fun &redo)
     PUSH_LAMBDA(update_redo_start, local_redo);
     PUSH_LAMBDA(update_undo_start, local_undo);
     update_redo_start();
-    for (const auto &p : all_pos) {
-        bool res = removeKeyframe(p, local_undo, local_redo, false);
+    // Remove from the end, which is cheap in the keyframe store
+    for (auto p = all_pos.crbegin(); p != all_pos.crend(); ++p) {
+        bool res = removeKeyframe(*p, local_undo, local_redo, false);
         if (!res) {
             bool undone = local_undo();
             Q_ASSERT(undone);
@@ -7,27 +7,25 @@
 
 #include "assets/model/assetparametermodel.hpp"
 #include "definitions.h"
+#include "keyframestore.hpp"
 #include "undohelper.hpp"
 #include "utils/gentime.h"
 
 #include <QAbstractListModel>
 #include <QReadWriteLock>
 
-#include <map>
 #include <memory>
 
 class AssetParameterModel;
 class DocUndoStack;
 class EffectItemModel;
 
-enum class KeyframeType { Linear = mlt_keyframe_linear, Discrete = mlt_keyframe_discrete, Curve = mlt_keyframe_smooth };
-Q_DECLARE_METATYPE(KeyframeType)
-using Keyframe = std::pair<GenTime, KeyframeType>;
-
 /** @class KeyframeModel
     @brief This class is the model for a list of keyframes.
    A keyframe is defined by a time, a type and a value
-   We store them in a sorted fashion using a std::map
+   We store them in a sorted fashion using a KeyframeStore.
+   Modifications are sent to the asset once per event loop iteration, so that an operation touching many
+   keyframes only serializes the animation once.
  */
 class KeyframeModel : public QAbstractListModel
 {
@@ -60,6 +58,11 @@ protected:
        @param notify: if true, send a signal to model
      */
     bool addKeyframe(GenTime pos, KeyframeType type, QVariant value, bool notify, Fun &undo, Fun &redo);
+    /** @brief Add or replace many keyframes at once with a single model reset, accumulating undo/redo
+       @param keyframes are the positions and types of the keyframes, sorted by position
+       @param values are the corresponding values
+     */
+    bool addKeyframes(const std::vector<Keyframe> &keyframes, const QVector<QVariant> &values, Fun &undo, Fun &redo);
 
     /** @brief Removes the keyframe at the given position. */
     bool removeKeyframe(int frame);
@@ -133,11 +136,20 @@ public:
     Q_INVOKABLE bool hasKeyframe(int frame) const;
     Q_INVOKABLE bool hasKeyframe(const GenTime &pos) const;
     Q_INVOKABLE QString realValue(double normalizedValue) const;
+    /** @brief Returns the keyframes needed to draw the curve between @param startFrame and @param endFrame, including the
+       keyframes just outside of this range, as a flat list of frame, normalized value and type.
+       Keyframes closer than (endFrame - startFrame) / @param maxPoints frames are merged to the first and last of them.
+     */
+    Q_INVOKABLE QVariantList curvePoints(int startFrame, int endFrame, int maxPoints) const;
 
     /** @brief Read the value from the model and update itself accordingly */
     void refresh();
     /** @brief Reset all values to their default */
     void reset();
+    /** @brief Share the keyframe storage of @param source if both models have the same keyframes.
+        The keyframes are copied on the first modification of either model.
+        Returns true if the storage is shared */
+    bool shareKeyframes(const KeyframeModel &source);
 
     /** @brief Return the interpolated value at given pos */
     QVariant getInterpolatedValue(int pos) const;
@@ -175,8 +187,10 @@ protected:
     /** @brief Connects the signals of this object */
     void setup();
 
-    /** @brief Commit the modification to the model */
+    /** @brief Schedule the commit of the modification to the model */
     void sendModification();
+    /** @brief Commit the pending modification to the model, if any */
+    void commitModification();
 
     /** @brief returns the keyframes as a Mlt Anim Property string.
         It is defined as pairs of frame and value, separated by ;
@@ -202,7 +216,9 @@ private:
     /** @brief This is a lock that ensures safety in case of concurrent access */
     mutable QReadWriteLock m_lock;
 
-    std::map<GenTime, std::pair<KeyframeType, QVariant>> m_keyframeList;
+    KeyframeStore m_keyframeList;
+    /** @brief True if the keyframes were modified since they were last sent to the asset */
+    bool m_pendingModification{false};
     bool moveOneKeyframe(GenTime oldPos, GenTime pos, QVariant newVal, Fun &undo, Fun &redo, bool updateView = true);
 
 Q_SIGNALS:
@@ -14,7 +14,104 @@
 #include <kdenlivesettings.h>
 
 #include <QDebug>
+#include <algorithm>
+#include <cmath>
 #include <utility>
+
+namespace {
+/** @brief Split a keyframe value in numbers, returns false if it is not numeric (colors, splines...) */
+bool numericComponents(const QVariant &value, std::vector<double> &result)
+{
+    result.clear();
+    if (value.type() == QVariant::Double || value.type() == QVariant::Int) {
+        result.push_back(value.toDouble());
+        return true;
+    }
+    // Rects and other multi-value parameters are space separated
+    const QStringList parts = value.toString().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    for (const QString &part : parts) {
+        bool ok;
+        result.push_back(part.toDouble(&ok));
+        if (!ok) {
+            return false;
+        }
+    }
+    return !result.empty();
+}
+
+/** @brief Ramer-Douglas-Peucker simplification of a keyframe curve
+   @param keyframes are the keyframe positions and types
+   @param components are the curves to simplify together, each one has one number per keyframe
+   @param tolerance is the allowed interpolation error, as a fraction of the range of each curve
+   @return which keyframes must be kept
+ */
+std::vector<bool> simplifyKeyframes(const std::vector<Keyframe> &keyframes, const std::vector<std::vector<double>> &components, double tolerance)
+{
+    const size_t count = keyframes.size();
+    std::vector<bool> keep(count, false);
+    if (count == 0) {
+        return keep;
+    }
+    std::vector<double> ranges;
+    for (const auto &curve : components) {
+        const auto bounds = std::minmax_element(curve.cbegin(), curve.cend());
+        ranges.push_back(*bounds.second - *bounds.first);
+    }
+    const double fps = pCore->getCurrentFps();
+    auto error = [&](size_t first, size_t last, size_t ix) {
+        const double start = keyframes[first].first.frames(fps);
+        const double ratio = (keyframes[ix].first.frames(fps) - start) / (keyframes[last].first.frames(fps) - start);
+        double maxError = 0.;
+        for (size_t c = 0; c < components.size(); ++c) {
+            if (ranges[c] <= 0.) {
+                continue;
+            }
+            const auto &curve = components[c];
+            const double interpolated = curve[first] + (curve[last] - curve[first]) * ratio;
+            maxError = qMax(maxError, std::abs(curve[ix] - interpolated) / ranges[c]);
+        }
+        return maxError;
+    };
+    // Only linear segments can be simplified, the boundaries of other segments are kept
+    keep.front() = true;
+    keep.back() = true;
+    for (size_t i = 1; i < count; ++i) {
+        if (keyframes[i].second != KeyframeType::Linear || keyframes[i - 1].second != KeyframeType::Linear) {
+            keep[i - 1] = true;
+            keep[i] = true;
+        }
+    }
+    std::vector<std::pair<size_t, size_t>> segments;
+    size_t previous = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (keep[i]) {
+            segments.emplace_back(previous, i);
+            previous = i;
+        }
+    }
+    // Iterative to support long tracks
+    while (!segments.empty()) {
+        const auto segment = segments.back();
+        segments.pop_back();
+        double maxError = 0.;
+        size_t farthest = segment.first;
+        for (size_t i = segment.first + 1; i < segment.second; ++i) {
+            double err = error(segment.first, segment.second, i);
+            if (err > maxError) {
+                maxError = err;
+                farthest = i;
+            }
+        }
+        if (maxError > tolerance) {
+            keep[farthest] = true;
+            segments.emplace_back(segment.first, farthest);
+            segments.emplace_back(farthest, segment.second);
+        }
+    }
+    return keep;
+}
+} // namespace
+
 KeyframeModelList::KeyframeModelList(std::weak_ptr<AssetParameterModel> model, const QModelIndex &index, std::weak_ptr<DocUndoStack> undo_stack)
     : m_model(std::move(model))
     , m_undoStack(std::move(undo_stack))
@@ -135,6 +232,76 @@ bool KeyframeModelList::addKeyframe(GenTime pos, KeyframeType type)
     return applyOperation(op, update ? i18n("Change keyframe type") : i18n("Add keyframe"));
 }
 
+bool KeyframeModelList::addKeyframes(const std::vector<Keyframe> &keyframes, const QMap<QPersistentModelIndex, QVector<QVariant>> &values, double tolerance,
+                                     Fun &undo, Fun &redo)
+{
+    QWriteLocker locker(&m_lock);
+    Q_ASSERT(m_parameters.size() > 0);
+    if (keyframes.empty()) {
+        return true;
+    }
+    // Read all the values before any modification, other parameters keep their current animation
+    std::map<QPersistentModelIndex, QVector<QVariant>> paramValues;
+    for (const auto &param : m_parameters) {
+        QVector<QVariant> list = values.value(param.first);
+        list.resize(int(keyframes.size()));
+        for (int i = 0; i < list.size(); ++i) {
+            if (!list.at(i).isValid()) {
+                list[i] = param.second->getInterpolatedValue(keyframes[size_t(i)].first);
+            }
+        }
+        paramValues[param.first] = list;
+    }
+    std::vector<bool> keep(keyframes.size(), true);
+    if (tolerance > 0. && keyframes.size() > 2) {
+        std::vector<std::vector<double>> components;
+        std::vector<double> numbers;
+        bool numeric = true;
+        for (const auto &param : paramValues) {
+            size_t firstComponent = components.size();
+            for (int i = 0; numeric && i < param.second.size(); ++i) {
+                numeric = numericComponents(param.second.at(i), numbers);
+                if (i == 0) {
+                    components.resize(firstComponent + numbers.size(), std::vector<double>(keyframes.size()));
+                }
+                numeric = numeric && numbers.size() == components.size() - firstComponent;
+                for (size_t c = 0; numeric && c < numbers.size(); ++c) {
+                    components[firstComponent + c][size_t(i)] = numbers[c];
+                }
+            }
+        }
+        // Non numeric data like rotoscoping shapes is imported as is
+        if (numeric) {
+            keep = simplifyKeyframes(keyframes, components, tolerance);
+        }
+    }
+    std::vector<Keyframe> kept;
+    for (size_t i = 0; i < keyframes.size(); ++i) {
+        if (keep[i]) {
+            kept.push_back(keyframes[i]);
+        }
+    }
+    Fun local_undo = []() { return true; };
+    Fun local_redo = []() { return true; };
+    for (const auto &param : m_parameters) {
+        const QVector<QVariant> &list = paramValues.at(param.first);
+        QVector<QVariant> keptValues;
+        keptValues.reserve(int(kept.size()));
+        for (size_t i = 0; i < keyframes.size(); ++i) {
+            if (keep[i]) {
+                keptValues << list.at(int(i));
+            }
+        }
+        if (!param.second->addKeyframes(kept, keptValues, local_undo, local_redo)) {
+            bool undone = local_undo();
+            Q_ASSERT(undone);
+            return false;
+        }
+    }
+    UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+    return true;
+}
+
 bool KeyframeModelList::addKeyframe(int frame, double val)
 {
     QWriteLocker locker(&m_lock);
@@ -453,6 +620,27 @@ void KeyframeModelList::reset()
     }
 }
 
+int KeyframeModelList::shareKeyframes(const KeyframeModelList &source)
+{
+    if (&source == this) {
+        return 0;
+    }
+    QWriteLocker locker(&m_lock);
+    QReadLocker sourceLocker(&source.m_lock);
+    int shared = 0;
+    for (const auto &param : m_parameters) {
+        for (const auto &sourceParam : source.m_parameters) {
+            if (sourceParam.first.row() == param.first.row()) {
+                if (param.second->shareKeyframes(*sourceParam.second.get())) {
+                    ++shared;
+                }
+                break;
+            }
+        }
+    }
+    return shared;
+}
+
 QVariant KeyframeModelList::getInterpolatedValue(int pos, const QPersistentModelIndex &index) const
 {
     READ_LOCK();
@@ -634,6 +822,14 @@ void KeyframeModelList::resizeKeyframes(int oldIn, int oldOut, int in, int out,
     }
 }
 
+void KeyframeModelList::moveModelsToThread(QThread *thread)
+{
+    moveToThread(thread);
+    for (const auto &param : m_parameters) {
+        param.second->moveToThread(thread);
+    }
+}
+
 void KeyframeModelList::checkConsistency()
 {
     if (m_parameters.size() < 2) {
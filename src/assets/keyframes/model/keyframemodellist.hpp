@@ -12,6 +12,7 @@
 
 #include <QReadWriteLock>
 
+#include <QMap>
 #include <QObject>
 #include <map>
 #include <memory>
@@ -44,6 +45,16 @@ public:
      */
     bool addKeyframe(GenTime pos, KeyframeType type);
     bool addKeyframe(int frame, double val);
+    /** @brief Adds or updates many keyframes of several parameters in one operation, accumulating undo/redo.
+       This is meant to import long animations like motion tracking data.
+       @param keyframes are the positions and types of the keyframes, sorted by position
+       @param values are the values of each parameter, aligned with @param keyframes. Parameters that are not
+       listed, or have an invalid value, keep their current interpolated value at the keyframe position
+       @param tolerance if positive, keyframes that can be interpolated from their neighbours with an error below
+       this fraction of the values range are dropped (Ramer-Douglas-Peucker simplification)
+     */
+    bool addKeyframes(const std::vector<Keyframe> &keyframes, const QMap<QPersistentModelIndex, QVector<QVariant>> &values, double tolerance, Fun &undo,
+                      Fun &redo);
 
     /** @brief Removes the keyframe at the given position. */
     bool removeKeyframe(GenTime pos);
@@ -124,6 +135,9 @@ public:
     void setParametersFromTask(const paramVector &params);
     /** @brief Reset all keyframes and add a default one */
     void reset();
+    /** @brief Share the keyframe storage of the parameters that have the same keyframes in @param source,
+        parameters are matched by row. Returns the number of shared parameters */
+    int shareKeyframes(const KeyframeModelList &source);
     Q_INVOKABLE KeyframeModel *getKeyModel();
     KeyframeModel *getKeyModel(const QPersistentModelIndex &index);
     /** @brief Returns parent asset owner id*/
@@ -160,6 +174,8 @@ public:
     /** @brief Check that all keyframable parameters have the same keyframes on loading
      *  (that's how our model works) */
     void checkConsistency();
+    /** @brief Change the thread affinity of this list and of all its keyframe models */
+    void moveModelsToThread(QThread *thread);
     /** @brief Returns the indexes of all parameters */
     std::vector<QPersistentModelIndex> getIndexes();
 
@@ -0,0 +1,177 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "keyframestore.hpp"
+
+#include <algorithm>
+
+namespace {
+bool keyframeBefore(const KeyframeStore::value_type &keyframe, const GenTime &pos)
+{
+    return keyframe.first < pos;
+}
+
+bool keyframeAfter(const GenTime &pos, const KeyframeStore::value_type &keyframe)
+{
+    return pos < keyframe.first;
+}
+} // namespace
+
+KeyframeStore::Data::Data(const Data &other)
+    : QSharedData(other)
+    , keyframes(other.keyframes)
+{
+    QMutexLocker lock(&other.serializeMutex);
+    serialized = other.serialized;
+    serializedFps = other.serializedFps;
+}
+
+KeyframeStore::KeyframeStore()
+    : d(new Data)
+{
+}
+
+KeyframeStore::const_iterator KeyframeStore::begin() const
+{
+    return d->keyframes.cbegin();
+}
+
+KeyframeStore::const_iterator KeyframeStore::end() const
+{
+    return d->keyframes.cend();
+}
+
+KeyframeStore::const_iterator KeyframeStore::cbegin() const
+{
+    return d->keyframes.cbegin();
+}
+
+KeyframeStore::const_iterator KeyframeStore::cend() const
+{
+    return d->keyframes.cend();
+}
+
+size_t KeyframeStore::size() const
+{
+    return d->keyframes.size();
+}
+
+size_t KeyframeStore::count(const GenTime &pos) const
+{
+    return find(pos) == end() ? 0 : 1;
+}
+
+KeyframeStore::const_iterator KeyframeStore::find(const GenTime &pos) const
+{
+    auto it = lower_bound(pos);
+    if (it != end() && !(pos < it->first)) {
+        return it;
+    }
+    return end();
+}
+
+KeyframeStore::const_iterator KeyframeStore::lower_bound(const GenTime &pos) const
+{
+    return std::lower_bound(d->keyframes.cbegin(), d->keyframes.cend(), pos, keyframeBefore);
+}
+
+KeyframeStore::const_iterator KeyframeStore::upper_bound(const GenTime &pos) const
+{
+    return std::upper_bound(d->keyframes.cbegin(), d->keyframes.cend(), pos, keyframeAfter);
+}
+
+const std::pair<KeyframeType, QVariant> &KeyframeStore::at(const GenTime &pos) const
+{
+    auto it = find(pos);
+    Q_ASSERT(it != end());
+    return it->second;
+}
+
+void KeyframeStore::set(const GenTime &pos, KeyframeType type, const QVariant &value)
+{
+    // Detach before looking up the keyframe so that the iterator points to our own copy
+    d.detach();
+    auto it = lower_bound(pos);
+    auto row = std::distance(d->keyframes.cbegin(), it);
+    if (it != end() && !(pos < it->first)) {
+        d->keyframes[size_t(row)].second = {type, value};
+        d->serialized[size_t(row)] = QString();
+        return;
+    }
+    d->keyframes.insert(d->keyframes.begin() + row, {pos, {type, value}});
+    d->serialized.insert(d->serialized.begin() + row, QString());
+}
+
+void KeyframeStore::erase(const GenTime &pos)
+{
+    d.detach();
+    auto it = find(pos);
+    if (it == end()) {
+        return;
+    }
+    auto row = std::distance(d->keyframes.cbegin(), it);
+    d->keyframes.erase(d->keyframes.begin() + row);
+    d->serialized.erase(d->serialized.begin() + row);
+}
+
+void KeyframeStore::clear()
+{
+    d->keyframes.clear();
+    d->serialized.clear();
+}
+
+QString KeyframeStore::animationString(double fps, bool stringValues) const
+{
+    if (d->keyframes.empty()) {
+        return QString();
+    }
+    QMutexLocker lock(&d->serializeMutex);
+    if (!qFuzzyCompare(fps, d->serializedFps)) {
+        // Frame positions depend on the fps, all cached keyframes are outdated
+        std::fill(d->serialized.begin(), d->serialized.end(), QString());
+        d->serializedFps = fps;
+    }
+    int length = 0;
+    for (size_t i = 0; i < d->keyframes.size(); ++i) {
+        QString &key = d->serialized[i];
+        if (key.isNull()) {
+            const value_type &keyframe = d->keyframes[i];
+            key = QString::number(keyframe.first.frames(fps));
+            switch (keyframe.second.first) {
+            case KeyframeType::Discrete:
+                key.append(QLatin1Char('|'));
+                break;
+            case KeyframeType::Curve:
+                key.append(QLatin1Char('~'));
+                break;
+            default:
+                break;
+            }
+            key.append(QLatin1Char('='));
+            // Numbers are written like MLT does when serializing an animation
+            key.append(stringValues ? keyframe.second.second.toString() : QString::asprintf("%g", keyframe.second.second.toDouble()));
+        }
+        length += key.size() + 1;
+    }
+    QString result;
+    result.reserve(length);
+    for (const QString &key : d->serialized) {
+        if (!result.isEmpty()) {
+            result.append(QLatin1Char(';'));
+        }
+        result.append(key);
+    }
+    return result;
+}
+
+bool KeyframeStore::operator==(const KeyframeStore &other) const
+{
+    return d == other.d || d->keyframes == other.d->keyframes;
+}
+
+bool KeyframeStore::isSharedWith(const KeyframeStore &other) const
+{
+    return d == other.d;
+}
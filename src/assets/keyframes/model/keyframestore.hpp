@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "utils/gentime.h"
+
+#include <QMetaType>
+#include <QMutex>
+#include <QSharedData>
+#include <QString>
+#include <QVariant>
+#include <mlt++/MltProperties.h>
+#include <utility>
+#include <vector>
+
+enum class KeyframeType { Linear = mlt_keyframe_linear, Discrete = mlt_keyframe_discrete, Curve = mlt_keyframe_smooth };
+Q_DECLARE_METATYPE(KeyframeType)
+using Keyframe = std::pair<GenTime, KeyframeType>;
+
+/** @class KeyframeStore
+    @brief The keyframes of a parameter, sorted by position in a contiguous array.
+    It can be read like the std::map it replaces, but keyframes are only modified through set() and erase()
+    so that the MLT animation string of each keyframe can be cached: serializing the animation only formats
+    the keyframes modified since the previous serialization.
+    Copies are implicitly shared, the keyframes are only duplicated when one of the copies is modified.
+ */
+class KeyframeStore
+{
+public:
+    using value_type = std::pair<GenTime, std::pair<KeyframeType, QVariant>>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    KeyframeStore();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    size_t size() const;
+    /** @brief Returns 1 if there is a keyframe at @param pos, 0 otherwise */
+    size_t count(const GenTime &pos) const;
+    const_iterator find(const GenTime &pos) const;
+    const_iterator lower_bound(const GenTime &pos) const;
+    const_iterator upper_bound(const GenTime &pos) const;
+    /** @brief Returns the type and value of the keyframe at @param pos, which must exist */
+    const std::pair<KeyframeType, QVariant> &at(const GenTime &pos) const;
+
+    /** @brief Add a keyframe at @param pos, or replace the existing one */
+    void set(const GenTime &pos, KeyframeType type, const QVariant &value);
+    /** @brief Remove the keyframe at @param pos if it exists */
+    void erase(const GenTime &pos);
+    void clear();
+
+    /** @brief Returns the keyframes as an MLT animation string, for example "0=50;50|=100;100~=200"
+       @param fps is used to convert the keyframe positions to frames
+       @param stringValues if true, the values are written as strings (rects, colors), otherwise as numbers
+    */
+    QString animationString(double fps, bool stringValues) const;
+
+    /** @brief Returns true if both stores have the same keyframes */
+    bool operator==(const KeyframeStore &other) const;
+    /** @brief Returns true if this store shares its keyframes with @param other */
+    bool isSharedWith(const KeyframeStore &other) const;
+
+private:
+    struct Data : public QSharedData
+    {
+        Data() = default;
+        Data(const Data &other);
+        std::vector<value_type> keyframes;
+        /** @brief The animation string of each keyframe, null for the keyframes modified since the last serialization */
+        mutable std::vector<QString> serialized;
+        mutable double serializedFps{0.};
+        /** @brief Protects the cache, which can be filled by the models sharing these keyframes from different threads */
+        mutable QMutex serializeMutex;
+    };
+    QSharedDataPointer<Data> d;
+};
@@ -16,8 +16,17 @@
 
 #include <KColorScheme>
 #include <QFontDatabase>
+#include <algorithm>
 #include <utility>
 
+namespace {
+/** @brief Returns the first keyframe at or after @param pos. Keyframes are sorted so this is a binary search */
+auto firstKeyframeFrom(KeyframeModelList &model, const GenTime &pos) -> decltype(model.begin())
+{
+    return std::lower_bound(model.begin(), model.end(), pos, [](const KeyframeStore::value_type &keyframe, const GenTime &p) { return keyframe.first < p; });
+}
+} // namespace
+
 KeyframeView::KeyframeView(std::shared_ptr<KeyframeModelList> model, int duration, QWidget *parent)
     : QWidget(parent)
     , m_model(std::move(model))
@@ -508,14 +517,13 @@ void KeyframeView::mouseMoveEvent(QMouseEvent *event)
             m_model->setActiveKeyframe(-1);
             m_currentKeyframeOriginal = -1;
             double fps = pCore->getCurrentFps();
-            int kfrIx = 0;
-            for (const auto &keyframe : *m_model.get()) {
-                int kfPos = keyframe.first.frames(fps) - offset;
-                if (kfPos > min && kfPos <= max) {
-                    m_model->appendSelectedKeyframe(kfrIx);
-                }
-                kfrIx++;
+            const auto first = firstKeyframeFrom(*m_model.get(), GenTime(min + 1 + offset, fps));
+            const auto last = firstKeyframeFrom(*m_model.get(), GenTime(max + 1 + offset, fps));
+            QVector<int> selection;
+            for (int kfrIx = int(std::distance(m_model->begin(), first)); kfrIx < int(std::distance(m_model->begin(), last)); kfrIx++) {
+                selection << kfrIx;
             }
+            m_model->setSelectedKeyframes(selection);
             if (!m_model->selectedKeyframes().isEmpty()) {
                 m_model->setActiveKeyframe(m_model->selectedKeyframes().first());
                 m_currentKeyframeOriginal = m_model->getPosAtIndex(m_model->selectedKeyframes().first()).frames(pCore->getCurrentFps());
@@ -791,22 +799,35 @@ void KeyframeView::paintEvent(QPaintEvent *event)
 
     /*
      * keyframes
+     * Only the visible keyframes are painted, and keyframes that would overlap are merged in
+     * a single marker, so that the painting cost depends on the widget width, not on the keyframe count.
      */
-    int kfrIx = 0;
     QVector<int> selecteds = m_model->selectedKeyframes();
-    for (const auto &keyframe : *m_model.get()) {
-        int pos = keyframe.first.frames(fps) - offset;
-        if (pos < 0) continue;
+    std::sort(selecteds.begin(), selecteds.end());
+    const int activeKeyframe = m_model->activeKeyframe();
+    // Number of frames covered by a keyframe marker
+    const double frameWidth = m_scale * m_zoomFactor;
+    const int clusterFrames = frameWidth > 0. ? qMax(1, qCeil(headOffset / frameWidth)) : 1;
+    auto keyframe = firstKeyframeFrom(*m_model.get(), GenTime((m_scale > 0. ? qMax(0, qFloor(m_zoomStart / m_scale)) : 0) + offset, fps));
+    while (keyframe != m_model->end()) {
+        int pos = keyframe->first.frames(fps) - offset;
         double scaledPos = pos * m_scale;
-        if (scaledPos < m_zoomStart || qFloor(scaledPos) > zoomEnd) {
-            kfrIx++;
+        if (qFloor(scaledPos) > zoomEnd) {
+            break;
+        }
+        auto next = clusterFrames > 1 ? firstKeyframeFrom(*m_model.get(), GenTime(pos + clusterFrames + offset, fps)) : keyframe + 1;
+        if (scaledPos < m_zoomStart) {
+            keyframe = next;
             continue;
         }
-        if (kfrIx == m_model->activeKeyframe()) {
+        const int firstIx = int(std::distance(m_model->begin(), keyframe));
+        const int lastIx = int(std::distance(m_model->begin(), next)) - 1;
+        const int lastPos = (next - 1)->first.frames(fps) - offset;
+        if (activeKeyframe >= firstIx && activeKeyframe <= lastIx) {
             p.setBrush(Qt::red);
-        } else if (selecteds.contains(kfrIx)) {
+        } else if (std::lower_bound(selecteds.cbegin(), selecteds.cend(), firstIx) != std::upper_bound(selecteds.cbegin(), selecteds.cend(), lastIx)) {
             p.setBrush(Qt::darkRed);
-        } else if (pos == m_hoverKeyframe) {
+        } else if (m_hoverKeyframe >= pos && m_hoverKeyframe <= lastPos) {
             p.setBrush(m_colSelected);
         } else {
             p.setBrush(m_colKeyframe);
@@ -815,7 +836,14 @@ void KeyframeView::paintEvent(QPaintEvent *event)
         scaledPos *= m_zoomFactor;
         scaledPos += m_offset;
         p.drawLine(QPointF(scaledPos, headOffset), QPointF(scaledPos, m_lineHeight - 1));
-        switch (keyframe.second.first) {
+        if (lastIx > firstIx) {
+            // Several keyframes in this marker
+            double lastScaledPos = (lastPos * m_scale - m_zoomStart) * m_zoomFactor + m_offset;
+            p.drawRoundedRect(QRectF(scaledPos - headOffset / 2.0, 0, lastScaledPos - scaledPos + headOffset, headOffset), headOffset / 4.0, headOffset / 4.0);
+            keyframe = next;
+            continue;
+        }
+        switch (keyframe->second.first) {
         case KeyframeType::Linear: {
             QPolygonF position = QPolygonF() << QPointF(-headOffset / 2.0, headOffset / 2.0) << QPointF(0, 0) << QPointF(headOffset / 2.0, headOffset / 2.0)
                                              << QPointF(0, headOffset);
@@ -830,7 +858,7 @@ void KeyframeView::paintEvent(QPaintEvent *event)
             p.drawEllipse(QRectF(scaledPos - headOffset / 2.0, 0, headOffset, headOffset));
             break;
         }
-        kfrIx++;
+        keyframe = next;
     }
 
     p.setPen(palette().dark().color());
@@ -0,0 +1,168 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "assetdescriptor.hpp"
+
+#include <KLocalizedString>
+#include <QDebug>
+#include <QLocale>
+
+AssetDescriptor::AssetDescriptor(const QDomElement &assetXml)
+    : m_source(assetXml)
+{
+    // Work on a copy, the locale conversion modifies the definition
+    QDomElement xml = assetXml.cloneNode().toElement();
+    hideKeyframes = xml.hasAttribute(QStringLiteral("hideKeyframes"));
+    isAudio = xml.attribute(QStringLiteral("type")) == QLatin1String("audio");
+
+    bool needsLocaleConversion = false;
+    // Check locale, default effects xml has no LC_NUMERIC defined and always uses the C locale
+    if (xml.hasAttribute(QStringLiteral("LC_NUMERIC"))) {
+        QLocale effectLocale = QLocale(xml.attribute(QStringLiteral("LC_NUMERIC"))); // Check if effect has a special locale → probably OK
+        if (QLocale::c().decimalPoint() != effectLocale.decimalPoint()) {
+            needsLocaleConversion = true;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            m_separator = QString(QLocale::c().decimalPoint());
+            m_oldSeparator = QString(effectLocale.decimalPoint());
+#else
+            m_separator = QLocale::c().decimalPoint();
+            m_oldSeparator = effectLocale.decimalPoint();
+#endif
+        }
+    }
+
+    QDomNodeList parameterNodes = xml.elementsByTagName(QStringLiteral("parameter"));
+    parameters.reserve(size_t(parameterNodes.count()));
+    for (int i = 0; i < parameterNodes.count(); ++i) {
+        QDomElement currentParameter = parameterNodes.item(i).toElement();
+
+        // Convert parameters if we need to
+        // Is it still required? Does it work correctly for non-number values (e.g. lists which contain commas)?
+        if (needsLocaleConversion) {
+            QDomNamedNodeMap attrs = currentParameter.attributes();
+            for (int k = 0; k < attrs.count(); ++k) {
+                QString nodeName = attrs.item(k).nodeName();
+                if (nodeName != QLatin1String("type") && nodeName != QLatin1String("name")) {
+                    QString val = attrs.item(k).nodeValue();
+                    if (val.contains(m_oldSeparator)) {
+                        QString newVal = val.replace(m_oldSeparator, m_separator);
+                        attrs.item(k).setNodeValue(newVal);
+                    }
+                }
+            }
+        }
+        Parameter param;
+        param.name = currentParameter.attribute(QStringLiteral("name"));
+        param.type = paramTypeFromStr(currentParameter.attribute(QStringLiteral("type")));
+        param.fixed = currentParameter.attribute(QStringLiteral("type")) == QLatin1String("fixed");
+        param.value = currentParameter.attribute(QStringLiteral("value"));
+        param.xml = currentParameter;
+        if (!param.fixed) {
+            param.title = i18n(currentParameter.firstChildElement(QStringLiteral("name")).text().toUtf8().data());
+            if (param.title.isEmpty() || param.title == QStringLiteral("(I18N_EMPTY_MESSAGE)")) {
+                param.title = param.name;
+            }
+            // fixed parameters are not displayed
+            rows.push_back(param.name);
+        }
+        if (!param.name.isEmpty()) {
+            paramOrder.push_back(param.name);
+        }
+        parameters.push_back(param);
+    }
+}
+
+bool AssetDescriptor::isBuiltFrom(const QDomElement &assetXml) const
+{
+    return m_source == assetXml;
+}
+
+bool AssetDescriptor::matches(const QDomNodeList &parameterNodes) const
+{
+    if (parameterNodes.count() != int(parameters.size())) {
+        return false;
+    }
+    for (int i = 0; i < parameterNodes.count(); ++i) {
+        const QDomElement currentParameter = parameterNodes.item(i).toElement();
+        if (currentParameter.attribute(QStringLiteral("name")) != parameters[size_t(i)].name ||
+            currentParameter.attribute(QStringLiteral("type")) != parameters[size_t(i)].xml.attribute(QStringLiteral("type"))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString AssetDescriptor::convertLocale(const QString &value) const
+{
+    if (m_oldSeparator.isEmpty() || !value.contains(m_oldSeparator)) {
+        return value;
+    }
+    QString converted = value;
+    return converted.replace(m_oldSeparator, m_separator);
+}
+
+// static
+ParamType AssetDescriptor::paramTypeFromStr(const QString &type)
+{
+    if (type == QLatin1String("double") || type == QLatin1String("float") || type == QLatin1String("constant")) {
+        return ParamType::Double;
+    }
+    if (type == QLatin1String("list")) {
+        return ParamType::List;
+    }
+    if (type == QLatin1String("listdependency")) {
+        return ParamType::ListWithDependency;
+    }
+    if (type == QLatin1String("urllist")) {
+        return ParamType::UrlList;
+    }
+    if (type == QLatin1String("bool")) {
+        return ParamType::Bool;
+    }
+    if (type == QLatin1String("switch")) {
+        return ParamType::Switch;
+    }
+    if (type == QLatin1String("multiswitch")) {
+        return ParamType::MultiSwitch;
+    } else if (type == QLatin1String("simplekeyframe")) {
+        return ParamType::KeyframeParam;
+    } else if (type == QLatin1String("animatedrect") || type == QLatin1String("rect")) {
+        return ParamType::AnimatedRect;
+    } else if (type == QLatin1String("geometry")) {
+        return ParamType::Geometry;
+    } else if (type == QLatin1String("keyframe") || type == QLatin1String("animated")) {
+        return ParamType::KeyframeParam;
+    } else if (type == QLatin1String("color")) {
+        return ParamType::Color;
+    } else if (type == QLatin1String("fixedcolor")) {
+        return ParamType::FixedColor;
+    } else if (type == QLatin1String("colorwheel")) {
+        return ParamType::ColorWheel;
+    } else if (type == QLatin1String("position")) {
+        return ParamType::Position;
+    } else if (type == QLatin1String("curve")) {
+        return ParamType::Curve;
+    } else if (type == QLatin1String("bezier_spline")) {
+        return ParamType::Bezier_spline;
+    } else if (type == QLatin1String("roto-spline")) {
+        return ParamType::Roto_spline;
+    } else if (type == QLatin1String("wipe")) {
+        return ParamType::Wipe;
+    } else if (type == QLatin1String("url")) {
+        return ParamType::Url;
+    } else if (type == QLatin1String("keywords")) {
+        return ParamType::Keywords;
+    } else if (type == QLatin1String("fontfamily")) {
+        return ParamType::Fontfamily;
+    } else if (type == QLatin1String("filterjob")) {
+        return ParamType::Filterjob;
+    } else if (type == QLatin1String("readonly")) {
+        return ParamType::Readonly;
+    } else if (type == QLatin1String("hidden")) {
+        return ParamType::Hidden;
+    }
+    qDebug() << "WARNING: Unknown type :" << type;
+    return ParamType::Double;
+}
@@ -0,0 +1,92 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QDomElement>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+enum class ParamType {
+    Double,
+    List,               // Value can be chosen from a list of pre-defined ones
+    ListWithDependency, // Value can be chosen from a list of pre-defined ones. Some values might not be available due to missing dependencies
+    UrlList,            // File can be chosen from a list of pre-defined ones or a custom file can be used (like url)
+    Bool,
+    Switch,
+    MultiSwitch,
+    AnimatedRect, // Animated rects have X, Y, width, height, and opacity (in [0,1])
+    Geometry,
+    KeyframeParam,
+    Color,
+    FixedColor, // Non animated color
+    ColorWheel,
+    Position,
+    Curve,
+    Bezier_spline,
+    Roto_spline,
+    Wipe,
+    Url,
+    Keywords,
+    Fontfamily,
+    Filterjob,
+    Readonly,
+    Hidden
+};
+Q_DECLARE_METATYPE(ParamType)
+
+/** @class AssetDescriptor
+    @brief The parsed definition of the parameters of an asset (names, types, ranges, defaults).
+    It is built once per asset by the assets repositories and shared read-only by all the
+    AssetParameterModel instances of this asset, which only store the parameter values.
+ */
+class AssetDescriptor
+{
+public:
+    struct Parameter
+    {
+        QString name;
+        ParamType type;
+        /** @brief Fixed parameters are neither displayed nor editable */
+        bool fixed;
+        /** @brief The translated name displayed to the user */
+        QString title;
+        /** @brief The value set in the definition, empty if the default should be used */
+        QString value;
+        /** @brief The parameter definition, with numbers already converted to the C locale */
+        QDomElement xml;
+    };
+
+    /** @brief Parse the asset definition @param assetXml */
+    explicit AssetDescriptor(const QDomElement &assetXml);
+
+    /** @brief Returns true if this descriptor was parsed from @param assetXml */
+    bool isBuiltFrom(const QDomElement &assetXml) const;
+    /** @brief Returns true if @param parameterNodes, the parameter elements of an asset definition, are the ones of this descriptor */
+    bool matches(const QDomNodeList &parameterNodes) const;
+    /** @brief Converts a number written with the decimal separator of the definition to the C locale */
+    QString convertLocale(const QString &value) const;
+
+    /** @brief Helper function to retrieve the type of a parameter given the string corresponding to it*/
+    static ParamType paramTypeFromStr(const QString &type);
+
+    /** @brief All parameters, in definition order */
+    std::vector<Parameter> parameters;
+    /** @brief The names of the displayed parameters, in definition order */
+    QVector<QString> rows;
+    /** @brief The names of all the named parameters. The order is important (cf some effects like sox) */
+    QVector<QString> paramOrder;
+    /** @brief if true, keyframe tools will be hidden by default */
+    bool hideKeyframes;
+    /** @brief true if this is an audio asset */
+    bool isAudio;
+
+private:
+    QDomElement m_source;
+    QString m_separator;
+    QString m_oldSeparator;
+};
@@ -10,6 +10,7 @@
 #include "kdenlivesettings.h"
 #include "klocalizedstring.h"
 #include "profiles/profilemodel.hpp"
+#include "transitions/transitionsrepository.hpp"
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -17,101 +18,77 @@
 #include <QJsonObject>
 #include <QRegularExpression>
 #include <QString>
-#define DEBUG_LOCALE false
+
+// Returns the shared definition of the asset, or a private one if @param assetXml does not match the repository's definition
+static std::shared_ptr<const AssetDescriptor> descriptorFor(const QDomElement &assetXml, const QString &assetId, const ObjectId &ownerId)
+{
+    std::shared_ptr<const AssetDescriptor> descriptor;
+    if (ownerId.first == ObjectType::TimelineComposition || ownerId.first == ObjectType::TimelineMix) {
+        descriptor = TransitionsRepository::get()->getDescriptor(assetId);
+    } else {
+        descriptor = EffectsRepository::get()->getDescriptor(assetId);
+    }
+    if (descriptor == nullptr || !descriptor->matches(assetXml.elementsByTagName(QStringLiteral("parameter")))) {
+        descriptor = std::make_shared<const AssetDescriptor>(assetXml);
+    }
+    return descriptor;
+}
+
+// Returns the values set in the parameters of @param assetXml
+static QStringList parameterValues(const QDomElement &assetXml)
+{
+    QStringList values;
+    QDomNodeList parameterNodes = assetXml.elementsByTagName(QStringLiteral("parameter"));
+    values.reserve(parameterNodes.count());
+    for (int i = 0; i < parameterNodes.count(); ++i) {
+        values << parameterNodes.item(i).toElement().attribute(QStringLiteral("value"));
+    }
+    return values;
+}
 
 AssetParameterModel::AssetParameterModel(std::unique_ptr<Mlt::Properties> asset, const QDomElement &assetXml, const QString &assetId, ObjectId ownerId,
                                          const QString &originalDecimalPoint, QObject *parent)
+    : AssetParameterModel(std::move(asset), descriptorFor(assetXml, assetId, ownerId), parameterValues(assetXml), assetId, ownerId, originalDecimalPoint, parent)
+{
+}
+
+AssetParameterModel::AssetParameterModel(std::unique_ptr<Mlt::Properties> asset, std::shared_ptr<const AssetDescriptor> descriptor, const QStringList &values,
+                                         const QString &assetId, ObjectId ownerId, const QString &originalDecimalPoint, QObject *parent)
     : QAbstractListModel(parent)
     , monitorId(ownerId.first == ObjectType::BinClip ? Kdenlive::ClipMonitor : Kdenlive::ProjectMonitor)
     , m_assetId(assetId)
     , m_ownerId(ownerId)
     , m_active(false)
+    , m_descriptor(std::move(descriptor))
+    , m_paramOrder(m_descriptor->paramOrder)
+    , m_rows(m_descriptor->rows)
     , m_asset(std::move(asset))
     , m_keyframes(nullptr)
     , m_activeKeyframe(-1)
+    , m_hideKeyframesByDefault(m_descriptor->hideKeyframes)
+    , m_isAudio(m_descriptor->isAudio)
     , m_filterProgress(0)
 {
     Q_ASSERT(m_asset->is_valid());
-    QDomNodeList parameterNodes = assetXml.elementsByTagName(QStringLiteral("parameter"));
-    m_hideKeyframesByDefault = assetXml.hasAttribute(QStringLiteral("hideKeyframes"));
-    m_isAudio = assetXml.attribute(QStringLiteral("type")) == QLatin1String("audio");
-
-    bool needsLocaleConversion = false;
-    QString separator;
-    QString oldSeparator;
-    // Check locale, default effects xml has no LC_NUMERIC defined and always uses the C locale
-    if (assetXml.hasAttribute(QStringLiteral("LC_NUMERIC"))) {
-        QLocale effectLocale = QLocale(assetXml.attribute(QStringLiteral("LC_NUMERIC"))); // Check if effect has a special locale → probably OK
-        if (QLocale::c().decimalPoint() != effectLocale.decimalPoint()) {
-            needsLocaleConversion = true;
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            separator = QString(QLocale::c().decimalPoint());
-            oldSeparator = QString(effectLocale.decimalPoint());
-#else
-            separator = QLocale::c().decimalPoint();
-            oldSeparator = effectLocale.decimalPoint();
-#endif
-        }
-    }
-
-#if false
-    // Debut test  stuff. Warning, assets can also come from TransitionsRepository depending on owner type
-    if (EffectsRepository::get()->exists(assetId)) {
-        qDebug() << "Asset " << assetId << " found in the repository. Description: " << EffectsRepository::get()->getDescription(assetId);
-        QString str;
-        QTextStream stream(&str);
-        EffectsRepository::get()->getXml(assetId).save(stream, 4);
-        qDebug() << "Asset XML: " << str;
-    } else {
-        qDebug() << "Asset not found in repo: " << assetId;
-    }
-#endif
-
-    qDebug() << "XML parsing of " << assetId << ". found" << parameterNodes.count() << "parameters";
-
-    if (DEBUG_LOCALE) {
-        QString str;
-        QTextStream stream(&str);
-        assetXml.save(stream, 1);
-        qDebug() << "XML to parse: " << str;
-    }
     bool fixDecimalPoint = !originalDecimalPoint.isEmpty();
     if (fixDecimalPoint) {
         qDebug() << "Original decimal point was different:" << originalDecimalPoint << "Values will be converted if required.";
     }
-    for (int i = 0; i < parameterNodes.count(); ++i) {
-        QDomElement currentParameter = parameterNodes.item(i).toElement();
-
-        // Convert parameters if we need to
-        // Note: This is not directly related to the originalDecimalPoint parameter.
-        // Is it still required? Does it work correctly for non-number values (e.g. lists which contain commas)?
-        if (needsLocaleConversion) {
-            QDomNamedNodeMap attrs = currentParameter.attributes();
-            for (int k = 0; k < attrs.count(); ++k) {
-                QString nodeName = attrs.item(k).nodeName();
-                if (nodeName != QLatin1String("type") && nodeName != QLatin1String("name")) {
-                    QString val = attrs.item(k).nodeValue();
-                    if (val.contains(oldSeparator)) {
-                        QString newVal = val.replace(oldSeparator, separator);
-                        attrs.item(k).setNodeValue(newVal);
-                    }
-                }
-            }
-        }
-        // Parse the basic attributes of the parameter
-        QString name = currentParameter.attribute(QStringLiteral("name"));
-        QString type = currentParameter.attribute(QStringLiteral("type"));
-        QString value = currentParameter.attribute(QStringLiteral("value"));
+    m_params.reserve(m_descriptor->parameters.size());
+    int ix = 0;
+    for (const AssetDescriptor::Parameter &param : m_descriptor->parameters) {
+        const QString &name = param.name;
+        // Only values coming from the project need a conversion, the definition was converted when parsed
+        QString value = ix < values.size() && !values.at(ix).isNull() ? m_descriptor->convertLocale(values.at(ix)) : param.value;
+        ix++;
         ParamRow currentRow;
-        currentRow.type = paramTypeFromStr(type);
-        currentRow.xml = currentParameter;
+        currentRow.info = &param;
+        currentRow.type = param.type;
         if (value.isEmpty()) {
-            QVariant defaultValue = parseAttribute(m_ownerId, QStringLiteral("default"), currentParameter);
+            QVariant defaultValue = parseAttribute(m_ownerId, QStringLiteral("default"), param.xml);
             value = defaultValue.toString();
-            qDebug() << "QLocale: Default value is" << defaultValue << "parsed:" << value;
         }
-        bool isFixed = (type == QLatin1String("fixed"));
-        if (isFixed) {
+        if (param.fixed) {
             m_fixedParams[name] = value;
         } else if (currentRow.type == ParamType::Position) {
             int val = value.toInt();
@@ -189,37 +166,22 @@ AssetParameterModel::AssetParameterModel(std::unique_ptr<Mlt::Properties> asset,
             }
         }
 
-        if (!isFixed) {
+        if (!param.fixed) {
             currentRow.value = value;
-            QString title = i18n(currentParameter.firstChildElement(QStringLiteral("name")).text().toUtf8().data());
-            if (title.isEmpty() || title == QStringLiteral("(I18N_EMPTY_MESSAGE)")) {
-                title = name;
-            }
-            currentRow.name = title;
             m_params[name] = currentRow;
         }
         if (!name.isEmpty()) {
             internalSetParameter(name, value);
-            // Keep track of param order
-            m_paramOrder.push_back(name);
-        }
-
-        if (isFixed) {
-            // fixed parameters are not displayed so we don't store them.
-            continue;
         }
-        m_rows.push_back(name);
     }
     if (m_assetId.startsWith(QStringLiteral("sox_"))) {
         // Sox effects need to have a special "Effect" value set
         QStringList effectParam = {m_assetId.section(QLatin1Char('_'), 1)};
-        for (const QString &pName : m_paramOrder) {
+        for (const QString &pName : qAsConst(m_paramOrder)) {
             effectParam << m_asset->get(pName.toUtf8().constData());
         }
         m_asset->set("effect", effectParam.join(QLatin1Char(' ')).toUtf8().constData());
     }
-
-    qDebug() << "END parsing of " << assetId << ". Number of found parameters" << m_rows.size();
     Q_EMIT modelChanged();
 }
 
@@ -239,6 +201,14 @@ void AssetParameterModel::prepareKeyframes()
     }
 }
 
+void AssetParameterModel::moveModelToThread(QThread *thread)
+{
+    moveToThread(thread);
+    if (m_keyframes) {
+        m_keyframes->moveModelsToThread(thread);
+    }
+}
+
 QStringList AssetParameterModel::getKeyframableParameters() const
 {
     QStringList paramNames;
@@ -272,7 +242,7 @@ void AssetParameterModel::setParameter(const QString &name, int value, bool upda
         // Warning, SOX effect, need unplug/replug
         qDebug() << "// Warning, SOX effect, need unplug/replug";
         QStringList effectParam = {m_assetId.section(QLatin1Char('_'), 1)};
-        for (const QString &pName : m_paramOrder) {
+        for (const QString &pName : qAsConst(m_paramOrder)) {
             effectParam << m_asset->get(pName.toUtf8().constData());
         }
         m_asset->set("effect", effectParam.join(QLatin1Char(' ')).toUtf8().constData());
@@ -390,7 +360,7 @@ void AssetParameterModel::setParameter(const QString &name, const QString &param
     if (m_assetId.startsWith(QStringLiteral("sox_"))) {
         // Warning, SOX effect, need unplug/replug
         QStringList effectParam = {m_assetId.section(QLatin1Char('_'), 1)};
-        for (const QString &pName : m_paramOrder) {
+        for (const QString &pName : qAsConst(m_paramOrder)) {
             effectParam << m_asset->get(pName.toUtf8().constData());
         }
         m_asset->set("effect", effectParam.join(QLatin1Char(' ')).toUtf8().constData());
@@ -468,11 +438,13 @@ QVariant AssetParameterModel::data(const QModelIndex &index, int role) const
     }
     QString paramName = m_rows[index.row()];
     Q_ASSERT(m_params.count(paramName) > 0);
-    const QDomElement &element = m_params.at(paramName).xml;
+    const AssetDescriptor::Parameter *info = m_params.at(paramName).info;
+    Q_ASSERT(info != nullptr);
+    const QDomElement &element = info->xml;
     switch (role) {
     case Qt::DisplayRole:
     case Qt::EditRole:
-        return m_params.at(paramName).name;
+        return info->title;
     case NameRole:
         return paramName;
     case TypeRole:
@@ -518,7 +490,7 @@ QVariant AssetParameterModel::data(const QModelIndex &index, int role) const
         if (child.toElement().hasAttribute(QStringLiteral("conditional"))) {
             return child.toElement().attribute(QStringLiteral("conditional"));
         }
-        return m_params.at(paramName).name;
+        return info->title;
     }
     case SuffixRole:
         return element.attribute(QStringLiteral("suffix"));
@@ -634,70 +606,6 @@ int AssetParameterModel::rowCount(const QModelIndex &parent) const
     return m_rows.size();
 }
 
-// static
-ParamType AssetParameterModel::paramTypeFromStr(const QString &type)
-{
-    if (type == QLatin1String("double") || type == QLatin1String("float") || type == QLatin1String("constant")) {
-        return ParamType::Double;
-    }
-    if (type == QLatin1String("list")) {
-        return ParamType::List;
-    }
-    if (type == QLatin1String("listdependency")) {
-        return ParamType::ListWithDependency;
-    }
-    if (type == QLatin1String("urllist")) {
-        return ParamType::UrlList;
-    }
-    if (type == QLatin1String("bool")) {
-        return ParamType::Bool;
-    }
-    if (type == QLatin1String("switch")) {
-        return ParamType::Switch;
-    }
-    if (type == QLatin1String("multiswitch")) {
-        return ParamType::MultiSwitch;
-    } else if (type == QLatin1String("simplekeyframe")) {
-        return ParamType::KeyframeParam;
-    } else if (type == QLatin1String("animatedrect") || type == QLatin1String("rect")) {
-        return ParamType::AnimatedRect;
-    } else if (type == QLatin1String("geometry")) {
-        return ParamType::Geometry;
-    } else if (type == QLatin1String("keyframe") || type == QLatin1String("animated")) {
-        return ParamType::KeyframeParam;
-    } else if (type == QLatin1String("color")) {
-        return ParamType::Color;
-    } else if (type == QLatin1String("fixedcolor")) {
-        return ParamType::FixedColor;
-    } else if (type == QLatin1String("colorwheel")) {
-        return ParamType::ColorWheel;
-    } else if (type == QLatin1String("position")) {
-        return ParamType::Position;
-    } else if (type == QLatin1String("curve")) {
-        return ParamType::Curve;
-    } else if (type == QLatin1String("bezier_spline")) {
-        return ParamType::Bezier_spline;
-    } else if (type == QLatin1String("roto-spline")) {
-        return ParamType::Roto_spline;
-    } else if (type == QLatin1String("wipe")) {
-        return ParamType::Wipe;
-    } else if (type == QLatin1String("url")) {
-        return ParamType::Url;
-    } else if (type == QLatin1String("keywords")) {
-        return ParamType::Keywords;
-    } else if (type == QLatin1String("fontfamily")) {
-        return ParamType::Fontfamily;
-    } else if (type == QLatin1String("filterjob")) {
-        return ParamType::Filterjob;
-    } else if (type == QLatin1String("readonly")) {
-        return ParamType::Readonly;
-    } else if (type == QLatin1String("hidden")) {
-        return ParamType::Hidden;
-    }
-    qDebug() << "WARNING: Unknown type :" << type;
-    return ParamType::Double;
-}
-
 // static
 bool AssetParameterModel::isAnimated(ParamType type)
 {
@@ -733,7 +641,7 @@ QVariant AssetParameterModel::parseAttribute(const ObjectId &owner, const QStrin
     if (!element.hasAttribute(attribute) && !defaultValue.isNull()) {
         return defaultValue;
     }
-    ParamType type = paramTypeFromStr(element.attribute(QStringLiteral("type")));
+    ParamType type = AssetDescriptor::paramTypeFromStr(element.attribute(QStringLiteral("type")));
     QString content = element.attribute(attribute);
     if (type == ParamType::UrlList && attribute == QLatin1String("default")) {
         QString values = element.attribute(QStringLiteral("paramlist"));
@@ -979,7 +887,7 @@ QJsonDocument AssetParameterModel::toJson(QVector<int> selection, bool includeFi
         }
 
         currentParam.insert(QLatin1String("name"), QJsonValue(param.first));
-        currentParam.insert(QLatin1String("DisplayName"), QJsonValue(param.second.name));
+        currentParam.insert(QLatin1String("DisplayName"), QJsonValue(param.second.info ? param.second.info->title : QString()));
         if (
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
             param.second.value.type() == QVariant::Double
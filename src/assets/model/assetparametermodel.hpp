@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "assetdescriptor.hpp"
 #include "definitions.h"
 #include "klocalizedstring.h"
 #include <QAbstractListModel>
@@ -19,34 +20,6 @@ class KeyframeModelList;
 
 typedef QVector<QPair<QString, QVariant>> paramVector;
 
-enum class ParamType {
-    Double,
-    List,               // Value can be chosen from a list of pre-defined ones
-    ListWithDependency, // Value can be chosen from a list of pre-defined ones. Some values might not be available due to missing dependencies
-    UrlList,            // File can be chosen from a list of pre-defined ones or a custom file can be used (like url)
-    Bool,
-    Switch,
-    MultiSwitch,
-    AnimatedRect, // Animated rects have X, Y, width, height, and opacity (in [0,1])
-    Geometry,
-    KeyframeParam,
-    Color,
-    FixedColor, // Non animated color
-    ColorWheel,
-    Position,
-    Curve,
-    Bezier_spline,
-    Roto_spline,
-    Wipe,
-    Url,
-    Keywords,
-    Fontfamily,
-    Filterjob,
-    Readonly,
-    Hidden
-};
-Q_DECLARE_METATYPE(ParamType)
-
 /** @class AssetParameterModel
     @brief This class is the model for a list of parameters.
    The behaviour of a transition or an effect is typically  controlled by several parameters. This class exposes this parameters as a list that can be rendered
@@ -73,6 +46,13 @@ public:
      */
     explicit AssetParameterModel(std::unique_ptr<Mlt::Properties> asset, const QDomElement &assetXml, const QString &assetId, ObjectId ownerId,
                                  const QString &originalDecimalPoint = QString(), QObject *parent = nullptr);
+    /**
+     * @brief Builds the model from the shared definition of the asset, without parsing any XML
+     * @param descriptor the asset definition, as returned by the effects or transitions repository
+     * @param values the value of each parameter of the descriptor, a missing or null value keeps the one from the definition
+     */
+    explicit AssetParameterModel(std::unique_ptr<Mlt::Properties> asset, std::shared_ptr<const AssetDescriptor> descriptor, const QStringList &values,
+                                 const QString &assetId, ObjectId ownerId, const QString &originalDecimalPoint = QString(), QObject *parent = nullptr);
     ~AssetParameterModel() override;
     enum DataRoles {
         NameRole = Qt::UserRole + 1,
@@ -182,6 +162,8 @@ public:
 
     /** @brief Must be called before using the keyframes of this model */
     void prepareKeyframes();
+    /** @brief Change the thread affinity of this model and of its keyframes. Used to hand a model built on a worker thread to the GUI thread */
+    void moveModelToThread(QThread *thread);
     void resetAsset(std::unique_ptr<Mlt::Properties> asset);
     /** @brief Returns true if the effect has more than one keyframe */
     bool hasMoreThanOneKeyframe() const;
@@ -210,9 +192,6 @@ public Q_SLOTS:
     void setProgress(int progress);
 
 protected:
-    /** @brief Helper function to retrieve the type of a parameter given the string corresponding to it*/
-    static ParamType paramTypeFromStr(const QString &type);
-
     static QString getDefaultKeyframes(int start, const QString &defaultValue, bool linearOnly);
 
     /** @brief Helper function to get an attribute from a dom element, given its name.
@@ -230,17 +209,19 @@ protected:
 
     struct ParamRow
     {
-        ParamType type;
-        QDomElement xml;
+        /** @brief The shared definition of the parameter, nullptr for values that are not defined in the asset */
+        const AssetDescriptor::Parameter *info{nullptr};
+        ParamType type{ParamType::Double};
         QVariant value;
-        QString name;
     };
 
     QString m_assetId;
     ObjectId m_ownerId;
     bool m_active;
+    /** @brief The parameter definitions, shared by all instances of this asset */
+    std::shared_ptr<const AssetDescriptor> m_descriptor;
     /** @brief Keep track of parameter order, important for sox */
-    std::vector<QString> m_paramOrder;
+    QVector<QString> m_paramOrder;
     /** @brief Store all parameters by name */
     std::unordered_map<QString, ParamRow> m_params;
     /** @brief We store values of fixed parameters aside */
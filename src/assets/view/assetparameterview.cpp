@@ -8,6 +8,7 @@
 #include "assets/model/assetcommand.hpp"
 #include "assets/model/assetparametermodel.hpp"
 #include "assets/view/widgets/abstractparamwidget.hpp"
+#include "assets/view/parametercoalescer.hpp"
 #include "assets/view/widgets/keyframewidget.hpp"
 #include "core.h"
 #include "monitor/monitor.h"
@@ -32,6 +33,19 @@ AssetParameterView::AssetParameterView(QWidget *parent)
     setFont(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont));
     // Presets Combo
     m_presetMenu = new QMenu(this);
+    m_coalescer = new ParameterCoalescer(
+        [this](const QList<QModelIndex> &indexes, const QVariantList &values, bool storeUndo) {
+            if (indexes.count() == 1) {
+                applyChange(indexes.first(), values.first().toString(), storeUndo);
+                return;
+            }
+            QStringList stringValues;
+            for (const QVariant &value : values) {
+                stringValues << value.toString();
+            }
+            applyMultipleChanges(indexes, stringValues, storeUndo);
+        },
+        this);
 }
 
 void AssetParameterView::setModel(const std::shared_ptr<AssetParameterModel> &model, QSize frameSize, bool addSpacer)
@@ -167,6 +181,20 @@ void AssetParameterView::disableCurrentFilter(bool disable)
 }
 
 void AssetParameterView::commitChanges(const QModelIndex &index, const QString &value, bool storeUndo)
+{
+    m_coalescer->change(index, value, storeUndo);
+}
+
+void AssetParameterView::commitMultipleChanges(const QList<QModelIndex> &indexes, const QStringList &values, bool storeUndo)
+{
+    QVariantList variantValues;
+    for (const QString &value : values) {
+        variantValues << value;
+    }
+    m_coalescer->change(indexes, variantValues, storeUndo);
+}
+
+void AssetParameterView::applyChange(const QModelIndex &index, const QString &value, bool storeUndo)
 {
     // Warning: please note that some widgets (for example keyframes) do NOT send the valueChanged signal and do modifications on their own
     auto *command = new AssetCommand(m_model, index, value);
@@ -178,7 +206,7 @@ void AssetParameterView::commitChanges(const QModelIndex &index, const QString &
     }
 }
 
-void AssetParameterView::commitMultipleChanges(const QList<QModelIndex> &indexes, const QStringList &values, bool storeUndo)
+void AssetParameterView::applyMultipleChanges(const QList<QModelIndex> &indexes, const QStringList &values, bool storeUndo)
 {
     // Warning: please note that some widgets (for example keyframes) do NOT send the valueChanged signal and do modifications on their own
     auto *command = new AssetMultiCommand(m_model, indexes, values);
@@ -192,6 +220,8 @@ void AssetParameterView::commitMultipleChanges(const QList<QModelIndex> &indexes
 
 void AssetParameterView::unsetModel()
 {
+    // Applying a change refreshes this view, do it before locking
+    m_coalescer->flush();
     QMutexLocker lock(&m_lock);
     if (m_model) {
         // if a model is already there, we have to disconnect signals first
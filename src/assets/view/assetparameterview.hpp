@@ -18,6 +18,7 @@ class QActionGroup;
 class AbstractParamWidget;
 class AssetParameterModel;
 class KeyframeWidget;
+class ParameterCoalescer;
 
 /** @class AssetParameterView
     @brief This class is the view for a list of parameters.
@@ -78,9 +79,13 @@ protected:
 
 private:
     QVector<QPair<QString, QVariant>> getDefaultValues() const;
+    /** @brief Limits the parameter updates to one per frame while a widget is dragged */
+    ParameterCoalescer *m_coalescer;
+    void applyChange(const QModelIndex &index, const QString &value, bool storeUndo);
+    void applyMultipleChanges(const QList<QModelIndex> &indexes, const QStringList &values, bool storeUndo);
 
 private Q_SLOTS:
-    /** @brief Apply a change of parameter sent by the view
+    /** @brief Apply a change of parameter sent by the view. While the user drags a widget, changes are coalesced
        @param index is the index corresponding to the modified param
        @param value is the new value of the parameter
        @param storeUndo: if true, an undo object is created
@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "parametercoalescer.hpp"
+#include "core.h"
+
+#include <QGuiApplication>
+#include <utility>
+
+ParameterCoalescer::ParameterCoalescer(ApplyFunction apply, QObject *parent)
+    : QObject(parent)
+    , m_apply(std::move(apply))
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &ParameterCoalescer::slotTimeout);
+}
+
+void ParameterCoalescer::change(const QModelIndex &index, const QVariant &value, bool storeUndo)
+{
+    change(QList<QModelIndex>{index}, QVariantList{value}, storeUndo);
+}
+
+void ParameterCoalescer::change(const QList<QModelIndex> &indexes, const QVariantList &values, bool storeUndo)
+{
+    QList<QPersistentModelIndex> persistentIndexes;
+    for (const QModelIndex &ix : indexes) {
+        persistentIndexes << QPersistentModelIndex(ix);
+    }
+    if (m_pending && persistentIndexes != m_indexes) {
+        // Another parameter group is modified, keep the order of the changes
+        flush();
+    }
+    m_indexes = persistentIndexes;
+    m_values = values;
+    m_storeUndo = m_storeUndo || storeUndo;
+    m_pending = true;
+    if (QGuiApplication::mouseButtons() == Qt::NoButton) {
+        // Not dragging, or the drag just ended
+        m_timer.stop();
+        flush();
+        return;
+    }
+    if (!m_timer.isActive()) {
+        flush();
+        m_timer.start(qMax(1, qRound(1000. / pCore->getCurrentFps())));
+    }
+}
+
+void ParameterCoalescer::flush()
+{
+    if (!m_pending) {
+        return;
+    }
+    m_pending = false;
+    QList<QModelIndex> indexes;
+    for (const QPersistentModelIndex &ix : qAsConst(m_indexes)) {
+        if (!ix.isValid()) {
+            // The asset was removed
+            m_storeUndo = false;
+            return;
+        }
+        indexes << ix;
+    }
+    bool storeUndo = m_storeUndo;
+    m_storeUndo = false;
+    m_apply(indexes, m_values, storeUndo);
+}
+
+void ParameterCoalescer::slotTimeout()
+{
+    if (m_pending) {
+        flush();
+        // Keep the frame rate limit while changes are coming
+        m_timer.start();
+    }
+}
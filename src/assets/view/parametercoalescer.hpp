@@ -0,0 +1,47 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QPersistentModelIndex>
+#include <QTimer>
+#include <QVariantList>
+#include <functional>
+
+/** @class ParameterCoalescer
+    @brief Collapses the parameter changes sent by a widget while the user drags it, so that the
+    asset and the monitor are updated at most once per displayed frame instead of on each mouse move.
+    The first change is applied immediately and the last one is never lost. A change sent while no mouse
+    button is pressed, like the one sent on release, is applied immediately with its exact value.
+ */
+class ParameterCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief The function applying a change of @param indexes to @param values */
+    using ApplyFunction = std::function<void(const QList<QModelIndex> &indexes, const QVariantList &values, bool storeUndo)>;
+
+    explicit ParameterCoalescer(ApplyFunction apply, QObject *parent = nullptr);
+
+    /** @brief Queue a change of @param indexes to @param values. A pending change of the same parameters is replaced */
+    void change(const QList<QModelIndex> &indexes, const QVariantList &values, bool storeUndo);
+    void change(const QModelIndex &index, const QVariant &value, bool storeUndo);
+    /** @brief Apply the pending change now, for example before the asset is removed from the view */
+    void flush();
+
+private:
+    ApplyFunction m_apply;
+    QTimer m_timer;
+    QList<QPersistentModelIndex> m_indexes;
+    QVariantList m_values;
+    bool m_storeUndo{false};
+    bool m_pending{false};
+
+private Q_SLOTS:
+    void slotTimeout();
+};
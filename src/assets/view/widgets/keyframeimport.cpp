@@ -328,6 +328,20 @@ KeyframeImport::KeyframeImport(const QString &animData, std::shared_ptr<AssetPar
     connect(m_limitKeyframes, &QCheckBox::toggled, m_limitNumber, &QSpinBox::setEnabled);
     connect(m_limitKeyframes, &QAbstractButton::toggled, this, &KeyframeImport::updateDisplay);
     connect(m_limitNumber, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &KeyframeImport::updateDisplay);
+    l1 = new QHBoxLayout;
+    m_simplify = new QCheckBox(i18n("Simplify curve"), this);
+    m_simplify->setToolTip(i18n("Remove the keyframes that can be interpolated from their neighbours within the tolerance"));
+    m_simplifyTolerance = new QDoubleSpinBox(this);
+    m_simplifyTolerance->setRange(0.01, 10.);
+    m_simplifyTolerance->setSingleStep(0.1);
+    m_simplifyTolerance->setValue(0.5);
+    m_simplifyTolerance->setSuffix(i18n("%"));
+    m_simplifyTolerance->setEnabled(false);
+    l1->addWidget(m_simplify);
+    l1->addWidget(m_simplifyTolerance);
+    l1->addStretch(10);
+    lay->addLayout(l1);
+    connect(m_simplify, &QCheckBox::toggled, m_simplifyTolerance, &QDoubleSpinBox::setEnabled);
     connect(m_dataCombo, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &KeyframeImport::updateDataDisplay);
     QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
     connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
@@ -358,8 +372,16 @@ void KeyframeImport::updateDataDisplay()
     m_previewLabel->setVisible(!onlyOne);
     m_limitKeyframes->setVisible(!onlyOne);
     m_limitNumber->setVisible(!onlyOne);
+    m_simplify->setVisible(!onlyOne);
+    m_simplifyTolerance->setVisible(!onlyOne);
     m_inPoint->setVisible(!onlyOne);
     m_outPoint->setVisible(!onlyOne);
+    // Only numeric curves can be simplified, rotoscoping shapes are imported as is
+    bool numeric = type != ParamType::Roto_spline;
+    if (!numeric) {
+        m_simplify->setChecked(false);
+    }
+    m_simplify->setEnabled(numeric);
 
     m_maximas = KeyframeModel::getRanges(comboData, m_model);
     m_sourceCombo->clear();
@@ -870,41 +892,58 @@ void KeyframeImport::importSelectedData()
     // wether we are mapping to a fake rectangle
     bool fakeRect = m_targetCombo->currentData().isNull() && m_targetCombo->currentText() == i18n("Rectangle");
     bool useOpacity = m_dataCombo->currentData(OpacityRole).toBool();
+    KeyframeImport::ImportRoles convertMode = static_cast<KeyframeImport::ImportRoles>(m_sourceCombo->currentData().toInt());
+    const double fps = pCore->getCurrentFps();
+    const int offset = m_offsetPoint->getPosition() - m_inPoint->getPosition();
+    const double tolerance = m_simplify->isChecked() ? m_simplifyTolerance->value() / 100. : 0.;
+    // All the keyframes are added in one operation, values that are not set keep the current parameter value
+    std::vector<Keyframe> keyframes;
+    QMap<QPersistentModelIndex, QVector<QVariant>> values;
+    if (convertMode == ImportRoles::RotoData && m_targetCombo->currentText() == i18n("Rotoscoping shape")) {
+        QJsonObject json = QJsonDocument::fromJson(selectedData().toUtf8()).object();
+        QMap<int, QVariant> shapes;
+        for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+            int frame = it.key().toInt();
+            if (frame <= m_outPoint->getPosition()) {
+                shapes.insert(frame, QVariant(it.value()));
+            }
+        }
+        for (auto it = shapes.constBegin(); it != shapes.constEnd(); ++it) {
+            keyframes.push_back({GenTime(it.key() + offset, fps), KeyframeType::Linear});
+        }
+        values.insert(m_targetCombo->currentData().toModelIndex(), shapes.values().toVector());
+        kfrModel->addKeyframes(keyframes, values, tolerance, undo, redo);
+        pCore->pushUndo(undo, redo, i18n("Import keyframes from clipboard"));
+        return;
+    }
+    // The source frames of the imported keyframes
+    std::vector<int> frames;
+    mlt_keyframe_type type;
+    for (int i = 0; i < anim->key_count(); i++) {
+        int frame = 0;
+        int error = anim->key_get(i, frame, type);
+        if (frame > m_outPoint->getPosition()) {
+            break;
+        }
+        if (error) {
+            continue;
+        }
+        frames.push_back(frame);
+        keyframes.push_back({GenTime(frame + offset, fps), KeyframeType(type)});
+    }
     for (const auto &ix : qAsConst(m_indexes)) {
         // update keyframes in other indexes
         KeyframeModel *km = kfrModel->getKeyModel(ix);
-        qDebug() << "== " << ix << " = " << m_targetCombo->currentData().toModelIndex();
+        QVector<QVariant> &list = values[ix];
+        list.resize(int(frames.size()));
         if (ix == m_targetCombo->currentData().toModelIndex() || fakeRect) {
             // Import our keyframes
-            KeyframeImport::ImportRoles convertMode = static_cast<KeyframeImport::ImportRoles>(m_sourceCombo->currentData().toInt());
-            if (convertMode == ImportRoles::RotoData && m_targetCombo->currentText() == i18n("Rotoscoping shape")) {
-                QJsonObject json = QJsonDocument::fromJson(selectedData().toUtf8()).object();
-                for (int i = 0; i < json.count(); i++) {
-                    int frame = json.keys().at(i).toInt();
-                    if (frame > m_outPoint->getPosition()) {
-                        break;
-                    }
-                    km->addKeyframe(GenTime(frame - m_inPoint->getPosition() + m_offsetPoint->getPosition(), pCore->getCurrentFps()), KeyframeType::Linear,
-                                    json.value(json.keys().at(i)), true, undo, redo);
-                }
-                continue;
-            }
-            mlt_keyframe_type type;
             mlt_rect firstRect = animData->anim_get_rect("key", anim->key_get_frame(0));
-            for (int i = 0; i < anim->key_count(); i++) {
-                int frame = 0;
-                int error = anim->key_get(i, frame, type);
-                if (frame > m_outPoint->getPosition()) {
-                    break;
-                }
-                if (error) {
-                    continue;
-                }
+            for (int i = 0; i < int(frames.size()); i++) {
+                int frame = frames[size_t(i)];
                 QVariant current = km->getInterpolatedValue(frame);
                 if (convertMode == ImportRoles::SimpleValue) {
-                    double dval = animData->anim_get_double("key", frame);
-                    km->addKeyframe(GenTime(frame - m_inPoint->getPosition() + m_offsetPoint->getPosition(), pCore->getCurrentFps()), KeyframeType(type), dval,
-                                    true, undo, redo);
+                    list[i] = animData->anim_get_double("key", frame);
                     continue;
                 }
                 QStringList kfrData = current.toString().split(QLatin1Char(' '));
@@ -1089,27 +1128,15 @@ void KeyframeImport::importSelectedData()
                 } else {
                     current = kfrData.join(QLatin1Char(' '));
                 }
-                km->addKeyframe(GenTime(frame - m_inPoint->getPosition() + m_offsetPoint->getPosition(), pCore->getCurrentFps()), KeyframeType(type), current,
-                                true, undo, redo);
+                list[i] = current;
             }
         } else {
-            int frame = 0;
-            mlt_keyframe_type type;
-            for (int i = 0; i < anim->key_count(); i++) {
-                int error = anim->key_get(i, frame, type);
-                if (frame > m_outPoint->getPosition()) {
-                    break;
-                }
-                if (error) {
-                    continue;
-                }
-                // frame += (m_inPoint->getPosition() - m_offsetPoint->getPosition());
-                QVariant current = km->getInterpolatedValue(frame);
-                km->addKeyframe(GenTime(frame - m_inPoint->getPosition() + m_offsetPoint->getPosition(), pCore->getCurrentFps()), KeyframeType(type), current,
-                                true, undo, redo);
+            for (int i = 0; i < int(frames.size()); i++) {
+                list[i] = km->getInterpolatedValue(frames[size_t(i)]);
             }
         }
     }
+    kfrModel->addKeyframes(keyframes, values, tolerance, undo, redo);
     pCore->pushUndo(undo, redo, i18n("Import keyframes from clipboard"));
 }
 
@@ -45,6 +45,8 @@ private:
     QCheckBox *m_limitRange;
     QCheckBox *m_limitKeyframes;
     QSpinBox *m_limitNumber;
+    QCheckBox *m_simplify;
+    QDoubleSpinBox *m_simplifyTolerance;
     QComboBox *m_sourceCombo;
     QComboBox *m_targetCombo;
     QComboBox *m_alignSourceCombo;
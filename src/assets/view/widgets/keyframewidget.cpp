@@ -12,6 +12,7 @@
 #include "assets/keyframes/model/rotoscoping/rotohelper.hpp"
 #include "assets/keyframes/view/keyframeview.hpp"
 #include "assets/model/assetparametermodel.hpp"
+#include "assets/view/parametercoalescer.hpp"
 #include "assets/view/widgets/keyframeimport.h"
 #include "core.h"
 #include "effects/effectsrepository.hpp"
@@ -55,6 +56,26 @@ KeyframeWidget::KeyframeWidget(std::shared_ptr<AssetParameterModel> model, QMode
     , m_addedHeight(0)
 {
     setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+    m_coalescer = new ParameterCoalescer(
+        [this](const QList<QModelIndex> &indexes, const QVariantList &values, bool) {
+            if (indexes.count() == 1) {
+                m_keyframes->updateKeyframe(GenTime(getPosition(), pCore->getCurrentFps()), values.first(), indexes.first());
+                return;
+            }
+            auto *parentCommand = new QUndoCommand();
+            parentCommand->setText(i18n("Edit %1 keyframe", EffectsRepository::get()->getName(m_model->getAssetId())));
+            for (int i = 0; i < indexes.count(); i++) {
+                if (m_keyframes->getInterpolatedValue(getPosition(), indexes.at(i)) != values.at(i)) {
+                    m_keyframes->updateKeyframe(GenTime(getPosition(), pCore->getCurrentFps()), values.at(i), indexes.at(i), parentCommand);
+                }
+            }
+            if (parentCommand->childCount() > 0) {
+                pCore->pushUndo(parentCommand);
+            } else {
+                delete parentCommand;
+            }
+        },
+        this);
     m_lay = new QVBoxLayout(this);
     m_lay->setSpacing(0);
 
@@ -359,12 +380,15 @@ KeyframeWidget::KeyframeWidget(std::shared_ptr<AssetParameterModel> model, QMode
 
 KeyframeWidget::~KeyframeWidget()
 {
+    // Apply the last dragged value while the keyframes and position are still available
+    m_coalescer->flush();
     delete m_keyframeview;
     delete m_time;
 }
 
 void KeyframeWidget::disconnectEffectStack()
 {
+    m_coalescer->flush();
     Monitor *monitor = pCore->getMonitor(m_model->monitorId);
     disconnect(monitor, &Monitor::seekPosition, this, &KeyframeWidget::monitorSeek);
 }
@@ -563,18 +587,13 @@ void KeyframeWidget::addParameter(const QPersistentModelIndex &index)
         paramWidget = geomWidget;
     } else if (type == ParamType::ColorWheel) {
         auto colorWheelWidget = new LumaLiftGainParam(m_model, index, this);
-        connect(colorWheelWidget, &LumaLiftGainParam::valuesChanged, this, [this, index](const QList<QModelIndex> &indexes, const QStringList &list, bool) {
+        connect(colorWheelWidget, &LumaLiftGainParam::valuesChanged, this, [this](const QList<QModelIndex> &indexes, const QStringList &list, bool) {
             Q_EMIT activateEffect();
-            auto *parentCommand = new QUndoCommand();
-            parentCommand->setText(i18n("Edit %1 keyframe", EffectsRepository::get()->getName(m_model->getAssetId())));
-            for (int i = 0; i < indexes.count(); i++) {
-                if (m_keyframes->getInterpolatedValue(getPosition(), indexes.at(i)) != list.at(i)) {
-                    m_keyframes->updateKeyframe(GenTime(getPosition(), pCore->getCurrentFps()), QVariant(list.at(i)), indexes.at(i), parentCommand);
-                }
-            }
-            if (parentCommand->childCount() > 0) {
-                pCore->pushUndo(parentCommand);
+            QVariantList values;
+            for (const QString &value : list) {
+                values << value;
             }
+            m_coalescer->change(indexes, values, true);
         });
         connect(colorWheelWidget, &LumaLiftGainParam::updateHeight, this, [&](int h) {
             setFixedHeight(m_baseHeight + m_addedHeight + h);
@@ -637,7 +656,7 @@ void KeyframeWidget::addParameter(const QPersistentModelIndex &index)
                                              m_model->data(index, AssetParameterModel::OddRole).toBool(), this);
         connect(doubleWidget, &DoubleWidget::valueChanged, this, [this, index](double v) {
             Q_EMIT activateEffect();
-            m_keyframes->updateKeyframe(GenTime(getPosition(), pCore->getCurrentFps()), QVariant(v), index);
+            m_coalescer->change(index, QVariant(v), true);
         });
         doubleWidget->setDragObjectName(QString::number(index.row()));
         paramWidget = doubleWidget;
@@ -24,6 +24,7 @@ class TimecodeDisplay;
 class KSelectAction;
 class KeyframeMonitorHelper;
 class KDualAction;
+class ParameterCoalescer;
 
 class KeyframeWidget : public AbstractParamWidget
 {
@@ -79,6 +80,8 @@ private:
     QVBoxLayout *m_lay;
     QToolBar *m_toolbar;
     std::shared_ptr<KeyframeModelList> m_keyframes;
+    /** @brief Limits the keyframe updates to one per frame while a value is dragged */
+    ParameterCoalescer *m_coalescer;
     KeyframeView *m_keyframeview;
     KeyframeMonitorHelper *m_monitorHelper;
     KDualAction *m_addDeleteAction;
@@ -173,8 +173,9 @@ void ListDependencyParamWidget::slotRefresh()
             const QString name = values.at(j).section(QLatin1Char('/'), -1);
             m_list->addItem(pCore->nameForLumaFile(name), entry);
             if (!entry.isEmpty() && (entry.endsWith(QLatin1String(".png")) || entry.endsWith(QLatin1String(".pgm")))) {
-                if (MainWindow::m_lumacache.contains(entry)) {
-                    m_list->setItemIcon(j + 1, QPixmap::fromImage(MainWindow::m_lumacache.value(entry)));
+                const QImage thumb = MainWindow::lumaThumbnail(entry);
+                if (!thumb.isNull()) {
+                    m_list->setItemIcon(j + 1, QPixmap::fromImage(thumb));
                 }
             }
         }
@@ -191,14 +191,9 @@ void UrlListParamWidget::slotRefresh()
         int ix = m_list->findData(entry);
         // Create thumbnails
         if (!entry.isEmpty() && (entry.toLower().endsWith(QLatin1String(".png")) || entry.toLower().endsWith(QLatin1String(".pgm")))) {
-            if (MainWindow::m_lumacache.contains(entry)) {
-                m_list->setItemIcon(ix, QPixmap::fromImage(MainWindow::m_lumacache.value(entry)));
-            } else {
-                QImage pix(entry);
-                if (!pix.isNull()) {
-                    MainWindow::m_lumacache.insert(entry, pix.scaled(50, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-                    m_list->setItemIcon(ix, QPixmap::fromImage(MainWindow::m_lumacache.value(entry)));
-                }
+            const QImage thumb = MainWindow::lumaThumbnail(entry);
+            if (!thumb.isNull()) {
+                m_list->setItemIcon(ix, QPixmap::fromImage(thumb));
             }
         }
     }
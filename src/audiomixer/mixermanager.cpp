@@ -6,10 +6,13 @@
 #include "mixermanager.hpp"
 #include "capture/mediacapture.h"
 #include "core.h"
+#include "bin/projectitemmodel.h"
 #include "effects/effectsrepository.hpp"
 #include "kdenlivesettings.h"
+#include "lib/audio/loudnessMeter.h"
 #include "mainwindow.h"
 #include "mixerwidget.hpp"
+#include "timeline2/model/clipmodel.hpp"
 #include "timeline2/model/timelineitemmodel.hpp"
 
 #include "mlt++/MltService.h"
@@ -115,6 +118,38 @@ void MixerManager::monitorAudio(int tid, bool monitor)
     m_monitorTrack = tid;
 }
 
+double MixerManager::trackLoudness(int tid, QStringList &missing) const
+{
+    if (!m_model || !m_model->isTrack(tid)) {
+        return LoudnessMeter::silence;
+    }
+    // Duration weighted energy mean of the gated loudness of each clip's used range
+    double energy = 0.;
+    int duration = 0;
+    const std::unordered_set<int> items = m_model->getItemsInRange(tid, 0, -1, false);
+    for (int cid : items) {
+        if (!m_model->isClip(cid)) {
+            continue;
+        }
+        const QString binId = m_model->getClipBinId(cid);
+        const LoudnessMap map = pCore->projectItemModel()->getLoudnessByBinID(binId, m_model->getClipPtr(cid)->audioStream());
+        if (map.isEmpty()) {
+            if (!missing.contains(binId)) {
+                missing << binId;
+            }
+            continue;
+        }
+        int in = m_model->getClipIn(cid);
+        int playtime = m_model->getClipPlaytime(cid);
+        double loudness = map.rangeLoudness(in, in + playtime);
+        if (loudness > -70.) {
+            energy += LoudnessMeter::toEnergy(loudness) * playtime;
+            duration += playtime;
+        }
+    }
+    return duration > 0 ? LoudnessMeter::toLoudness(energy / duration) : LoudnessMeter::silence;
+}
+
 void MixerManager::registerTrack(int tid, std::shared_ptr<Mlt::Tractor> service, const QString &trackTag, const QString &trackName)
 {
     if (m_mixers.count(tid) > 0) {
@@ -51,6 +51,9 @@ public:
     void checkAudioLevelVersion();
     /** @brief Enable/disable audio monitoring on a track */
     void monitorAudio(int tid, bool monitor);
+    /** @brief Estimate the integrated loudness of track @p tid from the loudness analysis of its clips.
+        Clips that were not analysed are listed in @p missing */
+    double trackLoudness(int tid, QStringList &missing) const;
     /** @brief Track currently monitored that will be used for recording */
     int recordTrack() const;
     /** @brief Return true if we have MLT's audiolevel filter version 2 or above (fixes reading track audio level) */
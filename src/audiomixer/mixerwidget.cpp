@@ -6,10 +6,14 @@
 #include "mixerwidget.hpp"
 
 #include "audiolevelwidget.hpp"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
 #include "capture/mediacapture.h"
 #include "core.h"
 #include "iecscale.h"
+#include "jobs/loudnesstask.h"
 #include "kdenlivesettings.h"
+#include "lib/audio/loudnessMeter.h"
 #include "mixermanager.hpp"
 #include "mlt++/MltEvent.h"
 #include "mlt++/MltFilter.h"
@@ -314,6 +318,16 @@ void MixerWidget::buildUI(Mlt::Tractor *service, const QString &trackName)
             m_manager->collapseMixers();
         });
     }
+    QToolButton *normalize = nullptr;
+    if (m_tid > -1) {
+        normalize = new QToolButton(this);
+        normalize->setIcon(QIcon::fromTheme("audio-volume-high"));
+        normalize->setToolTip(i18n("Normalize loudness"));
+        normalize->setWhatsThis(xi18nc("@info:whatsthis", "Adjusts the track volume so that its clips reach the target integrated loudness, using the loudness analysis of the clips."));
+        normalize->setAutoRaise(true);
+        connect(normalize, &QToolButton::clicked, this, &MixerWidget::normalizeLoudness);
+        connect(pCore.get(), &Core::loudnessUpdated, this, &MixerWidget::loudnessUpdated);
+    }
     showEffects = new QToolButton(this);
     showEffects->setIcon(QIcon::fromTheme("autocorrection"));
     showEffects->setToolTip(i18n("Open Effect Stack"));
@@ -396,7 +410,16 @@ void MixerWidget::buildUI(Mlt::Tractor *service, const QString &trackName)
     hlay->addWidget(m_audioMeterWidget.get());
     hlay->addWidget(m_volumeSlider);
     lay->addLayout(hlay);
-    lay->addWidget(m_volumeSpin);
+    if (normalize) {
+        auto *spinlay = new QHBoxLayout;
+        spinlay->setSpacing(0);
+        spinlay->setContentsMargins(0, 0, 0, 0);
+        spinlay->addWidget(m_volumeSpin);
+        spinlay->addWidget(normalize);
+        lay->addLayout(spinlay);
+    } else {
+        lay->addWidget(m_volumeSpin);
+    }
     lay->setStretch(4, 10);
     setLayout(lay);
     if (service->get_int("hide") > 1) {
@@ -517,6 +540,54 @@ void MixerWidget::gotRecLevels(QVector<qreal> levels)
     }
 }
 
+void MixerWidget::normalizeLoudness()
+{
+    if (m_levelFilter == nullptr || m_recording || (m_monitor && m_monitor->isChecked())) {
+        return;
+    }
+    QStringList missing;
+    double loudness = m_manager->trackLoudness(m_tid, missing);
+    m_pendingLoudness.clear();
+    if (!missing.isEmpty()) {
+        // Analyse the clips first, the track is normalized when they are all finished
+        for (const QString &binId : qAsConst(missing)) {
+            auto binClip = pCore->projectItemModel()->getClipByBinID(binId);
+            if (binClip) {
+                m_pendingLoudness << binId;
+                LoudnessTask::start(ObjectId(ObjectType::BinClip, binId.toInt()), binClip.get());
+            }
+        }
+        pCore->displayMessage(i18np("Analysing the loudness of 1 clip, the track will be normalized when it is finished",
+                                    "Analysing the loudness of %1 clips, the track will be normalized when they are finished", missing.size()),
+                              InformationMessage);
+        return;
+    }
+    if (loudness <= -70.) {
+        pCore->displayMessage(i18n("No audio to normalize on this track"), InformationMessage);
+        return;
+    }
+    double dbValue = qBound(m_volumeSpin->minimum(), KdenliveSettings::loudnesstarget() - loudness, m_volumeSpin->maximum());
+    // Apply the exact gain, the slider only has a coarse resolution
+    QSignalBlocker bk(m_volumeSpin);
+    QSignalBlocker bk2(m_volumeSlider);
+    m_volumeSpin->setValue(dbValue);
+    m_volumeSlider->setValue(fromDB(dbValue));
+    m_levelFilter->set("level", dbValue);
+    m_levelFilter->set("disable", qFuzzyIsNull(dbValue) ? 1 : 0);
+    m_levels.clear();
+    Q_EMIT m_manager->purgeCache();
+    pCore->setDocumentModified();
+    pCore->displayMessage(i18n("Track loudness %1 LUFS, volume set to %2 dB", QString::number(loudness, 'f', 1), QString::number(dbValue, 'f', 1)),
+                          InformationMessage);
+}
+
+void MixerWidget::loudnessUpdated(const QString &binId)
+{
+    if (m_pendingLoudness.removeAll(binId) > 0 && m_pendingLoudness.isEmpty()) {
+        normalizeLoudness();
+    }
+}
+
 void MixerWidget::updateMonitorState()
 {
     QSignalBlocker bk(m_volumeSpin);
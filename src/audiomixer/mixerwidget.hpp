@@ -70,6 +70,10 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void gotRecLevels(QVector<qreal> levels);
+    /** @brief Set the track volume so that its clips reach the target integrated loudness */
+    void normalizeLoudness();
+    /** @brief Normalize the track once the analysis of all its clips is finished */
+    void loudnessUpdated(const QString &binId);
 
 protected:
     MixerManager *m_manager;
@@ -99,6 +103,8 @@ private:
     bool m_recording;
     const QString m_trackTag;
     int m_sliderHandleSize;
+    /** @brief The clips whose loudness analysis must finish before normalizing the track */
+    QStringList m_pendingLoudness;
     /** @Update track label to reflect state */
     void updateLabel();
 
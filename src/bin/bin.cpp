@@ -2106,7 +2106,9 @@ void Bin::setMonitor(Monitor *monitor)
         if (clip && clip->hasLimitedDuration()) {
             clip->refreshBounds();
         }
-        pCore->textEditWidget()->openClip(clip);
+        if (pCore->textEditWidget()) {
+            pCore->textEditWidget()->openClip(clip);
+        }
     });
 }
 
@@ -2133,7 +2135,9 @@ void Bin::cleanDocument()
     m_itemView = nullptr;
     isLoading = false;
     shouldCheckProfile = false;
-    pCore->textEditWidget()->openClip(nullptr);
+    if (pCore->textEditWidget()) {
+        pCore->textEditWidget()->openClip(nullptr);
+    }
 }
 
 const QString Bin::setDocument(KdenliveDoc *project, const QString &id)
@@ -20,6 +20,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "jobs/proxytask.h"
 #include "kdenlivesettings.h"
 #include "lib/audio/audioStreamInfo.h"
+#include "lib/audio/loudnessMeter.h"
 #include "macros.hpp"
 #include "mltcontroller/clippropertiescontroller.h"
 #include "model/markerlistmodel.hpp"
@@ -301,6 +302,12 @@ void ProjectClip::updateAudioThumbnail(bool cachedThumb)
     }
 }
 
+void ProjectClip::updateLoudness()
+{
+    updateTimelineClips({TimelineModel::ReloadAudioThumbRole});
+    Q_EMIT pCore->loudnessUpdated(m_binId);
+}
+
 bool ProjectClip::audioThumbCreated() const
 {
     return (m_audioThumbCreated);
@@ -649,10 +656,8 @@ bool ProjectClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gene
         // Generate video thumb
         ClipLoadTask::start({ObjectType::BinClip, m_binId.toInt()}, QDomElement(), true, -1, -1, this);
     }
-    if (KdenliveSettings::audiothumbnails() &&
-        (m_clipType == ClipType::AV || m_clipType == ClipType::Audio || (m_hasAudio && m_clipType != ClipType::Timeline))) {
-        AudioLevelsTask::start({ObjectType::BinClip, m_binId.toInt()}, this, false);
-    }
+    bool needsAudioThumb = KdenliveSettings::audiothumbnails() &&
+                           (m_clipType == ClipType::AV || m_clipType == ClipType::Audio || (m_hasAudio && m_clipType != ClipType::Timeline));
     if (pCore->bin()) {
         pCore->bin()->reloadMonitorIfActive(clipId());
     }
@@ -719,6 +724,19 @@ bool ProjectClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gene
         QMetaObject::invokeMethod(pCore->currentDoc(), "slotProxyCurrentItem", Q_ARG(bool, true), Q_ARG(QList<std::shared_ptr<ProjectClip>>, clipList),
                                   Q_ARG(bool, false));
     }
+    if (needsAudioThumb) {
+        if (generateProxy && KdenliveSettings::ingestpass() && (m_clipType == ClipType::AV || m_clipType == ClipType::Video)) {
+            // The proxy job extracts the audio levels while decoding the source, only start a
+            // separate task if no proxy job was started
+            QTimer::singleShot(0, this, [this]() {
+                if (!pCore->taskManager.hasPendingJob({ObjectType::BinClip, m_binId.toInt()}, AbstractTask::PROXYJOB)) {
+                    AudioLevelsTask::start({ObjectType::BinClip, m_binId.toInt()}, this, false);
+                }
+            });
+        } else {
+            AudioLevelsTask::start({ObjectType::BinClip, m_binId.toInt()}, this, false);
+        }
+    }
     return true;
 }
 
@@ -2021,6 +2039,7 @@ void ProjectClip::discardAudioThumb()
         return;
     }
     pCore->taskManager.discardJobs({ObjectType::BinClip, m_binId.toInt()}, AbstractTask::AUDIOTHUMBJOB);
+    pCore->taskManager.discardJobs({ObjectType::BinClip, m_binId.toInt()}, AbstractTask::LOUDNESSJOB);
     QString audioThumbPath;
     QList<int> streams = m_audioInfo->streams().keys();
     // Delete audio thumbnail data
@@ -2029,6 +2048,13 @@ void ProjectClip::discardAudioThumb()
         if (!audioThumbPath.isEmpty()) {
             QFile::remove(audioThumbPath);
         }
+        // Loudness analysis is outdated too
+        const QString loudnessPath = getLoudnessPath(st);
+        if (!loudnessPath.isEmpty()) {
+            QFile::remove(loudnessPath);
+        }
+        const QString loudnessKey = QString("_kdenlive:loudness%1").arg(st);
+        m_masterProducer->set(loudnessKey.toUtf8().constData(), nullptr, 0);
         // Clear audio cache
         QString key = QString("%1:%2").arg(m_binId).arg(st);
         pCore->audioThumbCache.insert(key, QByteArray("-"));
@@ -2080,6 +2106,15 @@ const QString ProjectClip::getAudioThumbPath(int stream)
     return audioPath;
 }
 
+const QString ProjectClip::getLoudnessPath(int stream)
+{
+    QString loudnessPath = getAudioThumbPath(stream);
+    if (!loudnessPath.isEmpty()) {
+        loudnessPath.replace(loudnessPath.length() - 10, 10, QStringLiteral("_loudness.dat"));
+    }
+    return loudnessPath;
+}
+
 QStringList ProjectClip::updatedAnalysisData(const QString &name, const QString &data, int offset)
 {
     if (data.isEmpty()) {
@@ -2579,6 +2614,22 @@ int ProjectClip::getAudioMax(int stream)
     return int(max);
 }
 
+const LoudnessMap ProjectClip::loudnessMap(int stream)
+{
+    if (stream == -1) {
+        if (!m_audioInfo) {
+            return LoudnessMap();
+        }
+        stream = m_audioInfo->audio_index();
+    }
+    const QString key = QString("_kdenlive:loudness%1").arg(stream);
+    m_masterProducer->lock();
+    auto *map = static_cast<LoudnessMap *>(m_masterProducer->get_data(key.toUtf8().constData()));
+    LoudnessMap result = map ? *map : LoudnessMap();
+    m_masterProducer->unlock();
+    return result;
+}
+
 const QVector<uint8_t> ProjectClip::audioFrameCache(int stream)
 {
     QVector<uint8_t> audioLevels;
@@ -21,6 +21,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <memory>
 
 class ClipPropertiesController;
+class LoudnessMap;
 class ProjectFolder;
 class ProjectSubClip;
 class QDomElement;
@@ -187,6 +188,8 @@ public:
     void discardAudioThumb();
     /** @brief Get path for this clip's audio thumbnail */
     const QString getAudioThumbPath(int stream);
+    /** @brief Get path for this clip's cached loudness analysis */
+    const QString getLoudnessPath(int stream);
     /** @brief Returns true if this producer has audio and can be splitted on timeline*/
     bool isSplittable() const;
 
@@ -228,6 +231,9 @@ public:
     /** @brief Return audio cache for a stream
      */
     const QVector <uint8_t> audioFrameCache(int stream = -1);
+    /** @brief Return the loudness analysis of a stream, empty if it was not computed
+     */
+    const LoudnessMap loudnessMap(int stream = -1);
     /** @brief Return FFmpeg's audio stream index for an MLT audio stream index
      */
     int getAudioStreamFfmpegIndex(int mltStream);
@@ -302,6 +308,8 @@ public Q_SLOTS:
     /** @brief Store the audio thumbnails once computed. Note that the parameter is a value and not a reference, fill free to use it as a sink (use std::move to
      * avoid copy). */
     void updateAudioThumbnail(bool cachedThumb);
+    /** @brief The loudness analysis is ready, refresh the timeline overlays */
+    void updateLoudness();
     /** @brief Delete the proxy file */
     void deleteProxy(bool reloadClip = true);
     /** @brief A clip job progressed, update display */
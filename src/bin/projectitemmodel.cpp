@@ -16,6 +16,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "jobs/audiolevelstask.h"
 #include "jobs/cliploadtask.h"
 #include "kdenlivesettings.h"
+#include "lib/audio/loudnessMeter.h"
 #include "lib/localeHandling.h"
 #include "macros.hpp"
 #include "profiles/profilemodel.hpp"
@@ -502,6 +503,16 @@ double ProjectItemModel::getAudioMaxLevel(const QString &binId, int stream)
     return 0;
 }
 
+const LoudnessMap ProjectItemModel::getLoudnessByBinID(const QString &binId, int stream)
+{
+    READ_LOCK();
+    std::shared_ptr<ProjectClip> clip = getClipByBinID(binId);
+    if (clip) {
+        return clip->loudnessMap(stream);
+    }
+    return LoudnessMap();
+}
+
 bool ProjectItemModel::hasClip(const QString &binId)
 {
     READ_LOCK();
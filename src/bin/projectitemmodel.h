@@ -22,6 +22,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 class BinPlaylist;
 class FileWatcher;
+class LoudnessMap;
 class MarkerListModel;
 class ProjectClip;
 class ProjectFolder;
@@ -59,6 +60,8 @@ public:
     /** @brief Returns audio levels for a clip from its id */
     const QVector <uint8_t>getAudioLevelsByBinID(const QString &binId, int stream);
     double getAudioMaxLevel(const QString &binId, int stream);
+    /** @brief Returns the loudness analysis of a bin clip's audio stream, empty if not computed */
+    const LoudnessMap getLoudnessByBinID(const QString &binId, int stream);
 
     /** @brief Returns a list of clips using the given url */
     QStringList getClipByUrl(const QFileInfo &url) const;
@@ -10,6 +10,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "audiomixer/mixermanager.hpp"
 #include "core.h"
 #include "kdenlivesettings.h"
+#include <KLocalizedString>
 #include <QAudioOutput>
 // TODO: fix video capture (Hint: QCameraInfo is not available in Qt6 anymore)
 //#include <QCameraInfo>
@@ -78,8 +79,16 @@ qint64 AudioDevInfo::readData(char *data, qint64 maxSize)
     return 0;
 }
 
+void AudioDevInfo::setRecorder(WavRecorder *recorder)
+{
+    m_recorder = recorder;
+}
+
 qint64 AudioDevInfo::writeData(const char *data, qint64 len)
 {
+    if (WavRecorder *recorder = m_recorder.load()) {
+        recorder->push(data, len);
+    }
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     if (maxAmplitude) {
         Q_ASSERT(m_format.sampleSize() % 8 == 0);
@@ -198,7 +207,14 @@ void MediaCapture::switchMonitorState(bool run)
         m_audioInput = std::make_unique<QAudioInput>(deviceInfo, format, this);
         QObject::connect(m_audioInfo.data(), &AudioDevInfo::levelChanged, m_audioInput.get(), [&](const QVector<qreal> &level) {
             m_levels = level;
-            if (m_recordState == QMediaRecorder::RecordingState) {
+            if (m_directRecording) {
+                // The frame levels are published by the recorder thread
+                int count = m_livePeaks.count();
+                if (count != m_lastPos) {
+                    m_lastPos = count;
+                    Q_EMIT recDurationChanged();
+                }
+            } else if (m_recordState == QMediaRecorder::RecordingState) {
                 // Get the frame number
                 int currentPos = qRound(m_recTimer.elapsed() / 1000. * pCore->getCurrentFps());
                 if (currentPos > m_lastPos) {
@@ -206,12 +222,12 @@ void MediaCapture::switchMonitorState(bool run)
                     switch (level.count()) {
                     case 2:
                         for (int i = 0; i < currentPos - m_lastPos; i++) {
-                            m_recLevels << qMax(level.first(), level.last());
+                            m_livePeaks.append(float(qMax(level.first(), level.last())));
                         }
                         break;
                     default:
                         for (int i = 0; i < currentPos - m_lastPos; i++) {
-                            m_recLevels << level.first();
+                            m_livePeaks.append(float(level.first()));
                         }
                         break;
                     }
@@ -243,9 +259,23 @@ int MediaCapture::recDuration() const
     return m_recOffset + m_lastPos;
 }
 
-const QVector<double> MediaCapture::recLevels() const
+const LivePeaks &MediaCapture::livePeaks() const
 {
-    return m_recLevels;
+    return m_livePeaks;
+}
+
+bool MediaCapture::takeRecordedLevels(const QString &path, QVector<uint8_t> &levels, int &channels, int &maxLevel)
+{
+    QMutexLocker lk(&m_levelsMutex);
+    if (m_recordedLevels.isEmpty() || path != m_recordedPath) {
+        return false;
+    }
+    levels.swap(m_recordedLevels);
+    channels = m_recordedChannels;
+    maxLevel = m_recordedMax;
+    m_recordedLevels.clear();
+    m_recordedPath.clear();
+    return true;
 }
 
 bool MediaCapture::isMonitoring() const
@@ -276,8 +306,97 @@ void MediaCapture::resetIfUnused()
 #endif
 }
 
+void MediaCapture::recordingStopped(bool finalize)
+{
+    m_resetTimer.start();
+    m_livePeaks.clear();
+    m_lastPos = -1;
+    m_recOffset = 0;
+    Q_EMIT audioLevels(QVector<qreal>());
+    if (finalize) {
+        Q_EMIT pCore->finalizeRecording(getCaptureOutputLocation().toLocalFile());
+    }
+    m_readyForRecord = false;
+}
+
+bool MediaCapture::recordAudioDirect(int tid, bool record)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QMutexLocker lk(&m_recMutex);
+    if (!record) {
+        if (!m_directRecording) {
+            return true;
+        }
+        if (m_audioInfo) {
+            m_audioInfo->setRecorder(nullptr);
+        }
+        bool written = true;
+        if (m_wavRecorder) {
+            written = m_wavRecorder->stop();
+            if (m_wavRecorder->droppedBytes() > 0) {
+                qWarning() << "Audio capture could not keep up, dropped" << m_wavRecorder->droppedBytes() << "bytes";
+            }
+            QMutexLocker levelsLock(&m_levelsMutex);
+            m_recordedPath = m_path.toLocalFile();
+            m_recordedLevels = m_wavRecorder->thumbnailLevels();
+            m_recordedChannels = m_wavRecorder->channels();
+            m_recordedMax = m_wavRecorder->maxLevel();
+            m_wavRecorder.reset();
+        }
+        if (!written) {
+            pCore->displayMessage(i18n("Cannot write audio capture to %1", m_path.toLocalFile()), ErrorMessage);
+        }
+        m_directRecording = false;
+        m_recordState = QMediaRecorder::StoppedState;
+        if (m_stopMonitorAfterRecord) {
+            m_stopMonitorAfterRecord = false;
+            switchMonitorState(false);
+        }
+        lk.unlock();
+        // m_readyForRecord is true if we were only displaying the countdown but real recording didn't start yet
+        recordingStopped(written && !m_readyForRecord);
+        Q_EMIT recordStateChanged(m_tid, false);
+        return true;
+    }
+    if (m_directRecording) {
+        // Recording was already prepared
+        return true;
+    }
+    setAudioCaptureDevice();
+    if (!m_audioInput) {
+        switchMonitorState(true);
+        m_stopMonitorAfterRecord = true;
+    }
+    const QAudioFormat format = m_audioInput ? m_audioInput->format() : QAudioFormat();
+    if (format.sampleSize() != 16 || format.sampleType() != QAudioFormat::SignedInt || format.byteOrder() != QAudioFormat::LittleEndian) {
+        if (m_stopMonitorAfterRecord) {
+            m_stopMonitorAfterRecord = false;
+            switchMonitorState(false);
+        }
+        return false;
+    }
+    m_tid = tid;
+    m_recTimer.invalidate();
+    m_resetTimer.stop();
+    m_readyForRecord = true;
+    m_directRecording = true;
+    setCaptureOutputLocation();
+    m_livePeaks.clear();
+    return true;
+#else
+    Q_UNUSED(tid)
+    Q_UNUSED(record)
+    return false;
+#endif
+}
+
 void MediaCapture::recordAudio(int tid, bool record)
 {
+    if (m_directRecording || (record && KdenliveSettings::audiocapturedirect() && !isRecording())) {
+        if (recordAudioDirect(tid, record)) {
+            return;
+        }
+    }
     QMutexLocker lk(&m_recMutex);
     m_tid = tid;
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -286,16 +405,8 @@ void MediaCapture::recordAudio(int tid, bool record)
         connect(m_audioRecorder.get(), &QAudioRecorder::stateChanged, this, [&, tid](QMediaRecorder::State state) {
             m_recordState = state;
             if (m_recordState == QMediaRecorder::StoppedState) {
-                m_resetTimer.start();
-                m_recLevels.clear();
-                m_lastPos = -1;
-                m_recOffset = 0;
-                Q_EMIT audioLevels(QVector<qreal>());
                 // m_readyForRecord is true if we were only displaying the countdown but real recording didn't start yet
-                if (!m_readyForRecord) {
-                    Q_EMIT pCore->finalizeRecording(getCaptureOutputLocation().toLocalFile());
-                }
-                m_readyForRecord = false;
+                recordingStopped(!m_readyForRecord);
             }
             Q_EMIT recordStateChanged(tid, m_recordState == QMediaRecorder::RecordingState);
         });
@@ -320,7 +431,7 @@ void MediaCapture::recordAudio(int tid, bool record)
         audioSettings.setChannelCount(KdenliveSettings::audiocapturechannels());
         m_audioRecorder->setEncodingSettings(audioSettings);
         m_audioRecorder->setOutputLocation(m_path);
-        m_recLevels.clear();
+        m_livePeaks.clear();
     } else if (!record) {
         m_audioRecorder->stop();
         m_recTimer.invalidate();
@@ -338,7 +449,7 @@ void MediaCapture::recordAudio(int tid, bool record)
             m_recordState = state;
             if (m_recordState == QMediaRecorder::StoppedState) {
                 m_resetTimer.start();
-                m_recLevels.clear();
+                m_livePeaks.clear();
                 m_lastPos = -1;
                 m_recOffset = 0;
                 Q_EMIT audioLevels(QVector<qreal>());
@@ -371,7 +482,7 @@ void MediaCapture::recordAudio(int tid, bool record)
         audioSettings.setChannelCount(KdenliveSettings::audiocapturechannels());
         m_audioRecorder->setEncodingSettings(audioSettings);
         m_audioRecorder->setOutputLocation(m_path);
-        m_recLevels.clear();
+        m_livePeaks.clear();
     } else if (!record) {
         m_audioRecorder->stop();
         m_recTimer.invalidate();
@@ -390,6 +501,26 @@ int MediaCapture::startCapture()
     m_recOffset = 0;
     m_recTimer.start();
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    if (m_directRecording) {
+        QMutexLocker lk(&m_recMutex);
+        const QAudioFormat format = m_audioInput ? m_audioInput->format() : QAudioFormat();
+        m_wavRecorder = std::make_unique<WavRecorder>(m_livePeaks);
+        if (!m_audioInfo || !m_wavRecorder->start(m_path.toLocalFile(), format.sampleRate(), format.channelCount(), pCore->getCurrentFps())) {
+            m_wavRecorder.reset();
+            m_directRecording = false;
+            lk.unlock();
+            pCore->displayMessage(i18n("Cannot write audio capture to %1", m_path.toLocalFile()), ErrorMessage);
+            recordingStopped(false);
+            Q_EMIT recordStateChanged(m_tid, false);
+            return m_tid;
+        }
+        m_audioInfo->setRecorder(m_wavRecorder.get());
+        m_recordState = QMediaRecorder::RecordingState;
+        m_readyForRecord = false;
+        lk.unlock();
+        Q_EMIT recordStateChanged(m_tid, true);
+        return m_tid;
+    }
     m_audioRecorder->record();
 #else
     // TODO: Qt6
@@ -453,7 +584,7 @@ void MediaCapture::setCaptureOutputLocation()
         extension = QStringLiteral(".mpeg");
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     // TODO: Qt6
-    } else if (m_audioRecorder.get() != nullptr) {
+    } else if (m_directRecording || m_audioRecorder.get() != nullptr) {
         // extension = QStringLiteral(".flac");
         extension = QStringLiteral(".wav");
     }
@@ -528,7 +659,9 @@ void MediaCapture::setAudioVolume()
 int MediaCapture::getState()
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    if (m_audioRecorder != nullptr) {
+    if (m_directRecording) {
+        currentState = m_recordState;
+    } else if (m_audioRecorder != nullptr) {
         currentState = m_audioRecorder->state();
     } else if (m_videoRecorder != nullptr) {
         currentState = m_videoRecorder->state();
@@ -557,7 +690,7 @@ int MediaCapture::recordState() const
 bool MediaCapture::isRecording() const
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    if (m_readyForRecord || (m_audioRecorder && m_audioRecorder->state() != QMediaRecorder::StoppedState)) {
+    if (m_readyForRecord || m_directRecording || (m_audioRecorder && m_audioRecorder->state() != QMediaRecorder::StoppedState)) {
         return true;
     }
     if (m_videoRecorder && m_videoRecorder->state() != QMediaRecorder::StoppedState) {
@@ -579,6 +712,14 @@ bool MediaCapture::isRecording() const
 void MediaCapture::pauseRecording()
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    if (m_directRecording) {
+        if (m_wavRecorder && m_recordState == QMediaRecorder::RecordingState) {
+            m_wavRecorder->setPaused(true);
+            m_recordState = QMediaRecorder::PausedState;
+            Q_EMIT recordStateChanged(m_tid, false);
+        }
+        return;
+    }
     m_audioRecorder->pause();
     if (m_audioRecorder->state() == QMediaRecorder::RecordingState) {
         // Pause is not supported on this platform
@@ -603,6 +744,14 @@ void MediaCapture::pauseRecording()
 void MediaCapture::resumeRecording()
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    if (m_directRecording) {
+        if (m_wavRecorder && m_recordState == QMediaRecorder::PausedState) {
+            m_wavRecorder->setPaused(false);
+            m_recordState = QMediaRecorder::RecordingState;
+            Q_EMIT recordStateChanged(m_tid, true);
+        }
+        return;
+    }
 
     if (m_audioRecorder->state() == QMediaRecorder::PausedState) {
         m_recOffset += m_lastPos;
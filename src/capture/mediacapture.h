@@ -7,6 +7,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #pragma once
 
+#include "wavrecorder.h"
+
 #include <QAudioBuffer>
 #include <QAudioInput>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -22,6 +24,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QStringList>
 #include <QTimer>
 #include <QUrl>
+#include <atomic>
 #include <memory>
 
 class AudioDevInfo: public QIODevice
@@ -30,6 +33,8 @@ class AudioDevInfo: public QIODevice
 public:
     AudioDevInfo(const QAudioFormat &format, QObject *parent = nullptr);
     quint32 maxAmplitude = 0;
+    /** @brief Captured samples are also passed to @param recorder, nullptr to stop */
+    void setRecorder(WavRecorder *recorder);
 
 Q_SIGNALS:
     void levelChanged(const QVector<qreal> &dbLevels);
@@ -40,6 +45,7 @@ protected:
     qint64 writeData(const char *data, qint64 maxSize) override;
 private:
     const QAudioFormat m_format;
+    std::atomic<WavRecorder *> m_recorder{nullptr};
 };
 
 class MediaCapture : public QObject
@@ -74,7 +80,11 @@ public:
     void switchMonitorState(bool run);
     /** @brief Returns true is audio monitoring is currently in progress **/
     bool isMonitoring() const;
-    const QVector<double> recLevels() const;
+    /** @brief The level of each frame of the recording in progress */
+    const LivePeaks &livePeaks() const;
+    /** @brief Retrieve the audio thumbnail levels computed while recording @param path.
+        Returns false if they are not available, they can only be taken once */
+    bool takeRecordedLevels(const QString &path, QVector<uint8_t> &levels, int &channels, int &maxLevel);
     /** @brief Start monitoring a track **/
     Q_INVOKABLE void switchMonitorState(int tid, bool run);
     void pauseRecording();
@@ -94,6 +104,9 @@ private:
     // TODO: Qt6
     // std::unique_ptr<QMediaCaptureSession> m_mediaCapture;
 #endif
+    /** @brief Declared before the audio input so that it is deleted after it */
+    LivePeaks m_livePeaks;
+    std::unique_ptr<WavRecorder> m_wavRecorder;
     std::unique_ptr<QAudioInput> m_audioInput;
     QScopedPointer<AudioDevInfo> m_audioInfo;
     std::unique_ptr<QMediaRecorder> m_videoRecorder;
@@ -102,7 +115,6 @@ private:
     QString m_audioDevice;
     QUrl m_path;
     QVector<qreal> m_levels;
-    QVector<double> m_recLevels;
     int m_recordState;
     /** @brief Last recorded frame */
     int m_lastPos;
@@ -113,6 +125,19 @@ private:
     bool m_readyForRecord;
     QTimer m_resetTimer;
     QMutex m_recMutex;
+    /** @brief true if the monitored input is written directly to a WAV file instead of using QAudioRecorder */
+    bool m_directRecording{false};
+    /** @brief true if monitoring was started only for the recording */
+    bool m_stopMonitorAfterRecord{false};
+    QMutex m_levelsMutex;
+    QString m_recordedPath;
+    QVector<uint8_t> m_recordedLevels;
+    int m_recordedChannels{0};
+    int m_recordedMax{0};
+    /** @brief Record from the monitoring input, returns false if its format cannot be written directly */
+    bool recordAudioDirect(int tid, bool record);
+    /** @brief Reset the recording state, @param finalize adds the recorded file to the project */
+    void recordingStopped(bool finalize);
 
 private Q_SLOTS:
     void resetIfUnused();
@@ -0,0 +1,275 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "wavrecorder.h"
+#include "audiomixer/iecscale.h"
+#include "jobs/audiolevelstask.h"
+
+#include <QThread>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include <mlt++/Mlt.h>
+
+static const int headerSize = 44;
+// The file is grown by steps of this duration to avoid reallocating it on each write
+static const int reserveSeconds = 30;
+
+AudioRingBuffer::AudioRingBuffer(int capacity)
+{
+    quint64 size = 1;
+    while (size < quint64(capacity)) {
+        size <<= 1;
+    }
+    m_data.resize(size);
+    m_mask = size - 1;
+}
+
+bool AudioRingBuffer::write(const char *data, int size)
+{
+    const quint64 writePos = m_writePos.load(std::memory_order_relaxed);
+    const quint64 readPos = m_readPos.load(std::memory_order_acquire);
+    if (size <= 0 || writePos - readPos + quint64(size) > m_data.size()) {
+        return false;
+    }
+    const quint64 start = writePos & m_mask;
+    const quint64 first = qMin(quint64(size), quint64(m_data.size()) - start);
+    memcpy(m_data.data() + start, data, first);
+    memcpy(m_data.data(), data + first, size - first);
+    m_writePos.store(writePos + quint64(size), std::memory_order_release);
+    return true;
+}
+
+int AudioRingBuffer::read(char *data, int maxSize)
+{
+    const quint64 readPos = m_readPos.load(std::memory_order_relaxed);
+    const quint64 writePos = m_writePos.load(std::memory_order_acquire);
+    const int size = int(qMin(writePos - readPos, quint64(qMax(0, maxSize))));
+    if (size == 0) {
+        return 0;
+    }
+    const quint64 start = readPos & m_mask;
+    const quint64 first = qMin(quint64(size), quint64(m_data.size()) - start);
+    memcpy(data, m_data.data() + start, first);
+    memcpy(data + first, m_data.data(), size - first);
+    m_readPos.store(readPos + quint64(size), std::memory_order_release);
+    return size;
+}
+
+int AudioRingBuffer::available() const
+{
+    return int(m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_relaxed));
+}
+
+LivePeaks::LivePeaks()
+{
+    m_chunks.resize(maxChunks);
+}
+
+void LivePeaks::append(float value)
+{
+    const int index = m_count.load(std::memory_order_relaxed);
+    const int chunk = index / chunkSize;
+    if (chunk >= maxChunks) {
+        return;
+    }
+    if (!m_chunks[size_t(chunk)]) {
+        m_chunks[size_t(chunk)].reset(new float[chunkSize]);
+    }
+    m_chunks[size_t(chunk)][index % chunkSize] = value;
+    // Readers only access values below the published count
+    m_count.store(index + 1, std::memory_order_release);
+}
+
+void LivePeaks::clear()
+{
+    // Keep the allocated chunks, a reader may still be painting
+    m_count.store(0, std::memory_order_release);
+}
+
+int LivePeaks::count() const
+{
+    return m_count.load(std::memory_order_acquire);
+}
+
+float LivePeaks::at(int index) const
+{
+    return m_chunks[size_t(index / chunkSize)][index % chunkSize];
+}
+
+WavRecorder::WavRecorder(LivePeaks &peaks)
+    : m_peaks(peaks)
+    , m_buffer(1 << 21)
+{
+}
+
+WavRecorder::~WavRecorder()
+{
+    stop();
+}
+
+bool WavRecorder::start(const QString &path, int sampleRate, int channels, double fps)
+{
+    m_sampleRate = sampleRate;
+    m_channels = qMax(1, channels);
+    m_fps = fps;
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        return false;
+    }
+    m_reserved = qint64(reserveSeconds) * m_sampleRate * m_channels * int(sizeof(qint16));
+    if (!writeHeader(0) || !m_file.resize(headerSize + m_reserved) || !m_file.seek(headerSize)) {
+        m_file.close();
+        return false;
+    }
+    m_chunk.resize(1 << 16);
+    m_peaks.clear();
+    m_running = true;
+    m_thread.reset(QThread::create([this]() { writeLoop(); }));
+    m_thread->setObjectName(QStringLiteral("WavRecorder"));
+    m_thread->start(QThread::HighPriority);
+    return true;
+}
+
+void WavRecorder::push(const char *data, qint64 size)
+{
+    if (!m_running.load(std::memory_order_relaxed) || m_paused.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!m_buffer.write(data, int(size))) {
+        m_dropped += size;
+    }
+}
+
+void WavRecorder::setPaused(bool paused)
+{
+    m_paused = paused;
+}
+
+bool WavRecorder::stop()
+{
+    if (!m_thread) {
+        return !m_writeError;
+    }
+    m_running = false;
+    m_thread->wait();
+    m_thread.reset();
+    // Complete the last frame with silence
+    if (!m_frameSamples.empty()) {
+        const int missing = mlt_audio_calculate_frame_samples(float(m_fps), m_sampleRate, m_frame) * m_channels - int(m_frameSamples.size());
+        std::vector<qint16> silence(size_t(qMax(0, missing)), 0);
+        analyse(reinterpret_cast<const char *>(silence.data()), int(silence.size() * sizeof(qint16)));
+    }
+    if (!m_writeError) {
+        m_writeError = !writeHeader(quint32(m_dataSize)) || !m_file.resize(headerSize + m_dataSize);
+    }
+    m_file.close();
+    return !m_writeError;
+}
+
+void WavRecorder::writeLoop()
+{
+    while (m_running) {
+        if (!flush()) {
+            break;
+        }
+        QThread::msleep(10);
+    }
+    flush();
+}
+
+bool WavRecorder::flush()
+{
+    const int frameBytes = m_channels * int(sizeof(qint16));
+    while (!m_writeError) {
+        int size = m_buffer.read(m_chunk.data(), int(m_chunk.size()) - int(m_chunk.size()) % frameBytes);
+        if (size == 0) {
+            return true;
+        }
+        if (m_dataSize + size > m_reserved) {
+            m_reserved += qint64(reserveSeconds) * m_sampleRate * frameBytes;
+            m_file.resize(headerSize + m_reserved);
+            m_file.seek(headerSize + m_dataSize);
+        }
+        if (m_file.write(m_chunk.data(), size) != size) {
+            m_writeError = true;
+            break;
+        }
+        m_dataSize += size;
+        analyse(m_chunk.data(), size);
+    }
+    return false;
+}
+
+void WavRecorder::analyse(const char *data, int size)
+{
+    const int samples = size / int(sizeof(qint16));
+    const auto *input = reinterpret_cast<const qint16 *>(data);
+    int frameSamples = mlt_audio_calculate_frame_samples(float(m_fps), m_sampleRate, m_frame) * m_channels;
+    for (int i = 0; i < samples; ++i) {
+        m_frameSamples.push_back(qFromLittleEndian(input[i]));
+        if (int(m_frameSamples.size()) < frameSamples) {
+            continue;
+        }
+        // A frame is complete
+        const int count = frameSamples / m_channels;
+        int peak = 0;
+        for (int channel = 0; channel < m_channels; ++channel) {
+            uint lev = 256 * qMin(AudioLevelsTask::audioLevel(m_frameSamples.data() + channel, count, m_channels) * 0.9, 1.0);
+            m_levels << lev;
+            m_maxLevel = qMax(lev, m_maxLevel);
+        }
+        for (qint16 sample : m_frameSamples) {
+            peak = qMax(peak, qAbs(int(sample)));
+        }
+        double dB = peak > 0 ? 20. * std::log10(peak / 32768.) : -100.;
+        m_peaks.append(float(IEC_ScaleMax(dB, 0)));
+        m_frameSamples.clear();
+        m_frame++;
+        frameSamples = mlt_audio_calculate_frame_samples(float(m_fps), m_sampleRate, m_frame) * m_channels;
+    }
+}
+
+bool WavRecorder::writeHeader(quint32 dataSize)
+{
+    char header[headerSize];
+    const quint16 bytesPerFrame = quint16(m_channels * sizeof(qint16));
+    memcpy(header, "RIFF", 4);
+    qToLittleEndian<quint32>(36 + dataSize, header + 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    qToLittleEndian<quint32>(16, header + 16);
+    // PCM
+    qToLittleEndian<quint16>(1, header + 20);
+    qToLittleEndian<quint16>(quint16(m_channels), header + 22);
+    qToLittleEndian<quint32>(quint32(m_sampleRate), header + 24);
+    qToLittleEndian<quint32>(quint32(m_sampleRate) * bytesPerFrame, header + 28);
+    qToLittleEndian<quint16>(bytesPerFrame, header + 32);
+    qToLittleEndian<quint16>(16, header + 34);
+    memcpy(header + 36, "data", 4);
+    qToLittleEndian<quint32>(dataSize, header + 40);
+    qint64 pos = m_file.pos();
+    bool ok = m_file.seek(0) && m_file.write(header, headerSize) == headerSize;
+    return m_file.seek(qMax(qint64(headerSize), pos)) && ok;
+}
+
+int WavRecorder::channels() const
+{
+    return m_channels;
+}
+
+const QVector<uint8_t> &WavRecorder::thumbnailLevels() const
+{
+    return m_levels;
+}
+
+int WavRecorder::maxLevel() const
+{
+    return int(m_maxLevel);
+}
+
+qint64 WavRecorder::droppedBytes() const
+{
+    return m_dropped;
+}
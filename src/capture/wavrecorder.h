@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class QThread;
+
+/** @class AudioRingBuffer
+    @brief A lock-free byte queue with a single producer and a single consumer.
+ */
+class AudioRingBuffer
+{
+public:
+    /** @brief Create a buffer of at least @param capacity bytes */
+    explicit AudioRingBuffer(int capacity);
+    /** @brief Append @param size bytes, all or nothing. Returns false if there is not enough room */
+    bool write(const char *data, int size);
+    /** @brief Read up to @param maxSize bytes, returns the number of bytes read */
+    int read(char *data, int maxSize);
+    /** @brief Number of bytes ready to be read */
+    int available() const;
+
+private:
+    std::vector<char> m_data;
+    quint64 m_mask;
+    std::atomic<quint64> m_writePos{0};
+    std::atomic<quint64> m_readPos{0};
+};
+
+/** @class LivePeaks
+    @brief Append-only list of per frame levels (0 to 1) of a recording in progress.
+    Values are appended by a single thread and can be read concurrently without copy or lock:
+    storage is allocated in chunks that never move, and only the values below count() are read.
+ */
+class LivePeaks
+{
+public:
+    LivePeaks();
+    /** @brief Add the level of the next frame, only called from one thread at a time */
+    void append(float value);
+    /** @brief Forget all values, must not be called while values are appended */
+    void clear();
+    int count() const;
+    /** @brief The level of frame @param index, which must be lower than count() */
+    float at(int index) const;
+
+private:
+    static const int chunkSize = 4096;
+    static const int maxChunks = 4096;
+    std::vector<std::unique_ptr<float[]>> m_chunks;
+    std::atomic<int> m_count{0};
+};
+
+/** @class WavRecorder
+    @brief Writes captured 16 bit PCM audio to a WAV file from a dedicated thread.
+    The capture callback only copies the samples to a lock-free buffer. The writing thread
+    stores them in a file grown by large steps, publishes the peak of each frame for the
+    live waveform, and computes the audio thumbnail levels so that the recorded clip does
+    not need to be analysed again.
+ */
+class WavRecorder
+{
+public:
+    explicit WavRecorder(LivePeaks &peaks);
+    ~WavRecorder();
+
+    /** @brief Create the file at @param path and start the writing thread */
+    bool start(const QString &path, int sampleRate, int channels, double fps);
+    /** @brief Queue captured interleaved samples, called from the capture callback */
+    void push(const char *data, qint64 size);
+    /** @brief While paused, captured samples are dropped */
+    void setPaused(bool paused);
+    /** @brief Write the remaining samples and finalize the file, returns false on write error */
+    bool stop();
+
+    int channels() const;
+    /** @brief The audio thumbnail levels, interleaved per channel, one value per frame. Available after stop() */
+    const QVector<uint8_t> &thumbnailLevels() const;
+    int maxLevel() const;
+    /** @brief Bytes that could not be queued because the writing thread was late */
+    qint64 droppedBytes() const;
+
+private:
+    void writeLoop();
+    /** @brief Write the queued samples to the file, returns false on write error */
+    bool flush();
+    /** @brief Compute the levels of the samples of complete frames */
+    void analyse(const char *data, int size);
+    bool writeHeader(quint32 dataSize);
+
+    LivePeaks &m_peaks;
+    AudioRingBuffer m_buffer;
+    QFile m_file;
+    std::unique_ptr<QThread> m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_paused{false};
+    std::atomic<qint64> m_dropped{0};
+    int m_sampleRate{48000};
+    int m_channels{2};
+    double m_fps{25.};
+    qint64 m_dataSize{0};
+    qint64 m_reserved{0};
+    bool m_writeError{false};
+    std::vector<char> m_chunk;
+    /** @brief Samples of the frame being analysed */
+    std::vector<qint16> m_frameSamples;
+    int m_frame{0};
+    QVector<uint8_t> m_levels;
+    uint m_maxLevel{1};
+};
@@ -29,6 +29,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "timeline2/view/timelinecontroller.h"
 #include "timeline2/view/timelinewidget.h"
+#include "utils/startuptrace.h"
 #include <mlt++/MltRepository.h>
 
 #include "utils/KMessageBox_KdenliveCompat.h"
@@ -37,6 +38,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QDir>
 #include <QInputDialog>
 #include <QQuickStyle>
+#include <QTimer>
 #include <locale>
 #ifdef Q_OS_MAC
 #include <xlocale.h>
@@ -132,7 +134,11 @@ bool Core::build(const QString &packageType, bool testMode)
 
 void Core::initGUI(bool inSandbox, const QString &MltPath, const QUrl &Url, const QString &clipsToLoad)
 {
-    m_mainWindow = new MainWindow();
+    StartupTrace::Phase guiPhase("Core::initGUI");
+    {
+        StartupTrace::Phase phase("MainWindow constructor");
+        m_mainWindow = new MainWindow();
+    }
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 
     QStringList styles = QQuickStyle::availableStyles();
@@ -164,7 +170,10 @@ void Core::initGUI(bool inSandbox, const QString &MltPath, const QUrl &Url, cons
     if (!Url.isEmpty()) {
         Q_EMIT loadingMessageUpdated(i18n("Loading project…"));
     }
-    projectManager()->init(Url, clipsToLoad);
+    {
+        StartupTrace::Phase phase("ProjectManager::init");
+        projectManager()->init(Url, clipsToLoad);
+    }
 
     // The MLT Factory will be initiated there, all MLT classes will be usable only after this
     if (inSandbox) {
@@ -180,6 +189,7 @@ void Core::initGUI(bool inSandbox, const QString &MltPath, const QUrl &Url, cons
         m_mainWindow->init(MltPath);
     }
     m_projectItemModel->buildPlaylist(QUuid());
+    StartupTrace::mark("MainWindow initialized");
     // load the profiles from disk
     ProfileRepository::get()->refresh();
     // load default profile
@@ -236,13 +246,24 @@ void Core::initGUI(bool inSandbox, const QString &MltPath, const QUrl &Url, cons
     }
     m_guiConstructed = true;
     QMetaObject::invokeMethod(pCore->projectManager(), "slotLoadOnOpen", Qt::QueuedConnection);
-    m_mainWindow->show();
+    {
+        StartupTrace::Phase phase("Show main window");
+        m_mainWindow->show();
+    }
     bin->slotUpdatePalette();
     Q_EMIT m_mainWindow->GUISetupDone();
+    if (StartupTrace::isEnabled()) {
+        // Runs once the events queued during startup, including the project loading, are processed
+        QTimer::singleShot(0, this, []() {
+            StartupTrace::mark("Interactive");
+            StartupTrace::finish();
+        });
+    }
 }
 
 void Core::buildDocks()
 {
+    StartupTrace::Phase phase("Core::buildDocks");
     // Mixer
     m_mixerWidget = new MixerManager(m_mainWindow);
     connect(m_capture.get(), &MediaCapture::recordStateChanged, m_mixerWidget, &MixerManager::recordStateChanged);
@@ -272,9 +293,6 @@ void Core::buildDocks()
         }
     });
 
-    // Text edit speech
-    m_textEditWidget = new TextBasedEdit(m_mainWindow);
-
     // Time remap
     m_timeRemapWidget = new TimeRemap(m_mainWindow);
 
@@ -282,19 +300,6 @@ void Core::buildDocks()
     m_guidesList = new GuidesList(m_mainWindow);
 }
 
-void Core::buildLumaThumbs(const QStringList &values)
-{
-    for (auto &entry : values) {
-        if (MainWindow::m_lumacache.contains(entry)) {
-            continue;
-        }
-        QImage pix(entry);
-        if (!pix.isNull()) {
-            MainWindow::m_lumacache.insert(entry, pix.scaled(50, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        }
-    }
-}
-
 QString Core::openExternalApp(QString appPath, QStringList args)
 {
     QProcess process;
@@ -490,6 +495,18 @@ TextBasedEdit *Core::textEditWidget()
     return m_textEditWidget;
 }
 
+TextBasedEdit *Core::buildTextEditWidget()
+{
+    if (!m_textEditWidget) {
+        // Looking for the speech models is slow, only done when the widget is used
+        m_textEditWidget = new TextBasedEdit(m_mainWindow);
+        if (m_monitorManager && m_monitorManager->clipMonitor()) {
+            m_textEditWidget->openClip(m_monitorManager->clipMonitor()->currentController());
+        }
+    }
+    return m_textEditWidget;
+}
+
 TimeRemap *Core::timeRemapWidget()
 {
     return m_timeRemapWidget;
@@ -863,6 +880,9 @@ void Core::refreshProjectItem(const ObjectId &id)
     case ObjectType::TimelineClip:
     case ObjectType::TimelineMix:
         if (m_mainWindow->getCurrentTimeline()->model()->isClip(id.second)) {
+            if (m_mainWindow->getCurrentTimeline()->model()->isAudioTrack(m_mainWindow->getCurrentTimeline()->model()->getClipTrackId(id.second))) {
+                m_monitorManager->projectMonitor()->invalidateAudioScrub();
+            }
             m_mainWindow->getCurrentTimeline()->controller()->refreshItem(id.second);
         }
         break;
@@ -873,6 +893,9 @@ void Core::refreshProjectItem(const ObjectId &id)
         break;
     case ObjectType::TimelineTrack:
         if (m_mainWindow->getCurrentTimeline()->model()->isTrack(id.second)) {
+            if (m_mainWindow->getCurrentTimeline()->model()->isAudioTrack(id.second)) {
+                m_monitorManager->projectMonitor()->invalidateAudioScrub();
+            }
             refreshProjectMonitorOnce();
         }
         break;
@@ -881,11 +904,14 @@ void Core::refreshProjectItem(const ObjectId &id)
             m_monitorManager->activateMonitor(Kdenlive::ClipMonitor);
             m_monitorManager->refreshClipMonitor(true);
         }
+        // The bin clip may be used in the timeline
+        m_monitorManager->projectMonitor()->invalidateAudioScrub();
         if (m_monitorManager->projectMonitorVisible() && m_mainWindow->getCurrentTimeline()->controller()->refreshIfVisible(id.second)) {
             m_monitorManager->refreshTimer.start();
         }
         break;
     case ObjectType::Master:
+        m_monitorManager->projectMonitor()->invalidateAudioScrub();
         refreshProjectMonitorOnce();
         break;
     default:
@@ -129,8 +129,10 @@ public:
     LibraryWidget *library();
     /** @brief Returns a pointer to the subtitle edit. */
     SubtitleEdit *subtitleWidget();
-    /** @brief Returns a pointer to the text based editing widget. */
+    /** @brief Returns a pointer to the text based editing widget, nullptr until its dock is first shown. */
     TextBasedEdit *textEditWidget();
+    /** @brief Create the text based editing widget, showing the clip of the clip monitor. */
+    TextBasedEdit *buildTextEditWidget();
     /** @brief Returns a pointer to the guides list widget. */
     GuidesList *guidesList();
     /** @brief Returns a pointer to the time remapping widget. */
@@ -360,8 +362,6 @@ public Q_SLOTS:
     /** @brief display a user info/warning message in the project bin */
     void displayBinMessage(const QString &text, int type, const QList<QAction *> &actions = QList<QAction *>(), bool showClose = false, BinMessage::BinCategory messageCategory = BinMessage::BinCategory::NoMessage);
     void displayBinLogMessage(const QString &text, int type, const QString logInfo);
-    /** @brief Create small thumbnails for luma used in compositions */
-    void buildLumaThumbs(const QStringList &values);
     /** @brief Try to find a display name for the given filename.
      *  This is espacally helpfull for mlt's dynamically created luma files without thumb (luma01.pgm, luma02.pgm,...),
      *  but also for others as it makes the visible name translatable.
@@ -414,6 +414,8 @@ Q_SIGNALS:
     void updatePalette();
     /** @brief Emitted when a clip is resized (to handle clip monitor inserted zones) */
     void clipInstanceResized(const QString &binId);
+    /** @brief The loudness analysis of bin clip @param binId is finished */
+    void loudnessUpdated(const QString &binId);
     /** @brief Contains the project audio levels */
     void audioLevelsAvailable(const QVector<double>& levels);
     /** @brief A frame was displayed in monitor, update audio mixer */
@@ -165,11 +165,13 @@ QMap<QString, QString> ClipJobManager::getClipJobNames()
     KConfig conf(QStringLiteral("clipjobsettings.rc"), KConfig::CascadeConfig, QStandardPaths::AppDataLocation);
     KConfigGroup group(&conf, "Ids");
     QMap<QString, QString> ids = group.entryMap();
-    // Add the 3 internal jobs
+    // Add the internal jobs
     if (EffectsRepository::get()->exists(QLatin1String("vidstab"))) {
         ids.insert(QStringLiteral("stabilize"), i18n("Stabilize"));
     }
     ids.insert(QStringLiteral("scenesplit"), i18n("Automatic Scene Split…"));
+    ids.insert(QStringLiteral("loudness"), i18n("Analyse Loudness"));
+    ids.insert(QStringLiteral("silencedetect"), i18n("Detect Silence…"));
     if (KdenliveSettings::producerslist().contains(QLatin1String("timewarp"))) {
         ids.insert(QStringLiteral("timewarp"), i18n("Duplicate Clip with Speed Change…"));
     }
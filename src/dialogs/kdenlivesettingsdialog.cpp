@@ -13,6 +13,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "mainwindow.h"
 #include "monitor/monitor.h"
 #include "monitor/monitorproxy.h"
+#include "monitor/scrubcache.h"
 #include "profiles/profilemodel.hpp"
 #include "profiles/profilerepository.hpp"
 #include "profilesdialog.h"
@@ -28,6 +29,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "KLocalizedString"
 #include "kdenlive_debug.h"
+#include <KActionCollection>
 #include <KArchive>
 #include <KArchiveDirectory>
 #include <KIO/DesktopExecParser>
@@ -353,6 +355,11 @@ void KdenliveSettingsDialog::initEnviromentPage()
     connect(m_configEnv.kcfg_librarytodefaultfolder, &QAbstractButton::clicked, this, &KdenliveSettingsDialog::slotEnableLibraryFolder);
 
     m_configEnv.kcfg_proxythreads->setMaximum(qMax(1, QThread::idealThreadCount() - 1));
+    // The thread count is chosen by the task manager in automatic mode
+    m_configEnv.kcfg_proxythreads->setEnabled(!KdenliveSettings::proxyautothreads());
+    m_configEnv.label_9->setEnabled(!KdenliveSettings::proxyautothreads());
+    connect(m_configEnv.kcfg_proxyautothreads, &QAbstractButton::toggled, m_configEnv.kcfg_proxythreads, &QWidget::setDisabled);
+    connect(m_configEnv.kcfg_proxyautothreads, &QAbstractButton::toggled, m_configEnv.label_9, &QWidget::setDisabled);
 
     // Script rendering files folder
     m_configEnv.videofolderurl->setMode(KFile::Directory);
@@ -514,6 +521,8 @@ void KdenliveSettingsDialog::initSdlPage(bool gpuAllowed)
             &KdenliveSettingsDialog::slotCheckAlsaDriver);
     connect(m_configSdl.kcfg_audio_backend, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
             &KdenliveSettingsDialog::slotCheckAudioBackend);
+    connect(m_configSdl.kcfg_scrubcache, &QCheckBox::toggled, m_configSdl.kcfg_scrubcachesize, &QSpinBox::setEnabled);
+    m_configSdl.kcfg_scrubcachesize->setEnabled(KdenliveSettings::scrubcache());
 
     // enable GPU accel only if Movit is found
     m_configSdl.kcfg_gpu_accel->setEnabled(gpuAllowed);
@@ -1196,6 +1205,30 @@ void KdenliveSettingsDialog::updateSettings()
         resetConsumer = true;
     }
 
+    if (m_configSdl.kcfg_scrubcache->isChecked() != KdenliveSettings::scrubcache()) {
+        KdenliveSettings::setScrubcache(m_configSdl.kcfg_scrubcache->isChecked());
+        if (!KdenliveSettings::scrubcache()) {
+            ScrubCache::get()->clear();
+        }
+        QAction *scrubAction = pCore->window()->actionCollection()->action(QStringLiteral("mlt_scrub_cache"));
+        if (scrubAction) {
+            scrubAction->setChecked(KdenliveSettings::scrubcache());
+        }
+    }
+    if (m_configSdl.kcfg_scrubcachesize->value() != KdenliveSettings::scrubcachesize()) {
+        KdenliveSettings::setScrubcachesize(m_configSdl.kcfg_scrubcachesize->value());
+        ScrubCache::get()->updateCapacity();
+    }
+    if (m_configSdl.kcfg_monitor_framequeue->value() != KdenliveSettings::monitor_framequeue() ||
+        m_configSdl.kcfg_monitor_framequeuemb->value() != KdenliveSettings::monitor_framequeuemb() ||
+        m_configSdl.kcfg_monitor_framequeuelatency->value() != KdenliveSettings::monitor_framequeuelatency()) {
+        KdenliveSettings::setMonitor_framequeue(m_configSdl.kcfg_monitor_framequeue->value());
+        KdenliveSettings::setMonitor_framequeuemb(m_configSdl.kcfg_monitor_framequeuemb->value());
+        KdenliveSettings::setMonitor_framequeuelatency(m_configSdl.kcfg_monitor_framequeuelatency->value());
+        // The display queue limits are applied when the consumer starts
+        resetConsumer = true;
+    }
+
     value = m_configSdl.kcfg_audio_backend->currentData().toString();
     if (value != KdenliveSettings::audiobackend()) {
         KdenliveSettings::setAudiobackend(value);
@@ -1322,8 +1355,10 @@ void KdenliveSettingsDialog::updateSettings()
     }
 
     // proxy/transcode max concurrent jobs
-    if (m_configEnv.kcfg_proxythreads->value() != KdenliveSettings::proxythreads()) {
+    if (m_configEnv.kcfg_proxythreads->value() != KdenliveSettings::proxythreads() ||
+        m_configEnv.kcfg_proxyautothreads->isChecked() != KdenliveSettings::proxyautothreads()) {
         KdenliveSettings::setProxythreads(m_configEnv.kcfg_proxythreads->value());
+        KdenliveSettings::setProxyautothreads(m_configEnv.kcfg_proxyautothreads->isChecked());
         pCore->taskManager.updateConcurrency();
     }
 
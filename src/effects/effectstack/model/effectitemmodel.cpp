@@ -5,15 +5,50 @@
 
 #include "effectitemmodel.hpp"
 
+#include "assets/keyframes/model/keyframemodellist.hpp"
 #include "core.h"
 #include "effects/effectsrepository.hpp"
 #include "effectstackmodel.hpp"
+#include "project/projectmanager.h"
+#include "timeline2/model/timelineitemmodel.hpp"
+
+#include <KLocalizedString>
+#include <QMutex>
+#include <algorithm>
+#include <unordered_map>
 #include <utility>
 
-EffectItemModel::EffectItemModel(const QList<QVariant> &effectData, std::unique_ptr<Mlt::Properties> effect, const QDomElement &xml, const QString &effectId,
-                                 const std::shared_ptr<AbstractTreeModel> &stack, bool isEnabled, QString originalDecimalPoint)
+namespace {
+/** @brief The live instances of the linked effects, by link id */
+struct LinkRegistry
+{
+    QMutex mutex;
+    std::unordered_map<QString, std::vector<std::weak_ptr<EffectItemModel>>> effects;
+};
+
+LinkRegistry &linkRegistry()
+{
+    static LinkRegistry registry;
+    return registry;
+}
+
+/** @brief Returns the in point and duration of the clip @p owner in the active timeline, a null duration if it is not one of its clips */
+QPair<int, int> clipRange(const ObjectId &owner)
+{
+    std::shared_ptr<TimelineItemModel> timeline = pCore->projectManager()->getTimeline();
+    if (owner.first != ObjectType::TimelineClip || !timeline || !timeline->isClip(owner.second)) {
+        return {0, 0};
+    }
+    return {timeline->getClipIn(owner.second), timeline->getClipPlaytime(owner.second)};
+}
+} // namespace
+
+EffectItemModel::EffectItemModel(const QList<QVariant> &effectData, std::unique_ptr<Mlt::Properties> effect, std::shared_ptr<const AssetDescriptor> descriptor,
+                                 const QStringList &values, const QString &effectId, const std::shared_ptr<AbstractTreeModel> &stack, bool isEnabled,
+                                 QString originalDecimalPoint)
     : AbstractEffectItem(EffectItemType::Effect, effectData, stack, false, isEnabled)
-    , AssetParameterModel(std::move(effect), xml, effectId, std::static_pointer_cast<EffectStackModel>(stack)->getOwnerId(), originalDecimalPoint)
+    , AssetParameterModel(std::move(effect), std::move(descriptor), values, effectId, std::static_pointer_cast<EffectStackModel>(stack)->getOwnerId(),
+                          originalDecimalPoint)
     , m_childId(0)
 {
     connect(this, &AssetParameterModel::updateChildren, [&](const QStringList &names) {
@@ -35,7 +70,7 @@ EffectItemModel::EffectItemModel(const QList<QVariant> &effectData, std::unique_
 std::shared_ptr<EffectItemModel> EffectItemModel::construct(const QString &effectId, std::shared_ptr<AbstractTreeModel> stack, bool effectEnabled)
 {
     Q_ASSERT(EffectsRepository::get()->exists(effectId));
-    QDomElement xml = EffectsRepository::get()->getXml(effectId);
+    std::shared_ptr<const AssetDescriptor> descriptor = EffectsRepository::get()->getDescriptor(effectId);
 
     std::unique_ptr<Mlt::Properties> effect = EffectsRepository::get()->getEffect(effectId);
     effect->set("kdenlive_id", effectId.toUtf8().constData());
@@ -43,7 +78,7 @@ std::shared_ptr<EffectItemModel> EffectItemModel::construct(const QString &effec
     QList<QVariant> data;
     data << EffectsRepository::get()->getName(effectId) << effectId;
 
-    std::shared_ptr<EffectItemModel> self(new EffectItemModel(data, std::move(effect), xml, effectId, stack, effectEnabled));
+    std::shared_ptr<EffectItemModel> self(new EffectItemModel(data, std::move(effect), descriptor, {}, effectId, stack, effectEnabled));
 
     baseFinishConstruct(self);
     return self;
@@ -58,34 +93,37 @@ std::shared_ptr<EffectItemModel> EffectItemModel::construct(std::unique_ptr<Mlt:
     }
     Q_ASSERT(EffectsRepository::get()->exists(effectId));
 
-    // Get the effect XML and add parameter values from the project file
-    QDomElement xml = EffectsRepository::get()->getXml(effectId);
-    QDomNodeList params = xml.elementsByTagName(QStringLiteral("parameter"));
-    for (int i = 0; i < params.count(); ++i) {
-        QDomElement currentParameter = params.item(i).toElement();
-        QString paramName = currentParameter.attribute(QStringLiteral("name"));
-        QString paramType = currentParameter.attribute(QStringLiteral("type"));
-        if (paramType == QLatin1String("multiswitch")) {
-            // multiswitch params have a composited param name, skip
-            QStringList names = paramName.split(QLatin1Char('\n'));
+    // Get the shared effect definition and the parameter values from the project file
+    std::shared_ptr<const AssetDescriptor> descriptor = EffectsRepository::get()->getDescriptor(effectId);
+    QStringList values;
+    values.reserve(int(descriptor->parameters.size()));
+    for (const AssetDescriptor::Parameter &param : descriptor->parameters) {
+        QString paramValue;
+        if (param.type == ParamType::MultiSwitch) {
+            // multiswitch params have a composited param name
+            QStringList names = param.name.split(QLatin1Char('\n'));
             QStringList paramValues;
             for (const QString &n : qAsConst(names)) {
                 paramValues << effect->get(n.toUtf8().constData());
             }
-            currentParameter.setAttribute(QStringLiteral("value"), paramValues.join(QLatin1Char('\n')));
-            continue;
+            paramValue = paramValues.join(QLatin1Char('\n'));
+        } else {
+            paramValue = effect->get(param.name.toUtf8().constData());
         }
-        QString paramValue = effect->get(paramName.toUtf8().constData());
-        qDebug() << effectId << ": Setting parameter " << paramName << " to " << paramValue;
-        currentParameter.setAttribute(QStringLiteral("value"), paramValue);
+        // A missing property uses the default value, not the one from the definition
+        values << (paramValue.isNull() ? QStringLiteral("") : paramValue);
     }
 
     QList<QVariant> data;
     data << EffectsRepository::get()->getName(effectId) << effectId;
 
     bool disable = effect->get_int("disable") == 0;
-    std::shared_ptr<EffectItemModel> self(new EffectItemModel(data, std::move(effect), xml, effectId, stack, disable, originalDecimalPoint));
+    const QString linkId = effect->get("kdenlive:link_id");
+    std::shared_ptr<EffectItemModel> self(new EffectItemModel(data, std::move(effect), descriptor, values, effectId, stack, disable, originalDecimalPoint));
     baseFinishConstruct(self);
+    if (!linkId.isEmpty()) {
+        self->setLinkId(linkId);
+    }
     return self;
 }
 
@@ -308,3 +346,207 @@ void EffectItemModel::setInOut(const QString &effectName, QPair<int, int> bounds
         pCore->pushUndo(undo, redo, i18n("Update zone for %1", effectName));
     }
 }
+
+QString EffectItemModel::linkId() const
+{
+    return m_asset->get("kdenlive:link_id");
+}
+
+void EffectItemModel::setLinkId(const QString &linkId)
+{
+    LinkRegistry &registry = linkRegistry();
+    QMutexLocker lock(&registry.mutex);
+    const QString previous = this->linkId();
+    if (!previous.isEmpty()) {
+        auto it = registry.effects.find(previous);
+        if (it != registry.effects.end()) {
+            auto &instances = it->second;
+            instances.erase(std::remove_if(instances.begin(), instances.end(),
+                                           [this](const std::weak_ptr<EffectItemModel> &effect) {
+                                               auto ptr = effect.lock();
+                                               return !ptr || ptr.get() == this;
+                                           }),
+                            instances.end());
+            if (instances.empty()) {
+                registry.effects.erase(it);
+            }
+        }
+    }
+    if (linkId.isEmpty()) {
+        m_asset->clear("kdenlive:link_id");
+        return;
+    }
+    m_asset->set("kdenlive:link_id", linkId.toUtf8().constData());
+    std::shared_ptr<EffectItemModel> self(AssetParameterModel::shared_from_this(), this);
+    registry.effects[linkId].push_back(self);
+}
+
+std::vector<std::shared_ptr<EffectItemModel>> EffectItemModel::linkedEffects() const
+{
+    std::vector<std::shared_ptr<EffectItemModel>> result;
+    const QString id = linkId();
+    if (id.isEmpty()) {
+        return result;
+    }
+    std::vector<std::weak_ptr<EffectItemModel>> instances;
+    {
+        LinkRegistry &registry = linkRegistry();
+        QMutexLocker lock(&registry.mutex);
+        auto it = registry.effects.find(id);
+        if (it == registry.effects.end()) {
+            return result;
+        }
+        // Drop the instances that were destroyed
+        auto &entries = it->second;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const std::weak_ptr<EffectItemModel> &effect) { return effect.expired(); }),
+                      entries.end());
+        if (entries.empty()) {
+            registry.effects.erase(it);
+            return result;
+        }
+        instances = entries;
+    }
+    for (const auto &instance : instances) {
+        auto effect = instance.lock();
+        // Effects of deleted clips stay alive in the undo history, only keep the ones in a timeline
+        if (!effect || effect.get() == this || !effect->isInModel() || effect->getAssetId() != m_assetId) {
+            continue;
+        }
+        if (clipRange(effect->getOwnerId()).second > 0) {
+            result.push_back(effect);
+        }
+    }
+    return result;
+}
+
+void EffectItemModel::shareKeyframes(const std::shared_ptr<EffectItemModel> &source)
+{
+    std::shared_ptr<KeyframeModelList> keyframes = getKeyframeModel();
+    std::shared_ptr<KeyframeModelList> sourceKeyframes = source->getKeyframeModel();
+    if (keyframes && sourceKeyframes) {
+        keyframes->shareKeyframes(*sourceKeyframes.get());
+    }
+}
+
+void EffectItemModel::shareLinkedKeyframes()
+{
+    if (!getKeyframeModel()) {
+        return;
+    }
+    const auto linked = linkedEffects();
+    if (!linked.empty()) {
+        shareKeyframes(linked.front());
+    }
+}
+
+bool EffectItemModel::updateLinkedEffects()
+{
+    const auto linked = linkedEffects();
+    if (linked.empty()) {
+        return false;
+    }
+    const QStringList keyframeParams = getKeyframableParameters();
+    const QPair<int, int> sourceRange = clipRange(m_ownerId);
+    const int sourceIn = sourceRange.first;
+    const int sourceEnd = sourceIn + qMax(0, sourceRange.second - 1);
+    // Keyframes are stored relative to the clip in point, compare and copy them in the referential of the target
+    auto convert = [keyframeParams](const std::shared_ptr<EffectItemModel> &effect, const QString &name, const QString &value, int offset, int end) {
+        if (offset == 0 || !keyframeParams.contains(name) || !value.contains(QLatin1Char('='))) {
+            return value;
+        }
+        return KeyframeModel::getAnimationStringWithOffset(effect, value, offset, end);
+    };
+    std::vector<int> targetIn;
+    std::vector<int> targetEnd;
+    for (const auto &effect : linked) {
+        const QPair<int, int> range = clipRange(effect->getOwnerId());
+        targetIn.push_back(range.first);
+        targetEnd.push_back(range.first + qMax(0, range.second - 1));
+    }
+    std::vector<paramVector> newValues(linked.size());
+    std::vector<paramVector> oldValues(linked.size());
+    const paramVector sourceParams = getAllParameters();
+    for (const auto &param : sourceParams) {
+        const QString value = param.second.toString();
+        // The shared definition is the value of most instances, the other ones are overrides
+        std::vector<QString> values;
+        QMap<QString, int> votes;
+        for (size_t i = 0; i < linked.size(); ++i) {
+            values.push_back(convert(linked[i], param.first, linked[i]->getParamFromName(param.first).toString(), sourceIn - targetIn[i], sourceEnd));
+            votes[values.back()]++;
+        }
+        QString definition;
+        int count = 0;
+        for (auto it = votes.cbegin(); it != votes.cend(); ++it) {
+            if (it.value() > count) {
+                count = it.value();
+                definition = it.key();
+            }
+        }
+        if (definition == value) {
+            continue;
+        }
+        for (size_t i = 0; i < linked.size(); ++i) {
+            if (values[i] != definition) {
+                continue;
+            }
+            newValues[i].append({param.first, convert(linked[i], param.first, value, targetIn[i] - sourceIn, targetEnd[i])});
+            oldValues[i].append({param.first, linked[i]->getParamFromName(param.first)});
+        }
+    }
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    std::shared_ptr<EffectItemModel> self(AssetParameterModel::shared_from_this(), this);
+    bool updated = false;
+    for (size_t i = 0; i < linked.size(); ++i) {
+        if (newValues[i].isEmpty()) {
+            continue;
+        }
+        std::shared_ptr<EffectItemModel> effect = linked[i];
+        const paramVector params = newValues[i];
+        const paramVector previous = oldValues[i];
+        Fun local_redo = [effect, params, self]() {
+            effect->setParameters(params);
+            effect->shareKeyframes(self);
+            pCore->refreshProjectItem(effect->getOwnerId());
+            pCore->invalidateItem(effect->getOwnerId());
+            return true;
+        };
+        Fun local_undo = [effect, previous]() {
+            effect->setParameters(previous);
+            effect->shareLinkedKeyframes();
+            pCore->refreshProjectItem(effect->getOwnerId());
+            pCore->invalidateItem(effect->getOwnerId());
+            return true;
+        };
+        local_redo();
+        UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+        updated = true;
+    }
+    if (updated) {
+        pCore->pushUndo(undo, redo, i18n("Update linked effects"));
+    } else {
+        pCore->displayMessage(i18n("All linked effects are up to date"), InformationMessage);
+    }
+    return true;
+}
+
+void EffectItemModel::unlinkEffect()
+{
+    const QString id = linkId();
+    if (id.isEmpty()) {
+        return;
+    }
+    Fun redo = [this]() {
+        setLinkId(QString());
+        Q_EMIT AssetParameterModel::modelChanged();
+        return true;
+    };
+    Fun undo = [this, id]() {
+        setLinkId(id);
+        Q_EMIT AssetParameterModel::modelChanged();
+        return true;
+    };
+    redo();
+    pCore->pushUndo(undo, redo, i18n("Unlink effect"));
+}
@@ -52,10 +52,27 @@ public:
     bool isValid() const;
     QPair<int, int> getInOut() const;
     void setInOut(const QString &effectName, QPair<int, int> bounds, bool enabled, bool withUndo);
+    /** @brief Returns the id shared by the linked instances of this effect, empty if the effect is not linked */
+    QString linkId() const;
+    /** @brief Link this effect to the other instances with id @param linkId, or unlink it if the id is empty */
+    void setLinkId(const QString &linkId);
+    /** @brief Returns the other instances of this linked effect that are on a clip of the active timeline */
+    std::vector<std::shared_ptr<EffectItemModel>> linkedEffects() const;
+    /** @brief Share the keyframes of @param source for the parameters that have the same keyframes */
+    void shareKeyframes(const std::shared_ptr<EffectItemModel> &source);
+    /** @brief Share the keyframes of the linked instances that have the same keyframes */
+    void shareLinkedKeyframes();
+    /** @brief Apply the parameters of this effect to all its linked instances, as one undo entry.
+        The instances whose parameters were changed from the shared definition keep these overrides.
+        Returns false if there is no other instance of this effect */
+    bool updateLinkedEffects();
+    /** @brief Make this effect independent from its linked instances, with undo */
+    void unlinkEffect();
 
 protected:
-    EffectItemModel(const QList<QVariant> &effectData, std::unique_ptr<Mlt::Properties> effect, const QDomElement &xml, const QString &effectId,
-                    const std::shared_ptr<AbstractTreeModel> &stack, bool isEnabled = true, QString originalDecimalPoint = QString());
+    EffectItemModel(const QList<QVariant> &effectData, std::unique_ptr<Mlt::Properties> effect, std::shared_ptr<const AssetDescriptor> descriptor,
+                    const QStringList &values, const QString &effectId, const std::shared_ptr<AbstractTreeModel> &stack, bool isEnabled = true,
+                    QString originalDecimalPoint = QString());
     QMap<int, std::shared_ptr<EffectItemModel>> m_childEffects;
     void updateEnable(bool updateTimeline = true) override;
     int m_childId;
@@ -12,6 +12,8 @@
 #include "macros.hpp"
 #include "mainwindow.h"
 #include "timeline2/model/timelinemodel.hpp"
+#include <QThread>
+#include <QUuid>
 #include <profiles/profilemodel.hpp>
 #include <stack>
 #include <utility>
@@ -343,6 +345,10 @@ bool EffectStackModel::fromXml(const QDomElement &effectsXml, Fun &undo, Fun &re
             if (pName == QLatin1String("in") || pName == QLatin1String("out")) {
                 continue;
             }
+            if (pName == QLatin1String("kdenlive:link_id")) {
+                effect->setLinkId(pnode.text());
+                continue;
+            }
             if (keyframeParams.contains(pName)) {
                 // This is a keyframable parameter, fix offset
                 int currentDuration = pCore->getItemDuration(m_ownerId);
@@ -393,6 +399,8 @@ bool EffectStackModel::fromXml(const QDomElement &effectsXml, Fun &undo, Fun &re
             }
         }
         local_redo();
+        // Linked instances with the same keyframes only keep one copy of them
+        effect->shareLinkedKeyframes();
         effectAdded = true;
         UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
     }
@@ -408,6 +416,35 @@ bool EffectStackModel::fromXml(const QDomElement &effectsXml, Fun &undo, Fun &re
     return effectAdded;
 }
 
+QString EffectStackModel::linkEffect(int row, const QString &assetId, Fun &undo, Fun &redo)
+{
+    if (row < 0 || row >= rootItem->childCount()) {
+        return QString();
+    }
+    std::shared_ptr<EffectItemModel> effect = std::static_pointer_cast<EffectItemModel>(rootItem->child(row));
+    if (effect->getAssetId() != assetId) {
+        return QString();
+    }
+    QString linkId = effect->linkId();
+    if (!linkId.isEmpty()) {
+        return linkId;
+    }
+    linkId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    Fun local_redo = [effect, linkId]() {
+        effect->setLinkId(linkId);
+        Q_EMIT effect->modelChanged();
+        return true;
+    };
+    Fun local_undo = [effect]() {
+        effect->setLinkId(QString());
+        Q_EMIT effect->modelChanged();
+        return true;
+    };
+    local_redo();
+    UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+    return linkId;
+}
+
 bool EffectStackModel::copyEffect(const std::shared_ptr<AbstractEffectItem> &sourceItem, PlaylistState::ClipState state, bool logUndo)
 {
     QWriteLocker locker(&m_lock);
@@ -444,6 +481,12 @@ bool EffectStackModel::copyEffect(const std::shared_ptr<AbstractEffectItem> &sou
     // TODO the parent should probably not always be the root
     Fun local_redo = addItem_lambda(effect, rootItem->getId());
     effect->prepareKeyframes();
+    // A copy of a linked effect, like each part of a cut clip, stays linked. The copy shares the keyframes until one of them is edited
+    const QString linkId = sourceEffect->linkId();
+    if (!linkId.isEmpty()) {
+        effect->setLinkId(linkId);
+    }
+    effect->shareKeyframes(sourceEffect);
     connect(effect.get(), &AssetParameterModel::modelChanged, this, &EffectStackModel::modelChanged);
     connect(effect.get(), &AssetParameterModel::replugEffect, this, &EffectStackModel::replugEffect, Qt::DirectConnection);
     connect(effect.get(), &AssetParameterModel::showEffectZone, this, &EffectStackModel::updateEffectZones);
@@ -1006,16 +1049,65 @@ bool EffectStackModel::importEffects(const std::shared_ptr<EffectStackModel> &so
 
 void EffectStackModel::importEffects(const std::weak_ptr<Mlt::Service> &service, PlaylistState::ClipState state, bool alreadyExist,
                                      const QString &originalDecimalPoint, const QUuid &uuid)
+{
+    QWriteLocker locker(&m_lock);
+    insertEffects(service, buildEffects(service, alreadyExist, originalDecimalPoint), state, alreadyExist, uuid);
+}
+
+std::vector<EffectStackModel::BuiltEffect> EffectStackModel::buildEffects(const std::weak_ptr<Mlt::Service> &service, bool alreadyExist,
+                                                                          const QString &originalDecimalPoint)
+{
+    std::vector<BuiltEffect> effects;
+    auto ptr = service.lock();
+    if (!ptr) {
+        return effects;
+    }
+    int max = ptr->filter_count();
+    effects.reserve(size_t(max));
+    for (int i = 0; i < max; i++) {
+        std::unique_ptr<Mlt::Filter> filter(ptr->filter(i));
+        if (filter->get_int("internal_added") > 0 && m_ownerId.first != ObjectType::TimelineTrack) {
+            // Handled on insertion, required to load master audio effects
+            effects.push_back({std::move(filter), nullptr, QString()});
+            continue;
+        }
+        if (!filter->property_exists("kdenlive_id")) {
+            // don't consider internal MLT stuff
+            continue;
+        }
+        const QString effectId = qstrdup(filter->get("kdenlive_id"));
+        // The MLT filter already exists, use it directly to create the effect
+        std::shared_ptr<EffectItemModel> effect;
+        if (alreadyExist) {
+            // effect is already plugged in the service
+            effect = EffectItemModel::construct(std::move(filter), shared_from_this(), originalDecimalPoint);
+        } else {
+            // duplicate effect
+            std::unique_ptr<Mlt::Filter> asset = EffectsRepository::get()->getEffect(effectId);
+            asset->inherit(*(filter));
+            effect = EffectItemModel::construct(std::move(asset), shared_from_this(), originalDecimalPoint);
+        }
+        effect->prepareKeyframes();
+        if (QThread::currentThread() != thread()) {
+            // Built on a worker thread, hand the models over to the stack's thread
+            effect->moveModelToThread(thread());
+        }
+        effects.push_back({nullptr, effect, effectId});
+    }
+    return effects;
+}
+
+void EffectStackModel::insertEffects(const std::weak_ptr<Mlt::Service> &service, std::vector<BuiltEffect> effects, PlaylistState::ClipState state,
+                                     bool alreadyExist, const QUuid &uuid)
 {
     QWriteLocker locker(&m_lock);
     m_loadingExisting = alreadyExist;
     bool effectEnabled = true;
     if (auto ptr = service.lock()) {
-        int max = ptr->filter_count();
         int imported = 0;
-        for (int i = 0; i < max; i++) {
-            std::unique_ptr<Mlt::Filter> filter(ptr->filter(i));
-            if (filter->get_int("internal_added") > 0 && m_ownerId.first != ObjectType::TimelineTrack) {
+        for (BuiltEffect &built : effects) {
+            if (!built.effect) {
+                std::unique_ptr<Mlt::Filter> filter = std::move(built.filter);
                 // Required to load master audio effects
                 if (m_ownerId.first == ObjectType::Master && filter->get("mlt_service") == QLatin1String("avfilter.subtitles")) {
                     // A subtitle filter, update project
@@ -1033,29 +1125,15 @@ void EffectStackModel::importEffects(const std::weak_ptr<Mlt::Service> &service,
                 }
                 continue;
             }
-            if (!filter->property_exists("kdenlive_id")) {
-                // don't consider internal MLT stuff
-                continue;
-            }
-            const QString effectId = qstrdup(filter->get("kdenlive_id"));
+            const QString &effectId = built.effectId;
+            std::shared_ptr<EffectItemModel> effect = built.effect;
             if (m_ownerId.first == ObjectType::TimelineClip && EffectsRepository::get()->isUnique(effectId) && hasEffect(effectId)) {
                 pCore->displayMessage(i18n("Effect %1 cannot be added twice.", EffectsRepository::get()->getName(effectId)), ErrorMessage);
                 continue;
             }
-            if (filter->get_int("disable") == 0) {
+            if (effect->filter().get_int("disable") == 0) {
                 effectEnabled = true;
             }
-            // The MLT filter already exists, use it directly to create the effect
-            std::shared_ptr<EffectItemModel> effect;
-            if (alreadyExist) {
-                // effect is already plugged in the service
-                effect = EffectItemModel::construct(std::move(filter), shared_from_this(), originalDecimalPoint);
-            } else {
-                // duplicate effect
-                std::unique_ptr<Mlt::Filter> asset = EffectsRepository::get()->getEffect(effectId);
-                asset->inherit(*(filter));
-                effect = EffectItemModel::construct(std::move(asset), shared_from_this(), originalDecimalPoint);
-            }
             if (state == PlaylistState::VideoOnly) {
                 if (effect->isAudio()) {
                     // Don't import effect
@@ -1072,7 +1150,6 @@ void EffectStackModel::importEffects(const std::weak_ptr<Mlt::Service> &service,
             connect(effect.get(), &AssetParameterModel::replugEffect, this, &EffectStackModel::replugEffect, Qt::DirectConnection);
             connect(effect.get(), &AssetParameterModel::showEffectZone, this, &EffectStackModel::updateEffectZones);
             Fun redo = addItem_lambda(effect, rootItem->getId());
-            effect->prepareKeyframes();
             if (redo()) {
                 if (effectId.startsWith(QLatin1String("fadein")) || effectId.startsWith(QLatin1String("fade_from_"))) {
                     m_fadeIns.insert(effect->getId());
@@ -1093,6 +1170,7 @@ void EffectStackModel::importEffects(const std::weak_ptr<Mlt::Service> &service,
                         effect->filter().set("out", clipOut);
                     }
                 }
+                effect->shareLinkedKeyframes();
             }
         }
         if (imported == 0) {
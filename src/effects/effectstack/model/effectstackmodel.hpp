@@ -14,6 +14,7 @@
 #include <memory>
 #include <mlt++/Mlt.h>
 #include <unordered_set>
+#include <vector>
 
 /** @brief This class an effect stack as viewed by the back-end.
    It is responsible for planting and managing effects into the list of producer it holds a pointer to.
@@ -53,6 +54,21 @@ public:
     bool importEffects(const std::shared_ptr<EffectStackModel> &sourceStack, PlaylistState::ClipState state);
     void importEffects(const std::weak_ptr<Mlt::Service> &service, PlaylistState::ClipState state, bool alreadyExist = false,
                        const QString &originalDecimalPoint = QString(), const QUuid &uuid = QUuid());
+    /** @brief An effect model built from one of the filters of a service, not yet inserted in the stack.
+     *  Internal filters that must be handled on insertion have no model. */
+    struct BuiltEffect
+    {
+        std::unique_ptr<Mlt::Filter> filter;
+        std::shared_ptr<EffectItemModel> effect;
+        QString effectId;
+    };
+    /** @brief Build the effect models of the filters of @param service, without modifying the stack.
+     *  This is the expensive part of importEffects, it can run on a worker thread as long as the GUI thread waits for it;
+     *  the built models are then moved to the thread of the stack. */
+    std::vector<BuiltEffect> buildEffects(const std::weak_ptr<Mlt::Service> &service, bool alreadyExist, const QString &originalDecimalPoint);
+    /** @brief Insert the effects returned by buildEffects in the stack, must be called from the thread of the stack */
+    void insertEffects(const std::weak_ptr<Mlt::Service> &service, std::vector<BuiltEffect> effects, PlaylistState::ClipState state, bool alreadyExist,
+                       const QUuid &uuid = QUuid());
     bool removeFade(bool fromStart);
 
     /** @brief This function change the global (timeline-wise) enabled state of the effects
@@ -124,6 +140,9 @@ public:
     QDomElement rowToXml(const QUuid &uuid, int row, QDomDocument &document);
     /** @brief Load an effect stack from an XML representation */
     bool fromXml(const QDomElement &effectsXml, Fun &undo, Fun &redo);
+    /** @brief Returns the link id of the effect at @param row if its asset is @param assetId, linking it first if needed.
+        Returns an empty string if there is no such effect */
+    QString linkEffect(int row, const QString &assetId, Fun &undo, Fun &redo);
     /** @brief Delete active effect from stack */
     void removeCurrentEffect();
 
@@ -92,6 +92,26 @@ CollapsibleEffectView::CollapsibleEffectView(const std::shared_ptr<EffectItemMod
     title = new KSqueezedTextLabel(this);
     l->insertWidget(2, title);
 
+    // Linked effect menu
+    m_linkButton = new QToolButton(this);
+    m_linkButton->setIcon(QIcon::fromTheme(QStringLiteral("edit-link")));
+    m_linkButton->setAutoRaise(true);
+    m_linkButton->setPopupMode(QToolButton::InstantPopup);
+    m_linkButton->setToolTip(i18n("Linked effect"));
+    m_linkButton->setWhatsThis(xi18nc("@info:whatsthis", "This effect was pasted as a linked effect. Opens a menu to apply its parameters to all the "
+                                                         "linked clips, or to unlink it."));
+    auto *linkMenu = new QMenu(this);
+    linkMenu->addAction(QIcon::fromTheme(QStringLiteral("view-refresh")), i18n("Update All Linked Effects"), this, [this]() {
+        if (!m_model->updateLinkedEffects()) {
+            pCore->displayMessage(i18n("No other linked effect in the timeline"), InformationMessage, 500);
+        }
+    });
+    linkMenu->addAction(QIcon::fromTheme(QStringLiteral("remove-link")), i18n("Unlink Effect"), this, [this]() { m_model->unlinkEffect(); });
+    m_linkButton->setMenu(linkMenu);
+    m_linkButton->setVisible(!m_model->linkId().isEmpty());
+    l->insertWidget(3, m_linkButton);
+    connect(m_model.get(), &AssetParameterModel::modelChanged, this, [this]() { m_linkButton->setVisible(!m_model->linkId().isEmpty()); });
+
     keyframesButton->setIcon(QIcon::fromTheme(QStringLiteral("keyframe")));
     keyframesButton->setCheckable(true);
     keyframesButton->setToolTip(i18n("Enable Keyframes"));
@@ -13,6 +13,7 @@
 #include <memory>
 
 class QLabel;
+class QToolButton;
 class KDualAction;
 class KSqueezedTextLabel;
 class EffectItemModel;
@@ -127,6 +128,8 @@ private:
     KDualAction *m_keyframesButton;
     QAction *m_inOutButton;
     QLabel *m_colorIcon;
+    /** @brief Shown when the effect is linked to other clips, its menu updates or unlinks them */
+    QToolButton *m_linkButton;
     QPixmap m_iconPix;
     QPoint m_dragStart;
     TimecodeDisplay *m_inPos;
@@ -59,6 +59,8 @@ AbstractTask::AbstractTask(const ObjectId &owner, JOBTYPE type, QObject *object)
     case AbstractTask::STABILIZEJOB:
     case AbstractTask::ANALYSECLIPJOB:
     case AbstractTask::SPEEDJOB:
+    case AbstractTask::LOUDNESSJOB:
+    case AbstractTask::SILENCEJOB:
         m_priority = 5;
         break;
     default:
@@ -90,6 +92,22 @@ bool AbstractTask::operator==(const AbstractTask &b)
     return m_owner == b.ownerId();
 }
 
+void AbstractTask::addProgressStep(int total)
+{
+    // Like a sequential loop, report the steps started so far: 100 is only set once the task is done
+    const int started = m_progressSteps.fetchAndAddRelaxed(1);
+    const int value = qMin(99, int(100. * started / qMax(1, total)));
+    // Concurrent workers may finish their steps in any order, never move the progress back
+    int current = m_progress.loadRelaxed();
+    while (value > current) {
+        if (m_progress.testAndSetRelaxed(current, value)) {
+            QMetaObject::invokeMethod(m_object, "updateJobProgress");
+            return;
+        }
+        current = m_progress.loadRelaxed();
+    }
+}
+
 void AbstractTask::run()
 {
     qDebug() << "============0\n\nABSTRACT TASKSTARTRING\n\n==================";
@@ -32,7 +32,10 @@ public:
         LOADJOB = 8,
         AUDIOTHUMBJOB = 9,
         SPEEDJOB = 10,
-        CACHEJOB = 11
+        CACHEJOB = 11,
+        LOUDNESSJOB = 12,
+        EFFECTCOSTJOB = 13,
+        SILENCEJOB = 14
     };
     AbstractTask(const ObjectId &owner, JOBTYPE type, QObject* object);
     ~AbstractTask() override;
@@ -44,7 +47,8 @@ public:
 protected:
     ObjectId m_owner;
     QObject* m_object;
-    int m_progress;
+    /** @brief Written by the task thread, read by the task manager from other threads */
+    QAtomicInt m_progress;
     QString m_description;
     bool m_successful;
     QAtomicInt m_isCanceled;
@@ -55,11 +59,15 @@ protected:
     QUuid m_uuid;
     void run() override;
     void cleanup();
+    /** @brief Count one more step started out of @param total and update the progress,
+     *  can be called from several worker threads of the same task */
+    void addProgressStep(int total);
 
 private:
     //QString cacheKey();
     JOBTYPE m_type;
     int m_priority;
+    QAtomicInt m_progressSteps;
     void cancelJob(bool softDelete = false);
 
 Q_SIGNALS:
@@ -6,9 +6,11 @@
 */
 
 #include "audiolevelstask.h"
+#include "audio/audioReader.h"
 #include "audio/audioStreamInfo.h"
 #include "bin/projectclip.h"
 #include "bin/projectitemmodel.h"
+#include "capture/mediacapture.h"
 #include "core.h"
 
 #include <KLocalizedString>
@@ -23,6 +25,7 @@
 #include <QThreadPool>
 #include <QTime>
 #include <QVariantList>
+#include <cmath>
 
 static QList<AudioLevelsTask *> tasksList;
 static QMutex tasksListMutex;
@@ -32,6 +35,33 @@ static void deleteQVariantList(QVector<uint8_t> *list)
     delete list;
 }
 
+double AudioLevelsTask::audioLevel(const qint16 *samples, int count, int stride)
+{
+    double sum = 0.;
+    for (int i = 0; i < count; ++i) {
+        double value = samples[i * stride] / 32768.;
+        sum += value * value;
+    }
+    double rms = std::sqrt(sum / qMax(1, count));
+    double dB = rms > 0. ? 20. * std::log10(rms) : -100.;
+    if (dB < -70.) {
+        return 0.;
+    } else if (dB < -60.) {
+        return (dB + 70.) * 0.0025;
+    } else if (dB < -50.) {
+        return (dB + 60.) * 0.005 + 0.025;
+    } else if (dB < -40.) {
+        return (dB + 50.) * 0.0075 + 0.075;
+    } else if (dB < -30.) {
+        return (dB + 40.) * 0.015 + 0.15;
+    } else if (dB < -20.) {
+        return (dB + 30.) * 0.02 + 0.3;
+    } else if (dB < -0.001 || dB > 0.001) {
+        return (dB + 20.) * 0.025 + 0.5;
+    }
+    return 1.;
+}
+
 AudioLevelsTask::AudioLevelsTask(const ObjectId &owner, QObject *object)
     : AbstractTask(owner, AbstractTask::AUDIOTHUMBJOB, object)
 {
@@ -92,8 +122,9 @@ void AudioLevelsTask::run()
 
     QMap<int, QString> streams = binClip->audioInfo()->streams();
     QMap<int, int> audioChannels = binClip->audioInfo()->streamChannels();
+    // The streams that need to be analysed, with their channel count
+    QMap<int, int> toCompute;
     QMapIterator<int, QString> st(streams);
-    bool audioCreated = false;
     while (st.hasNext() && !m_isCanceled) {
         st.next();
         int stream = st.key();
@@ -102,12 +133,12 @@ void AudioLevelsTask::run()
         }
         // Generate one thumb per stream
         QString cachePath = binClip->getAudioThumbPath(stream);
-        QVector<uint8_t> mltLevels;
         if (!m_isForce && QFile::exists(cachePath)) {
             // Audio thumb already exists
             QImage image(cachePath);
             if (!m_isCanceled && !image.isNull()) {
                 // convert cached image
+                QVector<uint8_t> mltLevels;
                 int n = image.width() * image.height();
                 for (int i = 0; n > 1 && i < n; i++) {
                     QRgb p = image.pixel(i / channels, i % channels);
@@ -117,130 +148,151 @@ void AudioLevelsTask::run()
                     mltLevels << qAlpha(p);
                 }
                 if (mltLevels.size() > 0) {
-                    QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(mltLevels);
-                    producer->lock();
-                    QString key = QString("_kdenlive:audio%1").arg(stream);
-                    producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
-                    producer->unlock();
+                    publishLevels(producer, stream, mltLevels);
                     continue;
                 }
             }
         }
-        QString service = producer->get("mlt_service");
-        if (service == QLatin1String("avformat-novalidate")) {
-            service = QStringLiteral("avformat");
-        } else if (service.startsWith(QLatin1String("xml"))) {
-            service = QStringLiteral("xml-nogl");
+        toCompute.insert(stream, channels);
+    }
+    bool audioCreated = false;
+    if (toCompute.size() == 1 && !m_isCanceled) {
+        // A clip we just recorded, its levels were computed during the capture
+        QVector<uint8_t> recordedLevels;
+        int recordedChannels = 0;
+        int recordedMax = 0;
+        if (pCore->getAudioDevice()->takeRecordedLevels(binClip->url(), recordedLevels, recordedChannels, recordedMax) &&
+            recordedChannels == toCompute.first()) {
+            audioCreated = saveLevels(binClip, producer, toCompute.firstKey(), recordedLevels, recordedChannels, recordedMax);
+            if (audioCreated) {
+                toCompute.clear();
+                QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
+            }
         }
-        const QString res = qstrdup(producer->get("resource"));
-        Mlt::Producer *aProd = new Mlt::Producer(producer->get_profile(), service.toUtf8().constData(), res.toUtf8().constData());
-        if (!aProd->is_valid()) {
-            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Audio thumbs: cannot open file %1", res)),
+    }
+    if (!toCompute.isEmpty() && !m_isCanceled) {
+        QMutex resultMutex;
+        bool opened = AudioReader::decodeStreams(*producer.get(), toCompute, frequency, lengthInFrames,
+                                                 [&](AudioReader &reader, const QMap<int, int> &streamChannels, int totalFrames) {
+                                                     bool created = computeLevels(reader, producer, streamChannels, lengthInFrames, totalFrames);
+                                                     QMutexLocker lk(&resultMutex);
+                                                     audioCreated = audioCreated || created;
+                                                 });
+        if (!opened) {
+            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                      Q_ARG(QString, i18n("Audio thumbs: cannot open file %1", QFileInfo(binClip->url()).fileName())),
                                       Q_ARG(int, int(KMessageWidget::Warning)));
-            delete aProd;
-            return;
         }
-        aProd->set("video_index", "-1");
-        aProd->set("audio_index", stream);
-        Mlt::Filter chans(producer->get_profile(), "audiochannels");
-        Mlt::Filter converter(producer->get_profile(), "audioconvert");
-        Mlt::Filter levels(producer->get_profile(), "audiolevel");
-        aProd->attach(chans);
-        aProd->attach(converter);
-        aProd->attach(levels);
-        std::unique_ptr<Mlt::Producer> audioProducer;
-        audioProducer.reset(aProd);
+    }
+    if (m_isCanceled) {
+        m_progress = 100;
+    }
+    if (!audioCreated && !m_isCanceled) {
+        // Audio was cached, ensure the bin thumbnail is loaded
+        QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, true));
+    }
+    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+}
 
-        double framesPerSecond = audioProducer->get_fps();
-        mlt_audio_format audioFormat = mlt_audio_s16;
-        QStringList keys;
-        keys.reserve(channels);
-        for (int i = 0; i < channels; i++) {
-            keys << "meta.media.audio_level." + QString::number(i);
-        }
-        uint maxLevel = 1;
-        QElapsedTimer updateTime;
-        updateTime.start();
-        for (int z = 0; z < lengthInFrames && !m_isCanceled; ++z) {
-            int val = int(100.0 * z / lengthInFrames);
-            if (m_progress != val) {
-                m_progress = val;
-                QMetaObject::invokeMethod(m_object, "updateJobProgress");
-            }
-            QScopedPointer<Mlt::Frame> mltFrame(audioProducer->get_frame());
-            if ((mltFrame != nullptr) && mltFrame->is_valid() && (mltFrame->get_int("test_audio") == 0)) {
-                int samples = mlt_audio_calculate_frame_samples(float(framesPerSecond), frequency, z);
-                mltFrame->get_audio(audioFormat, frequency, channels, samples);
-                for (int channel = 0; channel < channels; ++channel) {
-                    uint lev = 256 * qMin(mltFrame->get_double(keys.at(channel).toUtf8().constData()) * 0.9, 1.0);
-                    mltLevels << lev;
-                    // double lev = mltFrame->get_double(keys.at(channel).toUtf8().constData());
-                    // mltLevels << lev;
-                    maxLevel = qMax(lev, maxLevel);
+void AudioLevelsTask::publishLevels(const std::shared_ptr<Mlt::Producer> &producer, int stream, const QVector<uint8_t> &levels, int maxLevel)
+{
+    QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(levels);
+    producer->lock();
+    QString key = QString("_kdenlive:audio%1").arg(stream);
+    if (maxLevel > -1) {
+        QString key2 = QString("kdenlive:audio_max%1").arg(stream);
+        producer->set(key2.toUtf8().constData(), maxLevel);
+    }
+    producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
+    producer->unlock();
+}
+
+bool AudioLevelsTask::computeLevels(AudioReader &reader, const std::shared_ptr<Mlt::Producer> &producer, const QMap<int, int> &streams, int lengthInFrames,
+                                    int totalFrames)
+{
+    auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.second));
+    if (binClip == nullptr) {
+        return false;
+    }
+    int totalChannels = 0;
+    for (int channels : streams) {
+        totalChannels += channels;
+    }
+    // 2 channels interleaved of uchar values
+    QMap<int, QVector<uint8_t>> mltLevels;
+    QMap<int, uint> maxLevel;
+    std::vector<qint16> samples;
+    QElapsedTimer updateTime;
+    updateTime.start();
+    for (int z = 0; z < lengthInFrames && !m_isCanceled; ++z) {
+        addProgressStep(totalFrames);
+        int count = reader.readFrame(samples);
+        int firstChannel = 0;
+        for (auto it = streams.cbegin(); it != streams.cend(); ++it) {
+            QVector<uint8_t> &levels = mltLevels[it.key()];
+            uint &max = maxLevel[it.key()];
+            max = qMax(max, 1u);
+            if (count > 0) {
+                for (int channel = 0; channel < it.value(); ++channel) {
+                    uint lev = 256 * qMin(audioLevel(samples.data() + firstChannel + channel, count, totalChannels) * 0.9, 1.0);
+                    levels << lev;
+                    max = qMax(lev, max);
                 }
-            } else if (!mltLevels.isEmpty()) {
-                for (int channel = 0; channel < channels; channel++) {
-                    mltLevels << mltLevels.last();
+            } else if (!levels.isEmpty()) {
+                for (int channel = 0; channel < it.value(); channel++) {
+                    levels << levels.last();
                 }
             }
-            // Incrementally update the audio levels every 3 seconds.
-            if (updateTime.elapsed() > 3000 && !m_isCanceled) {
-                updateTime.restart();
-                QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(mltLevels);
-                producer->lock();
-                QString key = QString("_kdenlive:audio%1").arg(stream);
-                producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
-                producer->unlock();
-                QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
-            }
+            firstChannel += it.value();
         }
-
-        /*// Normalize
-        for (double &v : mltLevels) {
-            m_audioLevels << uchar(255 * v / maxLevel);
-        }*/
-        if (m_isCanceled) {
-            mltLevels.clear();
-            m_progress = 100;
-            QMetaObject::invokeMethod(m_object, "updateJobProgress");
-        }
-        if (mltLevels.size() > 0) {
-            QVector<uint8_t> *levelsCopy = new QVector<uint8_t>(mltLevels);
-            producer->lock();
-            QString key = QString("_kdenlive:audio%1").arg(stream);
-            QString key2 = QString("kdenlive:audio_max%1").arg(stream);
-            producer->set(key2.toUtf8().constData(), int(maxLevel));
-            producer->set(key.toUtf8().constData(), levelsCopy, 0, (mlt_destructor)deleteQVariantList);
-            producer->unlock();
-            // qDebug()<<"=== FINISHED PRODUCING AUDIO FOR: "<<key<<", SIZE: "<<levelsCopy->size();
-            m_progress = 100;
-            QMetaObject::invokeMethod(m_object, "updateJobProgress");
-            // Put into an image for caching.
-            int count = mltLevels.size();
-            QImage image((count + 3) / 4 / channels, channels, QImage::Format_ARGB32);
-            int n = image.width() * image.height();
-            for (int i = 0; i < n; i++) {
-                QRgb p;
-                if ((4 * i + 3) < count) {
-                    p = qRgba(mltLevels.at(4 * i), mltLevels.at(4 * i + 1), mltLevels.at(4 * i + 2), mltLevels.at(4 * i + 3));
-                } else {
-                    int last = mltLevels.last();
-                    int r = (4 * i + 0) < count ? mltLevels.at(4 * i + 0) : last;
-                    int g = (4 * i + 1) < count ? mltLevels.at(4 * i + 1) : last;
-                    int b = (4 * i + 2) < count ? mltLevels.at(4 * i + 2) : last;
-                    int a = last;
-                    p = qRgba(r, g, b, a);
-                }
-                image.setPixel(i / channels, i % channels, p);
+        // Incrementally update the audio levels every 3 seconds.
+        if (updateTime.elapsed() > 3000 && !m_isCanceled) {
+            updateTime.restart();
+            for (auto it = mltLevels.cbegin(); it != mltLevels.cend(); ++it) {
+                publishLevels(producer, it.key(), it.value());
             }
-            image.save(cachePath);
-            audioCreated = true;
             QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
         }
     }
-    if (!audioCreated && !m_isCanceled) {
-        // Audio was cached, ensure the bin thumbnail is loaded
-        QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, true));
+    reader.close();
+    if (m_isCanceled) {
+        return false;
     }
-    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+    bool created = false;
+    for (auto it = mltLevels.cbegin(); it != mltLevels.cend(); ++it) {
+        created = saveLevels(binClip, producer, it.key(), it.value(), streams.value(it.key()), int(maxLevel.value(it.key()))) || created;
+    }
+    if (created) {
+        QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
+    }
+    return created;
+}
+
+bool AudioLevelsTask::saveLevels(const std::shared_ptr<ProjectClip> &binClip, const std::shared_ptr<Mlt::Producer> &producer, int stream,
+                                 const QVector<uint8_t> &levels, int channels, int maxLevel)
+{
+    if (levels.isEmpty() || channels <= 0) {
+        return false;
+    }
+    publishLevels(producer, stream, levels, maxLevel);
+    // Put into an image for caching.
+    int count = levels.size();
+    QImage image((count + 3) / 4 / channels, channels, QImage::Format_ARGB32);
+    int n = image.width() * image.height();
+    for (int i = 0; i < n; i++) {
+        QRgb p;
+        if ((4 * i + 3) < count) {
+            p = qRgba(levels.at(4 * i), levels.at(4 * i + 1), levels.at(4 * i + 2), levels.at(4 * i + 3));
+        } else {
+            int last = levels.last();
+            int r = (4 * i + 0) < count ? levels.at(4 * i + 0) : last;
+            int g = (4 * i + 1) < count ? levels.at(4 * i + 1) : last;
+            int b = (4 * i + 2) < count ? levels.at(4 * i + 2) : last;
+            int a = last;
+            p = qRgba(r, g, b, a);
+        }
+        image.setPixel(i / channels, i % channels, p);
+    }
+    image.save(binClip->getAudioThumbPath(stream));
+    return true;
 }
@@ -10,16 +10,39 @@
 
 #include "abstracttask.h"
 
-#include <QRunnable>
+#include <QMap>
 #include <QObject>
+#include <QRunnable>
+#include <QVector>
+#include <memory>
+
+class AudioReader;
+class ProjectClip;
+namespace Mlt {
+class Producer;
+}
 
 class AudioLevelsTask : public AbstractTask
 {
 public:
     AudioLevelsTask(const ObjectId &owner, QObject* object);
     static void start(const ObjectId &owner, QObject* object, bool force = false);
+    /** @brief The level of channel samples (RMS on the IEC scale, like MLT's audiolevel filter) for the audio thumbnails,
+        from @param count samples at @param samples separated by @param stride */
+    static double audioLevel(const qint16 *samples, int count, int stride);
+    /** @brief Make the levels of a stream with @param channels channels available to the audio thumbnails and write them to the cache */
+    static bool saveLevels(const std::shared_ptr<ProjectClip> &binClip, const std::shared_ptr<Mlt::Producer> &producer, int stream,
+                           const QVector<uint8_t> &levels, int channels, int maxLevel);
 
 protected:
     void run() override;
 
+private:
+    /** @brief Compute the levels of all @param streams {stream index, channels} decoded by @param reader, returns true if a thumbnail was created.
+        @param totalFrames is the number of frames decoded by all concurrent calls, for the task progress */
+    bool computeLevels(AudioReader &reader, const std::shared_ptr<Mlt::Producer> &producer, const QMap<int, int> &streams, int lengthInFrames,
+                       int totalFrames);
+    /** @brief Make the (possibly partial) levels of a stream available to the audio thumbnails */
+    static void publishLevels(const std::shared_ptr<Mlt::Producer> &producer, int stream, const QVector<uint8_t> &levels, int maxLevel = -1);
+
 };
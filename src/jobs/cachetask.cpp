@@ -47,19 +47,25 @@ void CacheTask::start(const ObjectId &owner, int thumbsCount, int in, int out, Q
     pCore->taskManager.startTask(owner.second, task);
 }
 
+std::set<int> CacheTask::thumbnailFrames(int in, int duration, int thumbsCount)
+{
+    std::set<int> frames;
+    int steps = qCeil(qMax(pCore->getCurrentFps(), double(duration) / thumbsCount));
+    int pos = in;
+    for (int i = 1; i <= thumbsCount && pos <= in + duration; ++i) {
+        frames.insert(pos);
+        pos = in + (steps * i);
+    }
+    return frames;
+}
+
 void CacheTask::generateThumbnail(std::shared_ptr<ProjectClip> binClip)
 {
     // Fetch thumbnail
     if (binClip->clipType() != ClipType::Audio) {
         std::shared_ptr<Mlt::Producer> thumbProd(nullptr);
         int duration = m_out > 0 ? m_out - m_in : binClip->getFramePlaytime();
-        std::set<int> frames;
-        int steps = qCeil(qMax(pCore->getCurrentFps(), double(duration) / m_thumbsCount));
-        int pos = m_in;
-        for (int i = 1; i <= m_thumbsCount && pos <= m_in + duration; ++i) {
-            frames.insert(pos);
-            pos = m_in + (steps * i);
-        }
+        std::set<int> frames = thumbnailFrames(m_in, duration, m_thumbsCount);
         int size = int(frames.size());
         int count = 0;
         const QString clipId = QString::number(m_owner.second);
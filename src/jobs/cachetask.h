@@ -16,6 +16,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QDomElement>
 #include <QObject>
 #include <QList>
+#include <set>
 
 class ProjectClip;
 
@@ -25,6 +26,8 @@ public:
     CacheTask(const ObjectId &owner, int thumbsCount, int in, int out, QObject* object);
     ~CacheTask() override;
     static void start(const ObjectId &owner, int thumbsCount = 30, int in = 0, int out = 0, QObject* object = nullptr, bool force = false);
+    /** @brief The frames cached for a zone of @param duration frames starting at @param in */
+    static std::set<int> thumbnailFrames(int in, int duration, int thumbsCount);
 
 protected:
     void run() override;
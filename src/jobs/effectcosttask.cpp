@@ -0,0 +1,130 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "effectcosttask.h"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "effects/effectstack/model/effectstackmodel.hpp"
+#include "mainwindow.h"
+#include "timeline2/view/timelinecontroller.h"
+#include "timeline2/view/timelinewidget.h"
+
+#include <KLocalizedString>
+#include <KMessageWidget>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <mlt++/Mlt.h>
+
+// Number of runs of consecutive frames rendered over the clip duration
+static const int sampleRuns = 4;
+// The first frame of each run also measures the seek in the source, it is not counted
+static const int framesPerRun = 6;
+
+EffectCostTask::EffectCostTask(const ObjectId &owner, const QUuid &timelineUuid, const QString &binId, int in, int out, QObject *object)
+    : AbstractTask(owner, AbstractTask::EFFECTCOSTJOB, object)
+    , m_timelineUuid(timelineUuid)
+    , m_binId(binId)
+    , m_inPoint(in)
+    , m_outPoint(out)
+{
+    m_description = i18n("Measuring effect cost");
+}
+
+void EffectCostTask::start(const ObjectId &owner, const QUuid &timelineUuid, const QString &binId, int in, int out, QObject *object)
+{
+    if (pCore->taskManager.hasPendingJob(owner, AbstractTask::EFFECTCOSTJOB)) {
+        return;
+    }
+    auto *task = new EffectCostTask(owner, timelineUuid, binId, in, out, object);
+    pCore->taskManager.startTask(owner.second, task);
+}
+
+void EffectCostTask::run()
+{
+    AbstractTaskDone whenFinished(m_owner.second, this);
+    if (m_isCanceled || pCore->taskManager.isBlocked()) {
+        return;
+    }
+    QMutexLocker lock(&m_runMutex);
+    m_running = true;
+    auto binClip = pCore->projectItemModel()->getClipByBinID(m_binId);
+    std::shared_ptr<EffectStackModel> stack = pCore->getItemEffectStack(m_timelineUuid, int(m_owner.first), m_owner.second);
+    if (binClip == nullptr || stack == nullptr) {
+        return;
+    }
+    Mlt::Profile &profile = pCore->getProjectProfile();
+    std::unique_ptr<Mlt::Producer> bare = binClip->getClone();
+    std::unique_ptr<Mlt::Producer> source = binClip->getClone();
+    if (!bare || !bare->is_valid() || !source || !source->is_valid()) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                  Q_ARG(QString, i18n("Effect cost: cannot open file %1", QFileInfo(binClip->url()).fileName())),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
+        return;
+    }
+    // The timeline filters may be in use by the playback, render copies of them
+    stack->passEffects(source.get());
+    Mlt::Consumer c(profile, "xml", "string");
+    c.set("time_format", "frames");
+    c.set("no_meta", 1);
+    c.set("no_profile", 1);
+    c.set("store", "kdenlive");
+    c.set("no_root", 1);
+    c.set("root", "/");
+    c.connect(*source.get());
+    c.run();
+    const QByteArray xml = c.get("string");
+    source.reset();
+    Mlt::Producer effected(profile, "xml-string", xml.constData());
+    if (!effected.is_valid()) {
+        return;
+    }
+    const double bareMs = measure(*bare.get(), profile, 0);
+    const double effectedMs = bareMs < 0 ? -1 : measure(effected, profile, 50);
+    if (effectedMs < 0) {
+        return;
+    }
+    const double cost = effectedMs * pCore->getCurrentFps() / 1000.;
+    const double effectsMs = qMax(0., effectedMs - bareMs);
+    const QUuid uuid = m_timelineUuid;
+    const int cid = m_owner.second;
+    QMetaObject::invokeMethod(qApp, [uuid, cid, cost, effectsMs] {
+        TimelineWidget *timeline = pCore->window()->getTimeline(uuid);
+        if (timeline) {
+            timeline->controller()->setEffectCost(cid, cost, effectsMs);
+        }
+    });
+}
+
+double EffectCostTask::measure(Mlt::Producer &producer, Mlt::Profile &profile, int progressOffset)
+{
+    const int length = m_outPoint - m_inPoint + 1;
+    const int runs = qBound(1, length / framesPerRun, sampleRuns);
+    qint64 elapsed = 0;
+    int count = 0;
+    for (int i = 0; i < runs; ++i) {
+        int start = m_inPoint + (runs > 1 ? i * (length - framesPerRun) / (runs - 1) : 0);
+        for (int j = 0; j < framesPerRun && start + j <= m_outPoint; ++j) {
+            if (m_isCanceled) {
+                return -1;
+            }
+            producer.seek(start + j);
+            QElapsedTimer timer;
+            timer.start();
+            std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+            mlt_image_format format = mlt_image_yuv422;
+            int width = profile.width();
+            int height = profile.height();
+            frame->get_image(format, width, height);
+            if (j > 0 || framesPerRun > length) {
+                elapsed += timer.nsecsElapsed();
+                ++count;
+            }
+        }
+        m_progress = progressOffset + 50 * (i + 1) / runs;
+    }
+    return count > 0 ? elapsed / 1000000. / count : 0.;
+}
@@ -0,0 +1,39 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "abstracttask.h"
+
+namespace Mlt {
+class Producer;
+class Profile;
+}
+
+/** @class EffectCostTask
+    @brief Estimates the playback cost of the effect stack of a timeline clip.
+    A few runs of frames spread over the clip are rendered with and without the clip effects.
+    The result, expressed as a ratio of the frame duration, is sent to the timeline which flags
+    the clips that cannot play in real time and offers to render them in the timeline preview.
+ */
+class EffectCostTask : public AbstractTask
+{
+public:
+    EffectCostTask(const ObjectId &owner, const QUuid &timelineUuid, const QString &binId, int in, int out, QObject *object);
+    /** @brief Measure the effects of the timeline clip @param owner, using the bin clip @param binId between @param in and @param out */
+    static void start(const ObjectId &owner, const QUuid &timelineUuid, const QString &binId, int in, int out, QObject *object);
+
+protected:
+    void run() override;
+
+private:
+    QUuid m_timelineUuid;
+    QString m_binId;
+    int m_inPoint;
+    int m_outPoint;
+    /** @brief Returns the average rendering time of a frame of @param producer in ms, -1 if canceled.
+        This measurement covers half of the task progress, starting at @param progressOffset */
+    double measure(Mlt::Producer &producer, Mlt::Profile &profile, int progressOffset);
+};
@@ -0,0 +1,209 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "loudnesstask.h"
+#include "audio/audioReader.h"
+#include "audio/audioStreamInfo.h"
+#include "audio/loudnessMeter.h"
+#include "bin/bin.h"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+
+#include <KLocalizedString>
+#include <KMessageWidget>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+
+static void deleteLoudnessMap(LoudnessMap *map)
+{
+    delete map;
+}
+
+LoudnessTask::LoudnessTask(const ObjectId &owner, QObject *object)
+    : AbstractTask(owner, AbstractTask::LOUDNESSJOB, object)
+{
+    m_description = i18n("Loudness analysis");
+}
+
+void LoudnessTask::start(QObject *object, bool force)
+{
+    Q_UNUSED(object)
+    std::vector<QString> binIds = pCore->bin()->selectedClipsIds(true);
+    QStringList clipIds;
+    for (auto &id : binIds) {
+        // Subclips are analysed through their parent clip
+        const QString clipId = id.section(QLatin1Char('/'), 0, 0);
+        if (!clipIds.contains(clipId)) {
+            clipIds << clipId;
+        }
+    }
+    for (const QString &id : qAsConst(clipIds)) {
+        auto binClip = pCore->projectItemModel()->getClipByBinID(id);
+        if (binClip == nullptr || binClip->audioChannels() == 0) {
+            continue;
+        }
+        start(ObjectId(ObjectType::BinClip, id.toInt()), binClip.get(), force);
+    }
+}
+
+void LoudnessTask::start(const ObjectId &owner, QObject *object, bool force)
+{
+    if (pCore->taskManager.hasPendingJob(owner, AbstractTask::LOUDNESSJOB)) {
+        return;
+    }
+    auto *task = new LoudnessTask(owner, object);
+    task->m_isForce = force;
+    pCore->taskManager.startTask(owner.second, task);
+}
+
+void LoudnessTask::run()
+{
+    AbstractTaskDone whenFinished(m_owner.second, this);
+    if (m_isCanceled || pCore->taskManager.isBlocked()) {
+        return;
+    }
+    QMutexLocker lock(&m_runMutex);
+    m_running = true;
+    auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.second));
+    if (binClip == nullptr || binClip->audioChannels() == 0) {
+        return;
+    }
+    std::shared_ptr<Mlt::Producer> producer = binClip->originalProducer();
+    if ((producer == nullptr) || !producer->is_valid()) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                  Q_ARG(QString, i18n("Loudness analysis: cannot open file %1", QFileInfo(binClip->url()).fileName())),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
+        return;
+    }
+    int lengthInFrames = producer->get_length();
+    if (lengthInFrames == INT_MAX || lengthInFrames == 0) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                  Q_ARG(QString, i18n("Loudness analysis: unknown file length for %1", QFileInfo(binClip->url()).fileName())),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
+        return;
+    }
+    int frequency = binClip->audioInfo()->samplingRate();
+    frequency = frequency <= 0 ? 48000 : frequency;
+    int channels = binClip->audioInfo()->channels();
+    channels = channels <= 0 ? 2 : channels;
+
+    QMap<int, QString> streams = binClip->audioInfo()->streams();
+    QMap<int, int> audioChannels = binClip->audioInfo()->streamChannels();
+    // The streams that need to be analysed, with their channel count
+    QMap<int, int> toCompute;
+    for (auto it = streams.cbegin(); it != streams.cend(); ++it) {
+        int stream = it.key();
+        if (audioChannels.contains(stream)) {
+            channels = audioChannels.value(stream);
+        }
+        const QString cachePath = binClip->getLoudnessPath(stream);
+        if (!m_isForce && !cachePath.isEmpty()) {
+            LoudnessMap map = LoudnessMap::load(cachePath);
+            if (!map.isEmpty()) {
+                publishMap(producer, stream, map);
+                continue;
+            }
+        }
+        toCompute.insert(stream, channels);
+    }
+
+    QMap<int, LoudnessMap> results;
+    if (!toCompute.isEmpty() && !m_isCanceled) {
+        QMutex resultMutex;
+        bool opened = AudioReader::decodeStreams(*producer.get(), toCompute, frequency, lengthInFrames,
+                                                 [&](AudioReader &reader, const QMap<int, int> &streamChannels, int totalFrames) {
+                                                     QMap<int, LoudnessMap> streamResults;
+                                                     if (analyse(reader, streamChannels, frequency, lengthInFrames, totalFrames, streamResults)) {
+                                                         QMutexLocker lk(&resultMutex);
+                                                         results.insert(streamResults);
+                                                     }
+                                                 });
+        if (!opened) {
+            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                      Q_ARG(QString, i18n("Loudness analysis: cannot open file %1", QFileInfo(binClip->url()).fileName())),
+                                      Q_ARG(int, int(KMessageWidget::Warning)));
+        }
+    }
+    if (m_isCanceled) {
+        m_progress = 100;
+        QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        return;
+    }
+    for (auto it = results.cbegin(); it != results.cend(); ++it) {
+        publishMap(producer, it.key(), it.value());
+        const QString cachePath = binClip->getLoudnessPath(it.key());
+        if (!cachePath.isEmpty() && !it.value().save(cachePath)) {
+            qWarning() << "Cannot write loudness cache" << cachePath;
+        }
+    }
+    QMetaObject::invokeMethod(m_object, "updateLoudness");
+    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+    // Report the loudness of the default stream
+    const LoudnessMap map = binClip->loudnessMap();
+    if (!map.isEmpty()) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                  Q_ARG(QString, i18n("%1: integrated loudness %2 LUFS, true peak %3 dBTP", binClip->name(),
+                                                      QString::number(map.integrated, 'f', 1), QString::number(map.truePeak, 'f', 1))),
+                                  Q_ARG(int, int(KMessageWidget::Information)));
+    }
+}
+
+bool LoudnessTask::analyse(AudioReader &reader, const QMap<int, int> &streams, int frequency, int lengthInFrames, int totalFrames,
+                           QMap<int, LoudnessMap> &results)
+{
+    int totalChannels = 0;
+    std::vector<LoudnessMeter> meters;
+    for (int channels : streams) {
+        meters.emplace_back(frequency, channels);
+        totalChannels += channels;
+    }
+    QMap<int, LoudnessMap> maps;
+    for (int stream : streams.keys()) {
+        maps[stream].momentary.reserve(lengthInFrames);
+        maps[stream].shortTerm.reserve(lengthInFrames);
+    }
+    std::vector<qint16> samples;
+    for (int z = 0; z < lengthInFrames && !m_isCanceled; ++z) {
+        addProgressStep(totalFrames);
+        int count = reader.readFrame(samples);
+        int firstChannel = 0;
+        size_t ix = 0;
+        for (auto it = streams.cbegin(); it != streams.cend(); ++it, ++ix) {
+            LoudnessMeter &meter = meters[ix];
+            if (count > 0) {
+                meter.addSamples(samples.data() + firstChannel, count, totalChannels);
+            }
+            LoudnessMap &map = maps[it.key()];
+            map.momentary << qint16(qRound(meter.momentary() * 100.));
+            map.shortTerm << qint16(qRound(meter.shortTerm() * 100.));
+            firstChannel += it.value();
+        }
+    }
+    reader.close();
+    if (m_isCanceled) {
+        return false;
+    }
+    size_t ix = 0;
+    for (auto it = streams.cbegin(); it != streams.cend(); ++it, ++ix) {
+        LoudnessMap &map = maps[it.key()];
+        map.integrated = meters[ix].integrated();
+        map.truePeak = meters[ix].truePeak();
+        results.insert(it.key(), map);
+    }
+    return true;
+}
+
+void LoudnessTask::publishMap(const std::shared_ptr<Mlt::Producer> &producer, int stream, const LoudnessMap &map)
+{
+    auto *mapCopy = new LoudnessMap(map);
+    producer->lock();
+    const QString key = QString("_kdenlive:loudness%1").arg(stream);
+    producer->set(QString("kdenlive:loudness_integrated%1").arg(stream).toUtf8().constData(), map.integrated);
+    producer->set(QString("kdenlive:loudness_truepeak%1").arg(stream).toUtf8().constData(), map.truePeak);
+    producer->set(key.toUtf8().constData(), mapCopy, 0, (mlt_destructor)deleteLoudnessMap);
+    producer->unlock();
+}
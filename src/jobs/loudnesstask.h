@@ -0,0 +1,42 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "abstracttask.h"
+
+#include <QMap>
+#include <memory>
+
+class AudioReader;
+class LoudnessMap;
+namespace Mlt {
+class Producer;
+}
+
+/** @class LoudnessTask
+    @brief Measures the EBU R128 loudness of all audio streams of a bin clip.
+    The momentary and short-term loudness of each frame, the integrated loudness and
+    the true peak are cached next to the audio thumbnails and attached to the clip producer.
+ */
+class LoudnessTask : public AbstractTask
+{
+public:
+    LoudnessTask(const ObjectId &owner, QObject *object);
+    /** @brief Analyse the clips selected in the bin */
+    static void start(QObject *object, bool force = false);
+    /** @brief Analyse the bin clip @param owner */
+    static void start(const ObjectId &owner, QObject *object, bool force = false);
+
+protected:
+    void run() override;
+
+private:
+    /** @brief Measure all @param streams {stream index, channels} decoded by @param reader, returns false if canceled.
+        @param totalFrames is the number of frames decoded by all concurrent calls, for the task progress */
+    bool analyse(AudioReader &reader, const QMap<int, int> &streams, int frequency, int lengthInFrames, int totalFrames, QMap<int, LoudnessMap> &results);
+    /** @brief Make the loudness map of a stream available to the timeline and mixer */
+    static void publishMap(const std::shared_ptr<Mlt::Producer> &producer, int stream, const LoudnessMap &map);
+};
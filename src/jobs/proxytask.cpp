@@ -5,21 +5,63 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 */
 
 #include "proxytask.h"
+#include "audio/audioStreamInfo.h"
+#include "audiolevelstask.h"
 #include "bin/bin.h"
 #include "bin/projectclip.h"
 #include "bin/projectitemmodel.h"
+#include "cachetask.h"
 #include "core.h"
 #include "doc/kdenlivedoc.h"
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
+#include "utils/thumbnailcache.hpp"
 
+#include <QDir>
 #include <QProcess>
+#include <QScopeGuard>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QThread>
+#include <mlt++/Mlt.h>
 
 #include <KLocalizedString>
 
+/** @brief The number of codec threads for a proxy job on a source of @param width x @param height,
+ *  sharing the cores with the other proxy jobs of the batch */
+static int codecThreads(int width, int height)
+{
+    int cores = QThread::idealThreadCount();
+    int concurrent = qBound(1, pCore->taskManager.pendingJobCount(AbstractTask::PROXYJOB), pCore->taskManager.transcodeConcurrency());
+    int threads = qMax(1, cores / concurrent);
+    // Threading gains are small for small frames
+    qint64 pixels = qint64(width) * height;
+    if (pixels > 0 && pixels <= 1280 * 720) {
+        threads = qMin(threads, 2);
+    } else if (pixels > 0 && pixels <= 2048 * 1152) {
+        threads = qMin(threads, 4);
+    }
+    return qMin(threads, 16);
+}
+
+/** @brief The lowres decoding level (each level halves the frame size) for a source of @param codec
+ *  and @param width that still provides at least @param targetWidth pixels, 0 if unsupported */
+static int lowresLevel(const QString &codec, int width, int targetWidth)
+{
+    // Only some FFmpeg decoders can skip the high frequencies to output a smaller frame
+    static const QStringList lowresCodecs = {QStringLiteral("mjpeg"),      QStringLiteral("jpeg2000"), QStringLiteral("mpeg1video"),
+                                             QStringLiteral("mpeg2video"), QStringLiteral("mpeg4"),    QStringLiteral("h263")};
+    if (targetWidth <= 0 || !lowresCodecs.contains(codec)) {
+        return 0;
+    }
+    int level = 0;
+    while (level < 3 && (width >> (level + 1)) >= targetWidth) {
+        level++;
+    }
+    return level;
+}
+
 ProxyTask::ProxyTask(const ObjectId &owner, QObject *object)
     : AbstractTask(owner, AbstractTask::PROXYJOB, object)
     , m_jobDuration(0)
@@ -44,6 +86,17 @@ void ProxyTask::start(const ObjectId &owner, QObject *object, bool force)
 void ProxyTask::run()
 {
     AbstractTaskDone whenFinished(m_owner.second, this);
+    bool audioCreated = false;
+    // The clip leaves its audio thumbnail to the proxy job, create it separately whenever the ingest pass did not
+    auto audioFallback = qScopeGuard([this, &audioCreated]() {
+        if (audioCreated || !KdenliveSettings::audiothumbnails() || pCore->taskManager.isBlocked()) {
+            return;
+        }
+        auto clip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.second));
+        if (clip && clip->audioChannels() > 0 && !clip->audioThumbCreated()) {
+            AudioLevelsTask::start(m_owner, m_object);
+        }
+    });
     if (m_isCanceled || pCore->taskManager.isBlocked()) {
         return;
     }
@@ -60,6 +113,7 @@ void ProxyTask::run()
         m_progress = 100;
         QMetaObject::invokeMethod(m_object, "updateJobProgress");
         QMetaObject::invokeMethod(binClip.get(), "updateProxyProducer", Qt::QueuedConnection, Q_ARG(QString, dest));
+        pCore->taskManager.proxyJobDone(0);
         return;
     }
 
@@ -157,7 +211,10 @@ void ProxyTask::run()
             mltParameters << t;
         }
         int threadCount = QThread::idealThreadCount();
-        if (threadCount > 2) {
+        if (KdenliveSettings::proxyautothreads()) {
+            threadCount = codecThreads(binClip->getProducerIntProperty(QStringLiteral("meta.media.width")),
+                                       binClip->getProducerIntProperty(QStringLiteral("meta.media.height")));
+        } else if (threadCount > 2) {
             threadCount = qMin(threadCount - 1, 4);
         } else {
             threadCount = 1;
@@ -314,6 +371,20 @@ void ProxyTask::run()
             }
         }
         proxyParams.replace(QStringLiteral("%width"), QString::number(proxyResize));
+        int threads = 0;
+        if (KdenliveSettings::proxyautothreads() && !nvenc) {
+            // Split the cores between the concurrent jobs and their codecs, and decode a smaller frame when possible
+            int width = binClip->getProducerIntProperty(QStringLiteral("meta.media.width"));
+            int height = binClip->getProducerIntProperty(QStringLiteral("meta.media.height"));
+            threads = codecThreads(width, height);
+            if (!proxyParams.contains(QLatin1String("-threads"))) {
+                parameters << QStringLiteral("-threads") << QString::number(threads);
+            }
+            int lowres = lowresLevel(binClip->videoCodecProperty(QStringLiteral("name")), width, proxyResize);
+            if (lowres > 0 && !proxyParams.contains(QLatin1String("-lowres"))) {
+                parameters << QStringLiteral("-lowres") << QString::number(lowres);
+            }
+        }
         bool disableAutorotate = binClip->getProducerProperty(QStringLiteral("autorotate")) == QLatin1String("0");
         if (disableAutorotate || proxyParams.contains(QStringLiteral("-noautorotate"))) {
             // The noautorotate flag must be passed before input source
@@ -338,16 +409,26 @@ void ProxyTask::run()
         parameters << QStringLiteral("-sn") << QStringLiteral("-dn") << QStringLiteral("-map") << QStringLiteral("0");
         // Drop unknown streams instead of aborting
         parameters << QStringLiteral("-ignore_unknown");
+        if (threads > 0 && !proxyParams.contains(QLatin1String("-threads"))) {
+            // Encoder threads
+            parameters << QStringLiteral("-threads") << QString::number(threads);
+        }
         parameters << dest;
-        qDebug() << "/// FULL PROXY PARAMS:\n" << parameters << "\n------";
-        m_jobProcess.reset(new QProcess);
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &ProxyTask::processLogInfo);
-        QObject::connect(this, &ProxyTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-        m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
-        AbstractTask::setPreferredPriority(m_jobProcess->processId());
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        QTemporaryDir thumbFolder;
+        const QStringList ingest = ingestParameters(binClip, thumbFolder.isValid() ? thumbFolder.path() : QString());
+        qCDebug(KDENLIVE_LOG) << "Creating proxy" << dest << (ingest.isEmpty() ? "" : "and extracting the missing audio levels and thumbnails");
+        result = runFfmpeg(parameters + ingest, !ingest.isEmpty());
+        if (!ingest.isEmpty()) {
+            if (result) {
+                audioCreated = storeIngestResults(binClip, thumbFolder.path());
+            } else if (!m_isCanceled) {
+                // This FFmpeg may not support one of the extra outputs, retry with the proxy only
+                m_ingestStreams.clear();
+                m_ingestThumbs.clear();
+                m_logDetails.clear();
+                result = runFfmpeg(parameters, false);
+            }
+        }
     }
     // remove temporary playlist if it exists
     m_progress = 100;
@@ -365,6 +446,7 @@ void ProxyTask::run()
             // Job successful
             QMetaObject::invokeMethod(binClip.get(), "updateProxyProducer", Qt::QueuedConnection, Q_ARG(QString, dest));
         }
+        pCore->taskManager.proxyJobDone(result && type != ClipType::Image ? binClip->frameDuration() : 0, !result);
     } else {
         // Proxy process crashed
         QFile::remove(dest);
@@ -372,6 +454,7 @@ void ProxyTask::run()
             QMetaObject::invokeMethod(pCore.get(), "displayBinLogMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to create proxy clip.")),
                                       Q_ARG(int, int(KMessageWidget::Warning)), Q_ARG(QString, m_logDetails));
         }
+        pCore->taskManager.proxyJobDone(0, !m_isCanceled);
     }
     QMetaObject::invokeMethod(m_object, "updateJobProgress");
     return;
@@ -421,3 +504,156 @@ void ProxyTask::processLogInfo()
         }
     }
 }
+
+bool ProxyTask::runFfmpeg(const QStringList &parameters, bool checkExitCode)
+{
+    m_jobProcess.reset(new QProcess);
+    // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
+    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &ProxyTask::processLogInfo);
+    QObject::connect(this, &ProxyTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
+    m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
+    AbstractTask::setPreferredPriority(m_jobProcess->processId());
+    if (m_ingestStreams.isEmpty()) {
+        m_jobProcess->waitForFinished(-1);
+    } else {
+        // Consume the audio samples on this thread as they arrive, so that the pipe buffer stays small
+        m_jobProcess->waitForStarted();
+        while (m_jobProcess->state() != QProcess::NotRunning) {
+            m_jobProcess->waitForReadyRead(100);
+            processAudioData();
+        }
+        m_jobProcess->waitForFinished(-1);
+    }
+    return m_jobProcess->exitStatus() == QProcess::NormalExit && (!checkExitCode || m_jobProcess->exitCode() == 0);
+}
+
+QStringList ProxyTask::ingestParameters(const std::shared_ptr<ProjectClip> &binClip, const QString &thumbFolder)
+{
+    QStringList parameters;
+    m_ingestStreams.clear();
+    m_ingestThumbs.clear();
+    if (!KdenliveSettings::ingestpass()) {
+        return parameters;
+    }
+    // Audio levels of the streams without cached thumbnail, all written as a single raw stream on stdout
+    if (KdenliveSettings::audiothumbnails() && binClip->audioChannels() > 0 && !binClip->audioThumbCreated() && binClip->audioInfo()) {
+        const QMap<int, int> channels = binClip->audioInfo()->streamChannels();
+        const QList<int> streams = binClip->audioInfo()->streams().keys();
+        m_ingestChannels = 0;
+        for (int stream : streams) {
+            if (!QFile::exists(binClip->getAudioThumbPath(stream))) {
+                int count = qMax(1, channels.value(stream, 2));
+                m_ingestStreams.insert(stream, count);
+                m_ingestChannels += count;
+            }
+        }
+    }
+    if (!m_ingestStreams.isEmpty()) {
+        int frequency = binClip->audioInfo()->samplingRate();
+        m_ingestFrequency = frequency > 0 ? frequency : 48000;
+        m_ingestFps = pCore->getCurrentFps();
+        m_ingestFrame = 0;
+        m_audioData.clear();
+        m_ingestLevels.clear();
+        m_ingestMaxLevel.clear();
+        if (m_ingestStreams.size() == 1) {
+            parameters << QStringLiteral("-map") << QStringLiteral("0:%1").arg(m_ingestStreams.firstKey());
+        } else {
+            QStringList graph;
+            QString inputs;
+            int ix = 0;
+            // amerge stops with the shortest input, pad the streams to the clip duration
+            const QString duration = QString::number(binClip->duration().seconds(), 'f', 3);
+            for (auto it = m_ingestStreams.cbegin(); it != m_ingestStreams.cend(); ++it, ++ix) {
+                graph << QStringLiteral("[0:%1]aresample=%2,apad=whole_dur=%3[a%4]").arg(it.key()).arg(m_ingestFrequency).arg(duration).arg(ix);
+                inputs.append(QStringLiteral("[a%1]").arg(ix));
+            }
+            graph << QStringLiteral("%1amerge=inputs=%2[levels]").arg(inputs).arg(m_ingestStreams.size());
+            parameters << QStringLiteral("-filter_complex") << graph.join(QLatin1Char(';')) << QStringLiteral("-map") << QStringLiteral("[levels]");
+        }
+        parameters << QStringLiteral("-ac") << QString::number(m_ingestChannels) << QStringLiteral("-ar") << QString::number(m_ingestFrequency)
+                   << QStringLiteral("-f") << QStringLiteral("s16le") << QStringLiteral("pipe:1");
+    }
+    // Preview thumbnails, as done by the cache task
+    int videoIndex = binClip->getProducerIntProperty(QStringLiteral("video_index"));
+    if (KdenliveSettings::hoverPreview() && binClip->hasVideo() && videoIndex >= 0 && !thumbFolder.isEmpty()) {
+        const QString clipId = QString::number(m_owner.second);
+        double ratio = binClip->originalFps() > 0. ? binClip->originalFps() / pCore->getCurrentFps() : 1.;
+        QStringList conditions;
+        for (int pos : CacheTask::thumbnailFrames(0, binClip->getFramePlaytime(), 30)) {
+            if (!ThumbnailCache::get()->hasThumbnail(clipId, pos)) {
+                m_ingestThumbs.push_back(pos);
+                conditions << QStringLiteral("eq(n,%1)").arg(qRound(pos * ratio));
+            }
+        }
+        if (!conditions.isEmpty()) {
+            int height = pCore->thumbProfile().height();
+            int width = qRound(height * pCore->getCurrentDar());
+            width += width % 2;
+            // Give the selected frames consecutive timestamps, one per second, so that none is dropped or duplicated
+            parameters << QStringLiteral("-map") << QStringLiteral("0:%1").arg(videoIndex) << QStringLiteral("-vf")
+                       << QStringLiteral("select='%1',setpts=N/TB,scale=%2:%3").arg(conditions.join(QLatin1Char('+'))).arg(width).arg(height)
+                       << QStringLiteral("-r") << QStringLiteral("1") << QStringLiteral("-an") << QStringLiteral("-q:v") << QStringLiteral("3")
+                       << QDir(thumbFolder).absoluteFilePath(QStringLiteral("thumb_%d.jpg"));
+        }
+    }
+    return parameters;
+}
+
+void ProxyTask::processAudioData()
+{
+    m_audioData.append(m_jobProcess->readAllStandardOutput());
+    int offset = 0;
+    const float fps = float(m_ingestFps);
+    while (true) {
+        int samples = mlt_audio_calculate_frame_samples(fps, m_ingestFrequency, m_ingestFrame);
+        int bytes = samples * m_ingestChannels * int(sizeof(qint16));
+        if (bytes <= 0 || m_audioData.size() - offset < bytes) {
+            break;
+        }
+        const auto *data = reinterpret_cast<const qint16 *>(m_audioData.constData() + offset);
+        int firstChannel = 0;
+        for (auto it = m_ingestStreams.cbegin(); it != m_ingestStreams.cend(); ++it) {
+            QVector<uint8_t> &levels = m_ingestLevels[it.key()];
+            uint &max = m_ingestMaxLevel[it.key()];
+            max = qMax(max, 1u);
+            for (int channel = 0; channel < it.value(); ++channel) {
+                uint lev = 256 * qMin(AudioLevelsTask::audioLevel(data + firstChannel + channel, samples, m_ingestChannels) * 0.9, 1.0);
+                levels << lev;
+                max = qMax(lev, max);
+            }
+            firstChannel += it.value();
+        }
+        offset += bytes;
+        m_ingestFrame++;
+    }
+    m_audioData.remove(0, offset);
+}
+
+bool ProxyTask::storeIngestResults(const std::shared_ptr<ProjectClip> &binClip, const QString &thumbFolder)
+{
+    bool audioCreated = false;
+    if (!m_ingestStreams.isEmpty()) {
+        processAudioData();
+        std::shared_ptr<Mlt::Producer> producer = binClip->originalProducer();
+        for (auto it = m_ingestLevels.cbegin(); it != m_ingestLevels.cend(); ++it) {
+            audioCreated = AudioLevelsTask::saveLevels(binClip, producer, it.key(), it.value(), m_ingestStreams.value(it.key()),
+                                                       int(m_ingestMaxLevel.value(it.key()))) ||
+                           audioCreated;
+        }
+        if (audioCreated) {
+            QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, false));
+        }
+    }
+    const QString clipId = QString::number(m_owner.second);
+    QDir dir(thumbFolder);
+    int ix = 1;
+    for (int pos : m_ingestThumbs) {
+        QImage thumb(dir.absoluteFilePath(QStringLiteral("thumb_%1.jpg").arg(ix++)));
+        if (thumb.isNull()) {
+            break;
+        }
+        ThumbnailCache::get()->storeThumbnail(clipId, pos, thumb, true);
+    }
+    return audioCreated;
+}
@@ -8,6 +8,12 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstracttask.h"
 
+#include <QMap>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+class ProjectClip;
 class QProcess;
 
 class ProxyTask : public AbstractTask
@@ -23,9 +29,30 @@ private Q_SLOTS:
     void processLogInfo();
 
 private:
+    /** @brief Compute the audio levels from the samples written by the ingest pass, on the job thread */
+    void processAudioData();
+    /** @brief The FFmpeg outputs extracting the missing audio levels and preview thumbnails during the proxy encoding,
+        so that the source is only decoded once */
+    QStringList ingestParameters(const std::shared_ptr<ProjectClip> &binClip, const QString &thumbFolder);
+    /** @brief Store the results of the ingest outputs, returns true if audio levels were created */
+    bool storeIngestResults(const std::shared_ptr<ProjectClip> &binClip, const QString &thumbFolder);
+    /** @brief Run FFmpeg with @param parameters, returns true if it succeeded.
+        @param checkExitCode also consider the FFmpeg errors as a failure */
+    bool runFfmpeg(const QStringList &parameters, bool checkExitCode);
     int m_jobDuration;
     bool m_isFfmpegJob;
     std::unique_ptr<QProcess> m_jobProcess;
     QString m_errorMessage;
     QString m_logDetails;
+    /** @brief Audio streams analysed by the ingest pass, with their channel count */
+    QMap<int, int> m_ingestStreams;
+    int m_ingestChannels{0};
+    int m_ingestFrequency{48000};
+    double m_ingestFps{25.};
+    int m_ingestFrame{0};
+    QByteArray m_audioData;
+    QMap<int, QVector<uint8_t>> m_ingestLevels;
+    QMap<int, uint> m_ingestMaxLevel;
+    /** @brief Positions of the preview thumbnails extracted by the ingest pass */
+    std::vector<int> m_ingestThumbs;
 };
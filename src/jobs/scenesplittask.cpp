@@ -23,24 +23,26 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QPointer>
-#include <QProcess>
-#include <QTemporaryFile>
-#include <QThread>
 
 #include <KLocalizedString>
+#include <mlt++/MltFilter.h>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
 #include <project/projectmanager.h>
 
-SceneSplitTask::SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, QObject *object)
+// Number of frames between two comparisons in fast mode
+static const int fastStride = 4;
+
+SceneSplitTask::SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, bool fastMode,
+                               QObject *object)
     : AbstractTask(owner, AbstractTask::ANALYSECLIPJOB, object)
     , m_threshold(threshold)
-    , m_jobDuration(0)
     , m_markersType(markersCategory)
     , m_subClips(addSubclips)
     , m_minInterval(minDuration)
-    , m_jobProcess(nullptr)
+    , m_fastMode(fastMode)
 {
     m_description = i18n("Detecting scene change");
-    qDebug() << "Threshold is" << threshold << QString::number(threshold);
 }
 
 void SceneSplitTask::start(QObject *object, bool force)
@@ -52,6 +54,7 @@ void SceneSplitTask::start(QObject *object, bool force)
     view.threshold->setValue(KdenliveSettings::scenesplitthreshold());
     view.add_markers->setChecked(KdenliveSettings::scenesplitmarkers());
     view.cut_scenes->setChecked(KdenliveSettings::scenesplitsubclips());
+    view.fast_mode->setChecked(KdenliveSettings::scenesplitfast());
     // Set  up categories
     view.marker_category->setMarkerModel(pCore->projectManager()->getGuideModel().get());
     d->setWindowTitle(i18nc("@title:window", "Scene Detection"));
@@ -63,9 +66,11 @@ void SceneSplitTask::start(QObject *object, bool force)
     bool addSubclips = view.cut_scenes->isChecked();
     int markersCategory = addMarkers ? view.marker_category->currentCategory() : -1;
     int minDuration = view.minDuration->value();
+    bool fastMode = view.fast_mode->isChecked();
     KdenliveSettings::setScenesplitthreshold(threshold);
     KdenliveSettings::setScenesplitmarkers(view.add_markers->isChecked());
     KdenliveSettings::setScenesplitsubclips(view.cut_scenes->isChecked());
+    KdenliveSettings::setScenesplitfast(fastMode);
 
     std::vector<QString> binIds = pCore->bin()->selectedClipsIds(true);
     for (auto &id : binIds) {
@@ -80,12 +85,12 @@ void SceneSplitTask::start(QObject *object, bool force)
             }
             owner = ObjectId(ObjectType::BinClip, binData.first().toInt());
             auto binClip = pCore->projectItemModel()->getClipByBinID(binData.first());
-            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, binClip.get());
+            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, fastMode, binClip.get());
 
         } else {
             owner = ObjectId(ObjectType::BinClip, id.toInt());
             auto binClip = pCore->projectItemModel()->getClipByBinID(id);
-            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, binClip.get());
+            task = new SceneSplitTask(owner, threshold / 100., markersCategory, addSubclips, minDuration, fastMode, binClip.get());
         }
         // See if there is already a task for this MLT service and resource.
         if (task && pCore->taskManager.hasPendingJob(owner, AbstractTask::ANALYSECLIPJOB)) {
@@ -109,72 +114,54 @@ void SceneSplitTask::run()
     QMutexLocker lock(&m_runMutex);
     m_running = true;
     auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.second));
-    const QString source = binClip->url();
     ClipType::ProducerType type = binClip->clipType();
-    bool result;
     if (type != ClipType::AV && type != ClipType::Video) {
         // This job can only process video files
         QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Cannot analyse this clip type.")),
                                   Q_ARG(int, int(KMessageWidget::Warning)));
-        qDebug() << "=== ABORT 1";
-        return;
-    }
-    if (KdenliveSettings::ffmpegpath().isEmpty()) {
-        // FFmpeg not detected, cannot process the Job
-        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
-                                  Q_ARG(QString, i18n("FFmpeg not found, please set path in Kdenlive's settings Environment.")),
-                                  Q_ARG(int, int(KMessageWidget::Warning)));
-        qDebug() << "=== ABORT 2";
         return;
     }
-    m_jobDuration = int(binClip->duration().seconds());
     int producerDuration = binClip->frameDuration();
-    // QStringList parameters =
-    // {QStringLiteral("-loglevel"),QStringLiteral("info"),QStringLiteral("-i"),source,QStringLiteral("-filter:v"),QString("scdet"),QStringLiteral("-f"),QStringLiteral("null"),QStringLiteral("-")};
-    QStringList parameters = {QStringLiteral("-y"),
-                              QStringLiteral("-loglevel"),
-                              QStringLiteral("info"),
-                              QStringLiteral("-i"),
-                              source,
-                              QStringLiteral("-filter:v"),
-                              QString("select='gt(scene,%1)',showinfo").arg(m_threshold),
-                              QStringLiteral("-vsync"),
-                              QStringLiteral("vfr"),
-                              QStringLiteral("-f"),
-                              QStringLiteral("null"),
-                              QStringLiteral("-")};
-
-    m_jobProcess.reset(new QProcess);
-    // m_jobProcess->setStandardErrorFile("/tmp/test_settings.txt");
-    m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-    qDebug() << "=== READY TO START JOB:" << parameters;
-    QObject::connect(this, &SceneSplitTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardOutput, this, &SceneSplitTask::processLogInfo);
-    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &SceneSplitTask::processLogErr);
-    m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters);
-    // m_jobProcess->closeReadChannel(QProcess::StandardError);
-    m_jobProcess->waitForStarted();
-    // QString data;
-    /*while(m_jobProcess->waitForReadyRead()) {
-        //data.append(m_jobProcess->readAll());
-        qDebug()<<"???? READ: \n"<<m_jobProcess->readAll();
-    }*/
-    m_jobProcess->waitForFinished(-1);
-    result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+    // Decode with a private producer at thumbnail resolution, without audio
+    std::shared_ptr<Mlt::Producer> master = binClip->originalProducer();
+    QString mltService = master->get("mlt_service");
+    const QString mltResource = master->get("resource");
+    if (mltService == QLatin1String("avformat")) {
+        mltService = QStringLiteral("avformat-novalidate");
+    }
+    std::unique_ptr<Mlt::Producer> producer(
+        new Mlt::Producer(pCore->thumbProfile().get_profile(), mltService.toUtf8().constData(), mltResource.toUtf8().constData()));
+    bool result = false;
+    if (producer->is_valid()) {
+        Mlt::Properties original(master->get_properties());
+        Mlt::Properties cloneProps(producer->get_properties());
+        cloneProps.pass_list(original, ClipController::getPassPropertiesList());
+        producer->set("audio_index", -1);
+        if (m_fastMode) {
+            // Passed to the decoder, deblocking makes no visible difference at this size
+            producer->set("skip_loop_filter", "all");
+        }
+        Mlt::Filter scaler(pCore->thumbProfile().get_profile(), "swscale");
+        if (scaler.is_valid()) {
+            producer->attach(scaler);
+        }
+        result = detectScenes(producer.get(), producerDuration);
+        if (!result) {
+            m_logDetails = i18n("No frame could be decoded from %1", mltResource);
+        }
+    } else {
+        m_logDetails = i18n("Cannot open %1", mltResource);
+    }
 
-    // remove temporary playlist if it exists
     m_progress = 100;
     QMetaObject::invokeMethod(m_object, "updateJobProgress");
     if (result && !m_isCanceled) {
-        qDebug() << "========================\n\nGOR RESULTS: " << m_results << "\n\n=========";
-        auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.second));
         if (m_markersType >= 0) {
             // Build json data for markers
             QJsonArray list;
             int ix = 1;
             int lastCut = 0;
-            for (auto &marker : m_results) {
-                int pos = GenTime(marker).frames(pCore->getCurrentFps());
+            for (int pos : qAsConst(m_results)) {
                 if (m_minInterval > 0 && ix > 1 && pos - lastCut < m_minInterval) {
                     continue;
                 }
@@ -195,8 +182,7 @@ void SceneSplitTask::run()
             int lastCut = 0;
             QJsonArray list;
             QJsonDocument json;
-            for (double &marker : m_results) {
-                int pos = GenTime(marker).frames(pCore->getCurrentFps());
+            for (int pos : qAsConst(m_results)) {
                 if (pos <= lastCut + 1 || pos - lastCut < m_minInterval) {
                     continue;
                 }
@@ -222,69 +208,87 @@ void SceneSplitTask::run()
                                           Q_ARG(QString, dataMap), Q_ARG(bool, true));
             }
         }
-    } else {
-        // Proxy process crashed
+    } else if (!m_isCanceled) {
         QMetaObject::invokeMethod(pCore.get(), "displayBinLogMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to analyse clip.")),
                                   Q_ARG(int, int(KMessageWidget::Warning)), Q_ARG(QString, m_logDetails));
     }
 }
 
-void SceneSplitTask::processLogErr()
+SceneDetector::Signature SceneSplitTask::frameSignature(Mlt::Producer *producer, int pos)
 {
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardError());
-    qDebug() << "ERROR: ----\n" << buffer;
+    producer->seek(pos);
+    std::unique_ptr<Mlt::Frame> frame(producer->get_frame());
+    if (!frame || !frame->is_valid()) {
+        return SceneDetector::Signature();
+    }
+    frame->set("consumer.deinterlacer", "onefield");
+    frame->set("consumer.rescale", "nearest");
+    int width = SceneDetector::width;
+    int height = SceneDetector::height;
+    // The luma plane is all we need, request planar yuv to avoid a color conversion
+    mlt_image_format format = mlt_image_yuv420p;
+    const uchar *image = frame->get_image(format, width, height);
+    if (image && format == mlt_image_yuv420p) {
+        return SceneDetector::fromLuma(image, width, height, width);
+    }
+    format = mlt_image_rgba;
+    image = frame->get_image(format, width, height);
+    if (image == nullptr || format != mlt_image_rgba) {
+        return SceneDetector::Signature();
+    }
+    return SceneDetector::fromRgba(image, width, height);
 }
 
-void SceneSplitTask::processLogInfo()
+bool SceneSplitTask::detectScenes(Mlt::Producer *producer, int duration)
 {
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardOutput());
-    m_logDetails.append(buffer);
-    int progress = 0;
-    // Parse FFmpeg output
-    qDebug() << "-------------\n" << buffer;
-    if (buffer.contains(QLatin1String("[Parsed_showinfo"))) {
-        QString timeMarker("pts_time:");
-        bool ok;
-        QStringList output = buffer.split("[Parsed_showinfo");
-        output.removeFirst();
-        for (const QString &o : qAsConst(output)) {
-            if (o.contains(timeMarker)) {
-                double res = o.section(timeMarker, 1).section(QLatin1Char(' '), 0, 0).toDouble(&ok);
-                if (ok) {
-                    m_results << res;
-                }
-            }
+    const int stride = m_fastMode ? fastStride : 1;
+    SceneDetector::Signature previous;
+    int previousPos = -1;
+    double previousMad = 0.;
+    int decoded = 0;
+    for (int pos = 0; pos < duration && !m_isCanceled; pos += stride) {
+        SceneDetector::Signature current = frameSignature(producer, pos);
+        if (!current.isValid()) {
+            continue;
         }
-    }
-    if (m_jobDuration == 0) {
-        qDebug() << "=== NO DURATION!!!";
-        if (buffer.contains(QLatin1String("Duration:"))) {
-            QString data = buffer.section(QStringLiteral("Duration:"), 1, 1).section(QLatin1Char(','), 0, 0).simplified();
-            if (!data.isEmpty()) {
-                qDebug() << "==== GOT DURATION:" << data;
-                QStringList numbers = data.split(QLatin1Char(':'));
-                if (numbers.size() < 3) {
-                    return;
+        decoded++;
+        if (previous.isValid()) {
+            // Same scene value as the FFmpeg select filter used before, so that saved thresholds keep their meaning
+            double mad = SceneDetector::meanAbsDiff(previous, current);
+            double score = SceneDetector::sceneScore(mad, previousMad);
+            int cutPos = pos;
+            if (pos - previousPos > 1 && score > m_threshold) {
+                // Something changed between the two samples, find the exact frame
+                SceneDetector::Signature last = previous;
+                double stepMad = 0.;
+                score = 0.;
+                for (int i = previousPos + 1; i <= pos && !m_isCanceled; ++i) {
+                    SceneDetector::Signature sig = i == pos ? current : frameSignature(producer, i);
+                    if (!sig.isValid()) {
+                        continue;
+                    }
+                    double frameMad = SceneDetector::meanAbsDiff(last, sig);
+                    double frameScore = SceneDetector::sceneScore(frameMad, stepMad);
+                    if (frameScore > score) {
+                        score = frameScore;
+                        cutPos = i;
+                    }
+                    stepMad = frameMad;
+                    last = std::move(sig);
                 }
-                m_jobDuration = numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + numbers.at(2).toInt();
             }
-        }
-    } else if (buffer.contains(QLatin1String("time="))) {
-        QString time = buffer.section(QStringLiteral("time="), 1, 1).simplified().section(QLatin1Char(' '), 0, 0);
-        qDebug() << "=== GOT PROGRESS TIME: " << time;
-        if (!time.isEmpty()) {
-            QStringList numbers = time.split(QLatin1Char(':'));
-            if (numbers.size() < 3) {
-                progress = time.toInt();
-                if (progress == 0) {
-                    return;
-                }
-            } else {
-                progress = numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + qRound(numbers.at(2).toDouble());
+            if (score > m_threshold) {
+                m_results << cutPos;
             }
+            previousMad = mad;
+        }
+        previous = std::move(current);
+        previousPos = pos;
+        int progress = duration > 0 ? 100 * pos / duration : 0;
+        if (progress != m_progress) {
+            m_progress = progress;
+            QMetaObject::invokeMethod(m_object, "updateJobProgress");
         }
-        m_progress = 100 * progress / m_jobDuration;
-        QMetaObject::invokeMethod(m_object, "updateJobProgress");
-        // Q_EMIT jobProgress(int(100.0 * progress / m_jobDuration));
     }
+    return decoded > 0;
 }
@@ -7,30 +7,34 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #pragma once
 
 #include "abstracttask.h"
+#include "lib/video/sceneDetector.h"
 
-class QProcess;
+#include <memory>
+
+namespace Mlt {
+class Producer;
+}
 
 class SceneSplitTask : public AbstractTask
 {
 public:
-    SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, QObject* object);
+    SceneSplitTask(const ObjectId &owner, double threshold, int markersCategory, bool addSubclips, int minDuration, bool fastMode, QObject *object);
     static void start(QObject* object, bool force = false);
 
 protected:
     void run() override;
 
-private Q_SLOTS:
-    void processLogInfo();
-    void processLogErr();
-
 private:
+    /** @brief Decode @param producer at low resolution and store the detected cuts, returns false on failure */
+    bool detectScenes(Mlt::Producer *producer, int duration);
+    /** @brief Returns the signature of the frame at @param pos, invalid if the frame could not be decoded */
+    SceneDetector::Signature frameSignature(Mlt::Producer *producer, int pos);
     double m_threshold;
-    int m_jobDuration;
     int m_markersType;
     bool m_subClips;
     int m_minInterval;
-    std::unique_ptr<QProcess> m_jobProcess;
-    QString m_errorMessage;
-    QString m_logDetails;
-    QList<double> m_results;
+    /** @brief Skip the loop filter and only compare every few frames, refining around changes */
+    bool m_fastMode;
+    /** @brief Position of the first frame of each detected scene */
+    QList<int> m_results;
 };
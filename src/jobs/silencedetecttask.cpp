@@ -0,0 +1,227 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "silencedetecttask.h"
+#include "audio/audioReader.h"
+#include "audio/audioStreamInfo.h"
+#include "audio/silenceDetector.h"
+#include "audiolevelstask.h"
+#include "bin/bin.h"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "kdenlivesettings.h"
+#include "project/projectmanager.h"
+#include "ui_silencedetectdialog_ui.h"
+
+#include <KLocalizedString>
+#include <KMessageWidget>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+
+// Sample rate used when decoding, the level of speech and background noise is barely affected
+static const int analysisFrequency = 16000;
+
+SilenceDetectTask::SilenceDetectTask(const ObjectId &owner, int threshold, int minDuration, int padding, int markersCategory, bool addSubclips,
+                                     QObject *object)
+    : AbstractTask(owner, AbstractTask::SILENCEJOB, object)
+    , m_threshold(threshold)
+    , m_minDuration(minDuration)
+    , m_padding(padding)
+    , m_markersType(markersCategory)
+    , m_subClips(addSubclips)
+{
+    m_description = i18n("Detecting silence");
+}
+
+void SilenceDetectTask::start(QObject *object, bool force)
+{
+    Q_UNUSED(object)
+    QPointer<QDialog> d = new QDialog;
+    Ui::SilenceDetectDialog_UI view;
+    view.setupUi(d);
+    view.threshold->setValue(KdenliveSettings::silencethreshold());
+    view.minDuration->setValue(KdenliveSettings::silenceduration());
+    view.padding->setValue(KdenliveSettings::silencepadding());
+    view.add_markers->setChecked(KdenliveSettings::silencemarkers());
+    view.cut_speech->setChecked(KdenliveSettings::silencesubclips());
+    view.marker_category->setMarkerModel(pCore->projectManager()->getGuideModel().get());
+    view.marker_category->setEnabled(view.add_markers->isChecked());
+    d->setWindowTitle(i18nc("@title:window", "Silence Detection"));
+    if (d->exec() != QDialog::Accepted) {
+        return;
+    }
+    int threshold = view.threshold->value();
+    int minDuration = view.minDuration->value();
+    int padding = view.padding->value();
+    bool addMarkers = view.add_markers->isChecked();
+    bool addSubclips = view.cut_speech->isChecked();
+    int markersCategory = addMarkers ? view.marker_category->currentCategory() : -1;
+    KdenliveSettings::setSilencethreshold(threshold);
+    KdenliveSettings::setSilenceduration(minDuration);
+    KdenliveSettings::setSilencepadding(padding);
+    KdenliveSettings::setSilencemarkers(addMarkers);
+    KdenliveSettings::setSilencesubclips(addSubclips);
+
+    std::vector<QString> binIds = pCore->bin()->selectedClipsIds(true);
+    QStringList clipIds;
+    for (auto &id : binIds) {
+        // Subclips are analysed through their parent clip
+        const QString clipId = id.section(QLatin1Char('/'), 0, 0);
+        if (!clipIds.contains(clipId)) {
+            clipIds << clipId;
+        }
+    }
+    // Each clip is a separate task, so that they are processed in parallel by the task manager
+    for (const QString &id : qAsConst(clipIds)) {
+        auto binClip = pCore->projectItemModel()->getClipByBinID(id);
+        if (binClip == nullptr || binClip->audioChannels() == 0) {
+            continue;
+        }
+        ObjectId owner(ObjectType::BinClip, id.toInt());
+        if (pCore->taskManager.hasPendingJob(owner, AbstractTask::SILENCEJOB)) {
+            continue;
+        }
+        auto *task = new SilenceDetectTask(owner, threshold, minDuration, padding, markersCategory, addSubclips, binClip.get());
+        task->m_isForce = force;
+        pCore->taskManager.startTask(owner.second, task);
+    }
+}
+
+bool SilenceDetectTask::readThumbnailLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, SilenceDetector &detector)
+{
+    if (!binClip->audioThumbCreated()) {
+        return false;
+    }
+    int channels = qMax(1, binClip->audioInfo()->channelsForStream(stream));
+    const QVector<uint8_t> levels = binClip->audioFrameCache(stream);
+    if (levels.size() < channels) {
+        return false;
+    }
+    for (int i = 0; i + channels <= levels.size() && !m_isCanceled; i += channels) {
+        uint8_t level = levels.at(i);
+        for (int c = 1; c < channels; ++c) {
+            level = qMax(level, levels.at(i + c));
+        }
+        // Thumbnail levels are stored as 256 * 0.9 * IEC level
+        detector.addFrame(SilenceDetector::iecToDb(level / 230.4));
+    }
+    return !m_isCanceled;
+}
+
+bool SilenceDetectTask::readDecodedLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, int lengthInFrames, SilenceDetector &detector)
+{
+    std::shared_ptr<Mlt::Producer> producer = binClip->originalProducer();
+    if (producer == nullptr || !producer->is_valid()) {
+        return false;
+    }
+    int channels = qMax(1, binClip->audioInfo()->channelsForStream(stream));
+    AudioReader reader(*producer.get(), stream, analysisFrequency, channels);
+    if (!reader.open()) {
+        return false;
+    }
+    std::vector<qint16> samples;
+    for (int z = 0; z < lengthInFrames && !m_isCanceled; ++z) {
+        int val = int(100.0 * z / lengthInFrames);
+        if (m_progress != val) {
+            m_progress = val;
+            QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        }
+        int count = reader.readFrame(samples);
+        if (count <= 0) {
+            // End of the audio, the remaining frames are silent
+            detector.addFrame(-100.);
+            continue;
+        }
+        // Same measure as the audio thumbnails: the level of the loudest channel
+        double level = 0.;
+        for (int c = 0; c < channels; ++c) {
+            level = qMax(level, AudioLevelsTask::audioLevel(samples.data() + c, count, channels));
+        }
+        detector.addFrame(SilenceDetector::iecToDb(level));
+    }
+    reader.close();
+    return !m_isCanceled;
+}
+
+void SilenceDetectTask::run()
+{
+    AbstractTaskDone whenFinished(m_owner.second, this);
+    if (m_isCanceled || pCore->taskManager.isBlocked()) {
+        return;
+    }
+    QMutexLocker lock(&m_runMutex);
+    m_running = true;
+    auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.second));
+    if (binClip == nullptr || binClip->audioChannels() == 0) {
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Cannot analyse a clip without audio.")),
+                                  Q_ARG(int, int(KMessageWidget::Warning)));
+        return;
+    }
+    int lengthInFrames = int(binClip->frameDuration());
+    if (lengthInFrames <= 0) {
+        return;
+    }
+    const double fps = pCore->getCurrentFps();
+    SilenceDetector detector(m_threshold, qRound(m_minDuration * fps / 1000.), qRound(m_padding * fps / 1000.));
+    int stream = binClip->audioInfo()->audio_index();
+    if (!readThumbnailLevels(binClip, stream, detector) && !m_isCanceled) {
+        // No audio thumbnail yet, measure the audio
+        detector = SilenceDetector(m_threshold, qRound(m_minDuration * fps / 1000.), qRound(m_padding * fps / 1000.));
+        if (!readDecodedLevels(binClip, stream, lengthInFrames, detector) && !m_isCanceled) {
+            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                      Q_ARG(QString, i18n("Silence detection: cannot read audio of %1", binClip->name())),
+                                      Q_ARG(int, int(KMessageWidget::Warning)));
+        }
+    }
+    m_progress = 100;
+    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+    if (m_isCanceled || detector.frames() == 0) {
+        return;
+    }
+    const QVector<QPair<int, int>> silences = detector.silences();
+    if (m_markersType >= 0 && !silences.isEmpty()) {
+        QJsonArray list;
+        int ix = 1;
+        for (const auto &silence : silences) {
+            QJsonObject currentMarker;
+            currentMarker.insert(QLatin1String("pos"), QJsonValue(silence.first));
+            currentMarker.insert(QLatin1String("comment"),
+                                 QJsonValue(i18n("Silence %1 (%2s)", ix, QString::number((silence.second - silence.first + 1) / fps, 'f', 1))));
+            currentMarker.insert(QLatin1String("type"), QJsonValue(m_markersType));
+            list.push_back(currentMarker);
+            ix++;
+        }
+        QJsonDocument json(list);
+        QMetaObject::invokeMethod(m_object, "importJsonMarkers", Q_ARG(QString, QString(json.toJson())));
+    }
+    if (m_subClips) {
+        QJsonArray list;
+        int ix = 1;
+        for (const auto &region : detector.activeRegions()) {
+            QJsonObject currentZone;
+            currentZone.insert(QLatin1String("name"), QJsonValue(i18n("Speech %1", ix)));
+            currentZone.insert(QLatin1String("in"), QJsonValue(region.first));
+            currentZone.insert(QLatin1String("out"), QJsonValue(qMin(region.second, lengthInFrames - 1)));
+            list.push_back(currentZone);
+            ix++;
+        }
+        QJsonDocument json(list);
+        if (!list.isEmpty()) {
+            QMetaObject::invokeMethod(pCore->projectItemModel().get(), "loadSubClips", Q_ARG(QString, QString::number(m_owner.second)),
+                                      Q_ARG(QString, QString(json.toJson())), Q_ARG(bool, true));
+        }
+    }
+    int silentFrames = 0;
+    for (const auto &silence : silences) {
+        silentFrames += silence.second - silence.first + 1;
+    }
+    QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                              Q_ARG(QString, i18np("%2: 1 silence found (%3s)", "%2: %1 silences found (%3s)", silences.size(), binClip->name(),
+                                                   QString::number(silentFrames / fps, 'f', 1))),
+                              Q_ARG(int, int(KMessageWidget::Information)));
+}
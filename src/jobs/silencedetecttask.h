@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "abstracttask.h"
+
+#include <memory>
+
+class ProjectClip;
+class SilenceDetector;
+
+/** @class SilenceDetectTask
+    @brief Finds the silent parts of a bin clip and marks them with markers, or creates subclips for the parts in between.
+    The audio levels of the clip thumbnail are used when available, otherwise the audio is decoded
+    at a low sample rate and measured the same way, so that the threshold means the same in both cases.
+ */
+class SilenceDetectTask : public AbstractTask
+{
+public:
+    SilenceDetectTask(const ObjectId &owner, int threshold, int minDuration, int padding, int markersCategory, bool addSubclips, QObject *object);
+    static void start(QObject *object, bool force = false);
+
+protected:
+    void run() override;
+
+private:
+    /** @brief Feed @param detector with the cached audio thumbnail levels, returns false if they are not available */
+    bool readThumbnailLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, SilenceDetector &detector);
+    /** @brief Feed @param detector with levels measured on the decoded audio, returns false on failure */
+    bool readDecodedLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, int lengthInFrames, SilenceDetector &detector);
+
+    int m_threshold;
+    int m_minDuration;
+    int m_padding;
+    int m_markersType;
+    bool m_subClips;
+};
@@ -10,13 +10,16 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "bin/projectclip.h"
 #include "bin/projectitemmodel.h"
 #include "core.h"
+#include "doc/kdenlivedoc.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
 #include "undohelper.hpp"
 
+#include <KLocalizedString>
 #include <KMessageWidget>
 #include <QFuture>
 #include <QThread>
+#include <QTime>
 
 TaskManager::TaskManager(QObject *parent)
     : QObject(parent)
@@ -26,7 +29,7 @@ TaskManager::TaskManager(QObject *parent)
 {
     int maxThreads = qMin(4, QThread::idealThreadCount() - 1);
     m_taskPool.setMaxThreadCount(qMax(maxThreads, 1));
-    m_transcodePool.setMaxThreadCount(KdenliveSettings::proxythreads());
+    m_transcodePool.setMaxThreadCount(transcodeConcurrency());
 }
 
 TaskManager::~TaskManager()
@@ -41,7 +44,76 @@ bool TaskManager::isBlocked() const
 
 void TaskManager::updateConcurrency()
 {
-    m_transcodePool.setMaxThreadCount(KdenliveSettings::proxythreads());
+    m_transcodePool.setMaxThreadCount(transcodeConcurrency());
+}
+
+int TaskManager::transcodeConcurrency() const
+{
+    if (!KdenliveSettings::proxyautothreads()) {
+        return KdenliveSettings::proxythreads();
+    }
+    if (pCore && pCore->currentDoc()) {
+        QString params = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyparams"));
+        if (params.isEmpty()) {
+            params = pCore->currentDoc()->getAutoProxyProfile();
+        }
+        static const QStringList hwEncoders = {QStringLiteral("nvenc"), QStringLiteral("vaapi"), QStringLiteral("qsv"), QStringLiteral("amf"),
+                                               QStringLiteral("videotoolbox")};
+        for (const QString &encoder : hwEncoders) {
+            if (params.contains(encoder)) {
+                // Hardware encoders usually only accept a few concurrent sessions
+                return qMin(2, QThread::idealThreadCount());
+            }
+        }
+    }
+    // Software codecs scale better with several processes of a few threads
+    // than with a single process using all cores
+    return qBound(1, QThread::idealThreadCount() / 2, 8);
+}
+
+int TaskManager::pendingJobCount(AbstractTask::JOBTYPE type) const
+{
+    QReadLocker lk(&m_tasksListLock);
+    int count = 0;
+    for (const auto &task : m_taskList) {
+        for (AbstractTask *t : task.second) {
+            if (t->m_type == type && t->m_progress < 100 && !t->m_isCanceled) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void TaskManager::proxyJobDone(int frames, bool failed)
+{
+    QMutexLocker lk(&m_proxyBatchMutex);
+    if (failed) {
+        m_proxyBatchFailures++;
+    } else if (frames > 0) {
+        m_proxyBatchClips++;
+        m_proxyBatchFrames += frames;
+    }
+    // The calling job is still listed, with its progress set to 100
+    if (pendingJobCount(AbstractTask::PROXYJOB) > 0 || !m_proxyBatchTimer.isValid()) {
+        return;
+    }
+    qint64 elapsed = qMax(Q_INT64_C(1), m_proxyBatchTimer.elapsed());
+    if (m_proxyBatchClips + m_proxyBatchFailures > 1) {
+        double fps = 1000. * double(m_proxyBatchFrames) / double(elapsed);
+        const QString duration = QTime(0, 0).addMSecs(int(elapsed)).toString(QStringLiteral("hh:mm:ss"));
+        QString message = i18n("%1 proxy clips created in %2 (%3 frames per second)", m_proxyBatchClips, duration, QString::number(fps, 'f', 1));
+        if (m_proxyBatchFailures > 0) {
+            message.append(QLatin1Char(' '));
+            message.append(i18np("%1 proxy clip failed.", "%1 proxy clips failed.", m_proxyBatchFailures));
+        }
+        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection, Q_ARG(QString, message),
+                                  Q_ARG(int, int(m_proxyBatchFailures > 0 ? KMessageWidget::Warning : KMessageWidget::Information)));
+    }
+    m_proxyBatchTimer.invalidate();
+    m_proxyBatchClips = 0;
+    m_proxyBatchFailures = 0;
+    m_proxyBatchFrames = 0;
 }
 
 void TaskManager::discardJobs(const ObjectId &owner, AbstractTask::JOBTYPE type, bool softDelete, const QVector<AbstractTask::JOBTYPE> exceptions)
@@ -159,8 +231,17 @@ void TaskManager::taskDone(int cid, AbstractTask *task)
     if (m_taskList[cid].size() == 0) {
         m_taskList.erase(cid);
     }
+    bool proxyJob = task->m_type == AbstractTask::PROXYJOB;
     task->deleteLater();
     m_tasksListLock.unlock();
+    if (proxyJob && pendingJobCount(AbstractTask::PROXYJOB) == 0) {
+        // Also reset the statistics when the last jobs were canceled
+        QMutexLocker lk(&m_proxyBatchMutex);
+        m_proxyBatchTimer.invalidate();
+        m_proxyBatchClips = 0;
+        m_proxyBatchFailures = 0;
+        m_proxyBatchFrames = 0;
+    }
     QMetaObject::invokeMethod(this, "updateJobCount");
 }
 
@@ -210,6 +291,14 @@ void TaskManager::startTask(int ownerId, AbstractTask *task)
         delete task;
         return;
     }
+    if (task->m_type == AbstractTask::PROXYJOB) {
+        QMutexLocker lk(&m_proxyBatchMutex);
+        if (!m_proxyBatchTimer.isValid()) {
+            // First job of a proxy batch, the proxy encoder may have changed
+            m_proxyBatchTimer.start();
+            m_transcodePool.setMaxThreadCount(transcodeConcurrency());
+        }
+    }
     m_tasksListLock.lockForWrite();
     if (m_taskList.find(ownerId) == m_taskList.end()) {
         // First task for this clip
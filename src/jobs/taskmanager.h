@@ -12,7 +12,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "definitions.h"
 
 #include <QAbstractListModel>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
+#include <QMutex>
 #include <QObject>
 #include <QReadWriteLock>
 #include <QThreadPool>
@@ -65,6 +67,16 @@ public:
     /** @brief Update the number of concurrent jobs allowed */
     void updateConcurrency();
 
+    /** @brief The number of concurrent proxy and transcode jobs */
+    int transcodeConcurrency() const;
+
+    /** @brief The number of pending or running jobs of @param type, all clips included */
+    int pendingJobCount(AbstractTask::JOBTYPE type) const;
+
+    /** @brief Account a finished proxy job of @param frames frames in the current batch throughput, or a
+     *  failed one if @param failed is true, and report the batch statistics when it was the last one */
+    void proxyJobDone(int frames, bool failed = false);
+
     /** @brief We are aborting all tasks and don't want them to send any updates */
     bool isBlocked() const;
 
@@ -88,6 +100,12 @@ private:
     std::unordered_map<int, std::vector<AbstractTask*> > m_taskList;
     mutable QReadWriteLock m_tasksListLock;
     bool m_blockUpdates;
+    /** @brief Statistics of the current proxy batch */
+    QMutex m_proxyBatchMutex;
+    QElapsedTimer m_proxyBatchTimer;
+    int m_proxyBatchClips{0};
+    int m_proxyBatchFailures{0};
+    qint64 m_proxyBatchFrames{0};
 
 Q_SIGNALS:
     void jobCount(int);
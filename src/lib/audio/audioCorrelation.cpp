@@ -9,6 +9,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kdenlive_debug.h"
 #include "klocalizedstring.h"
 #include <QElapsedTimer>
+#include <QtConcurrent>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -22,6 +24,12 @@ AudioCorrelation::AudioCorrelation(std::unique_ptr<AudioEnvelope> mainTrackEnvel
 
 AudioCorrelation::~AudioCorrelation()
 {
+    for (QFutureWatcher<AudioCorrelationInfo *> *watcher : qAsConst(m_runningCorrelations)) {
+        watcher->waitForFinished();
+        delete watcher->result();
+        delete watcher;
+    }
+    qDeleteAll(m_waitingChildren);
     for (AudioEnvelope *envelope : qAsConst(m_children)) {
         delete envelope;
     }
@@ -35,47 +43,161 @@ AudioCorrelation::~AudioCorrelation()
 void AudioCorrelation::slotAnnounceEnvelope()
 {
     Q_EMIT displayMessage(i18n("Audio analysis finished"), OperationCompletedMessage, 300);
+    m_mainReady = true;
+    // Children that were ready before the reference can now be processed
+    const QList<AudioEnvelope *> waiting = m_waitingChildren;
+    m_waitingChildren.clear();
+    for (AudioEnvelope *envelope : waiting) {
+        startCorrelation(envelope);
+    }
 }
 
 void AudioCorrelation::addChild(AudioEnvelope *envelope)
 {
-    // We need to connect before starting the computation, to make sure
-    // there is no race condition where the signal 'envelopeReady' is
-    // lost.
-    Q_ASSERT(!envelope->hasComputationStarted());
-    connect(envelope, &AudioEnvelope::envelopeReady, this, &AudioCorrelation::slotProcessChild);
-    envelope->startComputeEnvelope();
+    addChildren({envelope});
+}
+
+void AudioCorrelation::addChildren(const QList<AudioEnvelope *> &envelopes)
+{
+    m_pendingChildren += envelopes.size();
+    for (AudioEnvelope *envelope : envelopes) {
+        // We need to connect before starting the computation, to make sure
+        // there is no race condition where the signal 'envelopeReady' is
+        // lost.
+        Q_ASSERT(!envelope->hasComputationStarted());
+        connect(envelope, &AudioEnvelope::envelopeReady, this, &AudioCorrelation::slotProcessChild);
+        envelope->startComputeEnvelope();
+    }
 }
 
 void AudioCorrelation::slotProcessChild(AudioEnvelope *envelope)
 {
-    // Note that at this point the computation of the envelope of the
-    // main track might not be finished. envelope() will block until
-    // the computation is done.
-    const size_t sizeMain = m_mainTrackEnvelope->envelope().size();
-    const size_t sizeSub = envelope->envelope().size();
+    if (!m_mainReady) {
+        // Don't block a worker thread waiting for the reference envelope
+        m_waitingChildren.append(envelope);
+        return;
+    }
+    startCorrelation(envelope);
+}
 
-    auto *info = new AudioCorrelationInfo(sizeMain, sizeSub);
-    qint64 *correlation = info->correlationVector();
+void AudioCorrelation::startCorrelation(AudioEnvelope *envelope)
+{
+    auto *watcher = new QFutureWatcher<AudioCorrelationInfo *>();
+    m_runningCorrelations.append(watcher);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, envelope]() {
+        m_runningCorrelations.removeAll(watcher);
+        AudioCorrelationInfo *info = watcher->result();
+        watcher->deleteLater();
+        m_children.append(envelope);
+        m_correlations.append(info);
+        Q_ASSERT(m_correlations.size() == m_children.size());
+        int shift = getShift(m_children.size() - 1);
+        Q_EMIT gotAudioAlignData(envelope->clipId(), shift);
+        m_batchShifts.insert(envelope->clipId(), shift);
+        m_batchRemainders.insert(envelope->clipId(), getSubFrameShift(m_children.size() - 1) - shift);
+        if (--m_pendingChildren == 0) {
+            Q_EMIT gotAudioAlignBatch(m_batchShifts, m_batchRemainders);
+            m_batchShifts.clear();
+            m_batchRemainders.clear();
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([this, envelope]() { return computeCorrelation(envelope); }));
+}
 
+AudioCorrelationInfo *AudioCorrelation::computeCorrelation(AudioEnvelope *envelope)
+{
     const std::vector<qint64> &envMain = m_mainTrackEnvelope->envelope();
     const std::vector<qint64> &envSub = envelope->envelope();
+    const size_t sizeMain = envMain.size();
+    const size_t sizeSub = envSub.size();
+
+    auto *info = new AudioCorrelationInfo(sizeMain, sizeSub);
+    qint64 *correlation = info->correlationVector();
     qint64 max = 0;
 
     if (sizeSub > 200) {
-        FFTCorrelation::correlate(&envMain[0], sizeMain, &envSub[0], sizeSub, correlation);
+        const size_t fftSize = FFTCorrelation::fftSize(sizeMain, sizeSub);
+        m_spectrumMutex.lock();
+        auto spectrum = m_referenceSpectra.find(fftSize);
+        if (spectrum == m_referenceSpectra.end()) {
+            spectrum = m_referenceSpectra.emplace(fftSize, FFTCorrelation::spectrum(&envMain[0], sizeMain, fftSize)).first;
+        }
+        m_spectrumMutex.unlock();
+        // std::map elements are never moved, so the reference stays valid while other sizes are added
+        FFTCorrelation::correlate(spectrum->second, &envSub[0], sizeSub, correlation);
     } else {
         correlate(&envMain[0], sizeMain, &envSub[0], sizeSub, correlation, &max);
         info->setMax(max);
     }
+    info->setSubFrameOffset(refineShift(envelope, int(info->maxIndex()) - int(sizeSub)));
+    return info;
+}
 
-    m_children.append(envelope);
-    m_correlations.append(info);
+double AudioCorrelation::refineShift(AudioEnvelope *envelope, int coarseShift)
+{
+    // Half a second of audio is enough to get a sharp correlation peak
+    const int frequency = 48000;
+    const double fps = envelope->fps();
+    const int windowFrames = qMax(2, qRound(fps / 2));
+    const std::vector<qint64> &envSub = envelope->envelope();
+    const int sizeSub = int(envSub.size());
+    const int sizeMain = int(m_mainTrackEnvelope->envelope().size());
+    if (sizeSub < windowFrames) {
+        return 0.;
+    }
+    // Use the loudest part of the clip, transients give the best precision
+    int loudest = int(std::max_element(envSub.begin(), envSub.end()) - envSub.begin());
+    int start = qBound(0, loudest - windowFrames / 2, sizeSub - windowFrames);
+    // Search one frame before and after the match found on the envelopes
+    int mainStart = start + coarseShift - 1;
+    if (mainStart < 0 || mainStart + windowFrames + 2 > sizeMain) {
+        return 0.;
+    }
+    int margin = 0;
+    const std::vector<qint64> sub = envelope->loadSamples(size_t(start), size_t(windowFrames), frequency);
+    const std::vector<qint64> main = m_mainTrackEnvelope->loadSamples(size_t(mainStart), size_t(windowFrames + 2), frequency, &margin);
+    if (sub.empty() || main.size() < sub.size() + size_t(2 * margin)) {
+        return 0.;
+    }
+    double lag = fineLag(main, sub, margin, margin);
+    double offset = qBound(-1., lag * fps / frequency, 1.);
+    qCDebug(KDENLIVE_LOG) << "Audio alignment refined by" << offset << "frame for clip" << envelope->clipId();
+    return offset;
+}
 
-    Q_ASSERT(m_correlations.size() == m_children.size());
-    int index = m_children.indexOf(envelope);
-    int shift = getShift(index);
-    Q_EMIT gotAudioAlignData(envelope->clipId(), shift);
+double AudioCorrelation::fineLag(const std::vector<qint64> &main, const std::vector<qint64> &sub, int expected, int maxLag)
+{
+    const size_t sizeMain = main.size();
+    const size_t sizeSub = sub.size();
+    if (sizeSub == 0 || sizeMain < sizeSub) {
+        return 0.;
+    }
+    std::vector<float> correlation(sizeMain + sizeSub + 1);
+    FFTCorrelation::correlate(&main[0], sizeMain, &sub[0], sizeSub, &correlation[0]);
+    // correlation[sizeSub + shift] is the match of sub[0] with main[shift]
+    const int first = qMax(0, expected - maxLag);
+    const int last = qMin(int(sizeMain - sizeSub), expected + maxLag);
+    if (last < first) {
+        return 0.;
+    }
+    int best = first;
+    for (int shift = first; shift <= last; ++shift) {
+        if (correlation[sizeSub + size_t(shift)] > correlation[sizeSub + size_t(best)]) {
+            best = shift;
+        }
+    }
+    double lag = best - expected;
+    // Parabolic interpolation around the peak
+    if (best > 0 && size_t(best) + 1 <= sizeMain - sizeSub) {
+        const float left = correlation[sizeSub + size_t(best) - 1];
+        const float center = correlation[sizeSub + size_t(best)];
+        const float right = correlation[sizeSub + size_t(best) + 1];
+        const float denominator = left - 2 * center + right;
+        if (denominator < 0) {
+            lag += 0.5 * (left - right) / denominator;
+        }
+    }
+    return lag;
 }
 
 int AudioCorrelation::getShift(int childIndex) const
@@ -90,6 +212,11 @@ int AudioCorrelation::getShift(int childIndex) const
     return int(indexOffset);
 }
 
+double AudioCorrelation::getSubFrameShift(int childIndex) const
+{
+    return getShift(childIndex) + m_correlations.at(childIndex)->subFrameOffset();
+}
+
 AudioCorrelationInfo const *AudioCorrelation::info(int childIndex) const
 {
     Q_ASSERT(childIndex >= 0);
@@ -10,7 +10,12 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "audioCorrelationInfo.h"
 #include "audioEnvelope.h"
 #include "definitions.h"
+#include "fftCorrelation.h"
+#include <QFutureWatcher>
 #include <QList>
+#include <QMap>
+#include <QMutex>
+#include <map>
 
 /**
   This class does the correlation between two tracks
@@ -49,8 +54,36 @@ public:
       */
     void addChild(AudioEnvelope *envelope);
 
+    /**
+      Adds several child envelopes at once. Their envelopes are computed
+      concurrently, and each one is correlated in a worker thread as soon
+      as it is ready. When all pending children are aligned, the signal
+      gotAudioAlignBatch is emitted with the shift of every clip and its
+      sub frame remainder, so that the caller can apply them in a single
+      operation.
+
+      This object will take ownership of the passed envelopes.
+      */
+    void addChildren(const QList<AudioEnvelope *> &envelopes);
+
     const AudioCorrelationInfo *info(int childIndex) const;
+    /**
+      Returns the shift of a child, in frames, as found by the frame level
+      correlation of the envelopes.
+      */
     int getShift(int childIndex) const;
+    /**
+      Returns the shift of a child, in frames, with sub frame precision.
+      The result of getShift() is refined by correlating the audio samples
+      of a short window, so it differs from it by less than a frame.
+      */
+    double getSubFrameShift(int childIndex) const;
+
+    /**
+      Returns the position of \c sub in \c main with sub sample precision,
+      relative to \c expected and searched in [-maxLag, maxLag].
+      */
+    static double fineLag(const std::vector<qint64> &main, const std::vector<qint64> &sub, int expected, int maxLag);
 
     /**
       Correlates the two vectors envMain and envSub.
@@ -64,6 +97,28 @@ private:
     QList<AudioEnvelope *> m_children;
     QList<AudioCorrelationInfo *> m_correlations;
 
+    /** Children whose envelope was computed before the reference one */
+    QList<AudioEnvelope *> m_waitingChildren;
+    bool m_mainReady{false};
+    /** Number of children added but not aligned yet */
+    int m_pendingChildren{0};
+    /** Shift of the children aligned since the last batch signal, by clip id */
+    QMap<int, int> m_batchShifts;
+    /** Sub frame offset to add to the shift of the children of the current batch, by clip id */
+    QMap<int, double> m_batchRemainders;
+    QList<QFutureWatcher<AudioCorrelationInfo *> *> m_runningCorrelations;
+
+    /** The reference envelope spectrum is only computed once per FFT size */
+    std::map<size_t, FFTCorrelation::Spectrum> m_referenceSpectra;
+    QMutex m_spectrumMutex;
+
+    /** Starts the correlation of @p envelope in a worker thread */
+    void startCorrelation(AudioEnvelope *envelope);
+    /** Correlates @p envelope with the reference, called from worker threads */
+    AudioCorrelationInfo *computeCorrelation(AudioEnvelope *envelope);
+    /** Returns the sub frame offset to add to the frame shift @p coarseShift between @p envelope and the reference */
+    double refineShift(AudioEnvelope *envelope, int coarseShift);
+
 private Q_SLOTS:
     /**
      This is invoked when the child envelope is computed. This
@@ -77,5 +132,6 @@ private Q_SLOTS:
 
 Q_SIGNALS:
     void gotAudioAlignData(int, int);
+    void gotAudioAlignBatch(const QMap<int, int> &shifts, const QMap<int, double> &remainders);
     void displayMessage(const QString &, MessageType, int);
 };
@@ -11,6 +11,7 @@ AudioCorrelationInfo::AudioCorrelationInfo(size_t mainSize, size_t subSize)
     : m_mainSize(mainSize)
     , m_subSize(subSize)
     , m_max(-1)
+    , m_subFrameOffset(0.)
 {
     m_correlationVector = new qint64[m_mainSize + m_subSize + 1];
 }
@@ -46,6 +47,16 @@ qint64 AudioCorrelationInfo::max() const
     return m_max;
 }
 
+double AudioCorrelationInfo::subFrameOffset() const
+{
+    return m_subFrameOffset;
+}
+
+void AudioCorrelationInfo::setSubFrameOffset(double offset)
+{
+    m_subFrameOffset = offset;
+}
+
 size_t AudioCorrelationInfo::maxIndex() const
 {
     qint64 max = 0;
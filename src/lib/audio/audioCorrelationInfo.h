@@ -38,6 +38,13 @@ public:
       */
     size_t maxIndex() const;
 
+    /**
+      Offset in frames (between -1 and 1) to add to the shift given by maxIndex(),
+      found by correlating audio samples around the best match.
+      */
+    double subFrameOffset() const;
+    void setSubFrameOffset(double offset);
+
     QImage toImage(size_t height = 400) const;
 
 private:
@@ -46,4 +53,5 @@ private:
 
     qint64 *m_correlationVector;
     qint64 m_max;
+    double m_subFrameOffset;
 };
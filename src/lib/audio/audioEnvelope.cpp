@@ -6,10 +6,12 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 */
 
 #include "audioEnvelope.h"
+#include "audioReader.h"
 #include "audioStreamInfo.h"
 #include "bin/bin.h"
 #include "bin/projectclip.h"
 #include "core.h"
+#include "jobs/audiolevelstask.h"
 #include "kdenlive_debug.h"
 #include <KLocalizedString>
 #include <QElapsedTimer>
@@ -31,6 +33,12 @@ AudioEnvelope::AudioEnvelope(const QString &binId, int clipId, size_t offset, si
         m_producer->set_in_and_out(int(offset), int(offset + length));
     }
     m_envelopeSize = size_t(m_producer->get_playtime());
+    if (clip->audioThumbCreated()) {
+        // The audio thumbnail already has one level per frame, much faster than decoding the clip again
+        m_cachedLevels = clip->audioFrameCache();
+        int length = m_producer->get_length();
+        m_cachedChannels = length > 0 ? m_cachedLevels.size() / length : 0;
+    }
 
     m_producer->set("set.test_image", 1);
     connect(&m_watcher, &QFutureWatcherBase::finished, this, [this] { Q_EMIT envelopeReady(this); });
@@ -103,24 +111,36 @@ AudioEnvelope::AudioSummary AudioEnvelope::loadAndNormalizeEnvelope() const
         return summary;
     }
     int samplingRate = m_info->info(0)->samplingRate();
-    mlt_audio_format format_s16 = mlt_audio_s16;
-    int channels = 1;
 
     QElapsedTimer t;
     t.start();
-    m_producer->seek(0);
     size_t max = summary.audioAmplitudes.size();
-    for (size_t i = 0; i < max; ++i) {
-        std::unique_ptr<Mlt::Frame> frame(m_producer->get_frame(int(i)));
-        qint64 position = mlt_frame_get_position(frame->get_frame());
-        int samples = mlt_audio_calculate_frame_samples(float(m_producer->get_fps()), samplingRate, position);
-        auto *data = static_cast<qint16 *>(frame->get_audio(format_s16, samplingRate, channels, samples));
-
-        summary.audioAmplitudes[i] = 0;
-        for (int k = 0; k < samples; ++k) {
-            summary.audioAmplitudes[i] += abs(data[k]);
+    // Both sources use the level of the audio thumbnails, averaged over the channels, so that
+    // envelopes built from the cache and from decoding can be correlated together
+    if (m_cachedChannels > 0) {
+        const size_t in = size_t(m_producer->get_in());
+        for (size_t i = 0; i < max; ++i) {
+            qint64 sum = 0;
+            const int index = int(in + i) * m_cachedChannels;
+            for (int c = 0; c < m_cachedChannels && index + c < m_cachedLevels.size(); ++c) {
+                sum += m_cachedLevels.at(index + c);
+            }
+            summary.audioAmplitudes[i] = sum / m_cachedChannels;
+        }
+    } else {
+        const int channels = qMax(1, m_info->info(0)->channels());
+        AudioReader reader(*m_producer.get(), -1, samplingRate, channels);
+        reader.open(m_producer->get_in());
+        std::vector<qint16> samples;
+        for (size_t i = 0; i < max; ++i) {
+            int count = reader.readFrame(samples);
+            qint64 sum = 0;
+            for (int c = 0; count > 0 && c < channels; ++c) {
+                sum += qint64(256 * qMin(AudioLevelsTask::audioLevel(samples.data() + c, count, channels) * 0.9, 1.0));
+            }
+            summary.audioAmplitudes[i] = sum / channels;
+            pCore->displayMessage(i18n("Processing data analysis"), ProcessingJobMessage, int(100 * i / max));
         }
-        pCore->displayMessage(i18n("Processing data analysis"), ProcessingJobMessage, int(100 * i / max));
     }
     qCDebug(KDENLIVE_LOG) << "Calculating the envelope (" << m_envelopeSize << " frames) took " << t.elapsed() << " ms.";
     qCDebug(KDENLIVE_LOG) << "Normalizing envelope …";
@@ -137,6 +157,29 @@ AudioEnvelope::AudioSummary AudioEnvelope::loadAndNormalizeEnvelope() const
     return summary;
 }
 
+std::vector<qint64> AudioEnvelope::loadSamples(size_t start, size_t frames, int frequency, int *firstFrameSamples) const
+{
+    std::vector<qint64> samples;
+    AudioReader reader(*m_producer.get(), -1, frequency, 1);
+    if (!reader.open(m_producer->get_in() + int(start))) {
+        return samples;
+    }
+    std::vector<qint16> buffer;
+    for (size_t i = 0; i < frames; ++i) {
+        int count = reader.readFrame(buffer);
+        if (i == 0 && firstFrameSamples) {
+            *firstFrameSamples = count;
+        }
+        samples.insert(samples.end(), buffer.begin(), buffer.begin() + count);
+    }
+    return samples;
+}
+
+double AudioEnvelope::fps() const
+{
+    return m_producer->get_fps();
+}
+
 int AudioEnvelope::clipId() const
 {
     return m_clipId;
@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "audioInfo.h"
 #include <QFutureWatcher>
+#include <QVector>
 #include <QObject>
 #include <memory>
 #include <mlt++/Mlt.h>
@@ -18,8 +19,8 @@ class QImage;
 
 /**
   The audio envelope is a simplified version of an audio track
-  with frame resolution. One entry is calculated by the sum
-  of the absolute values of all samples in the current frame.
+  with frame resolution. One entry is the audio thumbnail level
+  of the current frame, averaged over the channels.
 
   See also: http://web.archive.org/web/20180626235917/http://bemasc.net/wordpress/2011/07/26/an-auto-aligner-for-pitivi/
   */
@@ -51,6 +52,16 @@ public:
 
     QImage drawEnvelope();
 
+    /**
+       Decodes the mono audio samples of \c frames envelope entries
+       starting at entry \c start, at the given \c frequency.
+       If \c firstFrameSamples is set, it receives the number of
+       samples of the first frame. Each call uses its own
+       decoder, so it can be called from several threads.
+    */
+    std::vector<qint64> loadSamples(size_t start, size_t frames, int frequency, int *firstFrameSamples = nullptr) const;
+    double fps() const;
+
     size_t offset();
 
     void dumpInfo();
@@ -67,8 +78,8 @@ private:
         }
         AudioSummary() = default;
         // This is the envelope data. There is one element for each
-        // frame, which contains the sum of the absolute amplitudes of
-        // the audio signal for that frame.
+        // frame, which contains the level of the audio signal for
+        // that frame, on the scale of the audio thumbnails.
         std::vector<qint64> audioAmplitudes;
         // Maximum absolute value of the elements in 'audioAmplitudes'.
         qint64 amplitudeMax = 0;
@@ -87,6 +98,9 @@ private:
 
     std::shared_ptr<Mlt::Producer> m_producer;
     std::unique_ptr<AudioInfo> m_info;
+    /** The audio thumbnail levels of the clip (one value per frame and channel), used instead of decoding when available */
+    QVector<uint8_t> m_cachedLevels;
+    int m_cachedChannels{0};
     QFutureWatcher<AudioSummary> m_watcher;
     QFuture<AudioSummary> m_audioSummary;
 
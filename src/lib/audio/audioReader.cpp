@@ -0,0 +1,239 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "audioReader.h"
+#include "core.h"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+
+#include <QAtomicInt>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <mlt++/Mlt.h>
+
+// Maximum time to wait for FFmpeg output before giving up
+static const int readTimeout = 30000;
+
+AudioReader::AudioReader(Mlt::Producer &producer, int stream, int frequency, int channels)
+    : m_resource(QString::fromUtf8(producer.parent().get("resource")))
+    , m_service(QString::fromUtf8(producer.parent().get("mlt_service")))
+    , m_stream(stream)
+    , m_frequency(frequency)
+    , m_channels(channels)
+    , m_fps(producer.get_fps())
+    , m_length(producer.parent().get_length())
+{
+    if (m_service == QLatin1String("avformat-novalidate")) {
+        m_service = QStringLiteral("avformat");
+    } else if (m_service.startsWith(QLatin1String("xml"))) {
+        m_service = QStringLiteral("xml-nogl");
+    }
+    Mlt::Producer parent = producer.parent();
+    int streams = parent.get_int("meta.media.nb_streams");
+    for (int ix = 0; ix < streams; ++ix) {
+        QByteArray propertyName = QStringLiteral("meta.media.%1.stream.type").arg(ix).toLocal8Bit();
+        if (QString(parent.get(propertyName.constData())) == QLatin1String("audio")) {
+            m_audioStreams << ix;
+        }
+    }
+    if (m_stream < 0 && parent.get_int("audio_index") >= 0) {
+        // Use the stream selected in the clip
+        m_stream = parent.get_int("audio_index");
+    }
+}
+
+AudioReader::AudioReader(Mlt::Producer &producer, const QMap<int, int> &streams, int frequency)
+    : AudioReader(producer, streams.isEmpty() ? -1 : streams.firstKey(), frequency, 0)
+{
+    m_streams = streams;
+    for (int channels : streams) {
+        m_channels += channels;
+    }
+}
+
+AudioReader::~AudioReader()
+{
+    close();
+}
+
+bool AudioReader::decodeStreams(Mlt::Producer &producer, const QMap<int, int> &streams, int frequency, int lengthInFrames,
+                                const std::function<void(AudioReader &, const QMap<int, int> &, int)> &process)
+{
+    if (streams.size() > 1) {
+        AudioReader reader(producer, streams, frequency);
+        if (reader.open()) {
+            // All streams are decoded in a single pass
+            process(reader, streams, lengthInFrames);
+            return true;
+        }
+    }
+    // Each stream needs its own reader, process them concurrently
+    const QList<int> keys = streams.keys();
+    const int totalFrames = lengthInFrames * keys.size();
+    QAtomicInt failed;
+    QtConcurrent::blockingMap(keys, [&](int stream) {
+        AudioReader streamReader(producer, stream, frequency, streams.value(stream));
+        if (!streamReader.open()) {
+            failed.storeRelaxed(1);
+            return;
+        }
+        process(streamReader, {{stream, streams.value(stream)}}, totalFrames);
+    });
+    return failed.loadRelaxed() == 0;
+}
+
+bool AudioReader::isDirect() const
+{
+    return m_process != nullptr;
+}
+
+bool AudioReader::canUseFFmpeg() const
+{
+    return m_service == QLatin1String("avformat") && QFileInfo(KdenliveSettings::ffmpegpath()).isFile() && QFileInfo::exists(m_resource);
+}
+
+QString AudioReader::ffmpegStream(int stream) const
+{
+    // FFmpeg counts audio streams separately, like in AudioStreamInfo::setAudioIndex
+    int ffmpegIndex = m_audioStreams.indexOf(stream);
+    return QStringLiteral("0:a:%1").arg(qMax(0, ffmpegIndex));
+}
+
+bool AudioReader::open(int frame)
+{
+    close();
+    m_position = frame;
+    const bool multiStream = m_streams.size() > 1;
+    if (canUseFFmpeg()) {
+        const double start = double(mlt_audio_calculate_samples_to_position(float(m_fps), m_frequency, frame)) / m_frequency;
+        QStringList args = {QStringLiteral("-hide_banner"), QStringLiteral("-nostdin"), QStringLiteral("-loglevel"), QStringLiteral("error")};
+        if (frame > 0) {
+            // Like MLT, FFmpeg seeks relative to the start time of the file
+            args << QStringLiteral("-ss") << QString::number(start, 'f', 6);
+        }
+        args << QStringLiteral("-i") << m_resource;
+        if (multiStream) {
+            // Merge all streams in one, so that the file is only demuxed once.
+            // amerge stops with the shortest input, pad the streams to the clip duration
+            const QString duration = QString::number(qMax(0, m_length - frame) / m_fps, 'f', 6);
+            QStringList filters;
+            QString inputs;
+            int ix = 0;
+            for (auto it = m_streams.cbegin(); it != m_streams.cend(); ++it, ++ix) {
+                filters << QStringLiteral("[%1]aresample=%2:async=1:first_pts=0,apad=whole_dur=%3[a%4]")
+                               .arg(ffmpegStream(it.key()))
+                               .arg(m_frequency)
+                               .arg(duration)
+                               .arg(ix);
+                inputs.append(QStringLiteral("[a%1]").arg(ix));
+            }
+            filters << QStringLiteral("%1amerge=inputs=%2[out]").arg(inputs).arg(m_streams.size());
+            args << QStringLiteral("-filter_complex") << filters.join(QLatin1Char(';')) << QStringLiteral("-map") << QStringLiteral("[out]");
+        } else {
+            // Pad the start with silence if the audio starts after the video, so that samples are aligned on frames like with MLT
+            args << QStringLiteral("-map") << ffmpegStream(m_stream) << QStringLiteral("-ac") << QString::number(m_channels) << QStringLiteral("-af")
+                 << QStringLiteral("aresample=%1:async=1:first_pts=0").arg(m_frequency);
+        }
+        args << QStringLiteral("-vn") << QStringLiteral("-sn") << QStringLiteral("-dn") << QStringLiteral("-f") << QStringLiteral("s16le")
+             << QStringLiteral("-");
+        m_process = std::make_unique<QProcess>();
+        m_process->setReadChannel(QProcess::StandardOutput);
+        m_process->setStandardErrorFile(QProcess::nullDevice());
+        m_process->start(KdenliveSettings::ffmpegpath(), args, QIODevice::ReadOnly);
+        // FFmpeg starts even if it cannot decode the file, only trust it once it outputs samples
+        if (m_process->waitForStarted() && (m_process->bytesAvailable() > 0 || m_process->waitForReadyRead(readTimeout))) {
+            return true;
+        }
+        qCDebug(KDENLIVE_LOG) << "Cannot decode audio with FFmpeg for analysis, using MLT";
+        close();
+    }
+    if (multiStream) {
+        // MLT producers only output one audio stream
+        return false;
+    }
+    m_producer = std::make_unique<Mlt::Producer>(pCore->getProjectProfile(), m_service.toUtf8().constData(), m_resource.toUtf8().constData());
+    if (!m_producer->is_valid()) {
+        m_producer.reset();
+        return false;
+    }
+    if (m_service == QLatin1String("avformat")) {
+        m_producer->set("video_index", -1);
+        if (m_stream >= 0) {
+            m_producer->set("audio_index", m_stream);
+        }
+    }
+    Mlt::Filter chans(pCore->getProjectProfile(), "audiochannels");
+    Mlt::Filter converter(pCore->getProjectProfile(), "audioconvert");
+    m_producer->attach(chans);
+    m_producer->attach(converter);
+    m_producer->seek(frame);
+    return true;
+}
+
+void AudioReader::close()
+{
+    if (m_process) {
+        m_process->kill();
+        m_process->waitForFinished();
+        m_process.reset();
+    }
+    m_producer.reset();
+}
+
+qint64 AudioReader::readBytes(char *data, qint64 bytes)
+{
+    qint64 total = 0;
+    while (total < bytes) {
+        qint64 read = m_process->read(data + total, bytes - total);
+        if (read < 0) {
+            break;
+        }
+        total += read;
+        if (total < bytes && m_process->bytesAvailable() == 0 && !m_process->waitForReadyRead(readTimeout)) {
+            if (m_process->state() != QProcess::NotRunning) {
+                qCDebug(KDENLIVE_LOG) << "FFmpeg audio decoding timed out";
+            }
+            // End of stream
+            break;
+        }
+    }
+    return total;
+}
+
+int AudioReader::readFrame(std::vector<qint16> &buffer)
+{
+    int samples = mlt_audio_calculate_frame_samples(float(m_fps), m_frequency, m_position);
+    if (m_process) {
+        buffer.resize(size_t(samples * m_channels));
+        const qint64 frameBytes = qint64(buffer.size() * sizeof(qint16));
+        qint64 read = readBytes(reinterpret_cast<char *>(buffer.data()), frameBytes);
+        if (read <= 0) {
+            return 0;
+        }
+        m_position++;
+        samples = int(read / qint64(m_channels * sizeof(qint16)));
+        buffer.resize(size_t(samples * m_channels));
+        return samples;
+    }
+    if (!m_producer || m_position >= m_producer->get_length()) {
+        return 0;
+    }
+    std::unique_ptr<Mlt::Frame> frame(m_producer->get_frame());
+    m_position++;
+    buffer.assign(size_t(samples * m_channels), 0);
+    if (!frame || !frame->is_valid() || frame->get_int("test_audio") != 0) {
+        // No audio for this frame, use silence
+        return samples;
+    }
+    mlt_audio_format format = mlt_audio_s16;
+    int frequency = m_frequency;
+    int channels = m_channels;
+    auto *data = static_cast<qint16 *>(frame->get_audio(format, frequency, channels, samples));
+    if (data == nullptr || channels != m_channels) {
+        return samples;
+    }
+    buffer.assign(data, data + samples * channels);
+    return samples;
+}
@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QProcess>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Mlt {
+class Producer;
+}
+
+/** @class AudioReader
+    @brief Decodes the audio of a clip for analysis tasks (audio thumbnails, envelopes).
+    For files, the audio stream is decoded by an FFmpeg process writing raw interleaved
+    16 bit samples to a pipe, read in large blocks. This skips the video stream and the
+    per frame properties and filters of MLT producers, which dominate the analysis time
+    on long recordings. Other clips (playlists, generators) or a missing FFmpeg fall back
+    to reading audio frames from an MLT producer.
+    Samples are returned frame by frame, with the same frame sizes as MLT would produce.
+ */
+class AudioReader
+{
+public:
+    /** @param producer the clip producer, used to find the resource and frame rate
+        @param stream the audio stream index (as used by MLT's audio_index), -1 for the clip's audio stream */
+    AudioReader(Mlt::Producer &producer, int stream, int frequency, int channels);
+    /** @brief Decode several streams in a single pass, the channels of all streams
+        (given as {stream index, channel count}) are interleaved in stream order.
+        This is only possible with FFmpeg, open() returns false otherwise. */
+    AudioReader(Mlt::Producer &producer, const QMap<int, int> &streams, int frequency);
+    ~AudioReader();
+
+    /** @brief Start decoding at @param frame, returns false if the audio cannot be decoded */
+    bool open(int frame = 0);
+    /** @brief Reads the samples of the next frame into @param buffer, resized to samples * channels.
+        Returns the number of samples per channel, 0 at the end of the stream */
+    int readFrame(std::vector<qint16> &buffer);
+    /** @brief Decode the @param streams {stream index, channels} of @param producer for an analysis task: in a single pass
+        when FFmpeg can merge them, otherwise with one reader per stream running concurrently.
+        @param process is called, possibly from several threads, with each opened reader, the streams it decodes and the
+        number of frames decoded by all readers. Returns false if a stream could not be opened */
+    static bool decodeStreams(Mlt::Producer &producer, const QMap<int, int> &streams, int frequency, int lengthInFrames,
+                              const std::function<void(AudioReader &, const QMap<int, int> &, int)> &process);
+    /** @brief Returns true if the samples are decoded by FFmpeg instead of MLT */
+    bool isDirect() const;
+    void close();
+
+private:
+    QString m_resource;
+    QString m_service;
+    int m_stream;
+    /** @brief The streams decoded together and their channel count */
+    QMap<int, int> m_streams;
+    int m_frequency;
+    int m_channels;
+    double m_fps;
+    /** @brief The clip duration in frames, shorter streams are padded to it */
+    int m_length;
+    int m_position{0};
+    std::unique_ptr<QProcess> m_process;
+    std::unique_ptr<Mlt::Producer> m_producer;
+    /** @brief The MLT indexes of the audio streams, FFmpeg numbers them in this order */
+    QList<int> m_audioStreams;
+    bool canUseFFmpeg() const;
+    /** @brief Returns the FFmpeg stream specifier of the MLT audio stream @param stream */
+    QString ffmpegStream(int stream) const;
+    /** @brief Reads exactly @param bytes from the FFmpeg pipe, or less at the end of the stream */
+    qint64 readBytes(char *data, qint64 bytes);
+};
@@ -126,3 +126,62 @@ void FFTCorrelation::convolve(const float *left, const size_t leftSize, const fl
 
     qCDebug(KDENLIVE_LOG) << "FFT convolution computed. Time taken: " << time.elapsed() << " ms";
 }
+
+size_t FFTCorrelation::fftSize(const size_t leftSize, const size_t rightSize)
+{
+    // Same padding rule as in convolve()
+    size_t largestSize = std::max(leftSize, rightSize);
+    size_t size = 64;
+    while (size / 2 < largestSize) {
+        size = size << 1;
+    }
+    return size;
+}
+
+FFTCorrelation::Spectrum FFTCorrelation::spectrum(const qint64 *values, const size_t size, const size_t fftSize, bool reversed)
+{
+    Spectrum result;
+    result.fftSize = fftSize;
+    result.sourceSize = size;
+    qint64 maxValue = 1;
+    for (size_t i = 0; i < size; ++i) {
+        maxValue = std::max(maxValue, qAbs(values[i]));
+    }
+    std::vector<float> data(fftSize, 0);
+    for (size_t i = 0; i < size; ++i) {
+        data[reversed ? size - 1 - i : i] = float(values[i]) / maxValue;
+    }
+    result.values.resize(2 * (fftSize / 2 + 1));
+    kiss_fftr_cfg fftConfig = kiss_fftr_alloc(int(fftSize), 0, nullptr, nullptr);
+    kiss_fftr(fftConfig, &data[0], reinterpret_cast<kiss_fft_cpx *>(&result.values[0]));
+    kiss_fftr_free(fftConfig);
+    return result;
+}
+
+void FFTCorrelation::correlate(const Spectrum &left, const qint64 *right, const size_t rightSize, qint64 *out_correlated)
+{
+    QElapsedTimer t;
+    t.start();
+    Q_ASSERT(fftSize(left.sourceSize, rightSize) <= left.fftSize);
+    const Spectrum rightSpectrum = spectrum(right, rightSize, left.fftSize, true);
+    const size_t bins = left.fftSize / 2 + 1;
+    std::vector<kiss_fft_cpx> correlatedFFT(bins);
+    const auto *leftFFT = reinterpret_cast<const kiss_fft_cpx *>(&left.values[0]);
+    const auto *rightFFT = reinterpret_cast<const kiss_fft_cpx *>(&rightSpectrum.values[0]);
+    for (size_t i = 0; i < bins; ++i) {
+        correlatedFFT[i].r = leftFFT[i].r * rightFFT[i].r - leftFFT[i].i * rightFFT[i].i;
+        correlatedFFT[i].i = leftFFT[i].r * rightFFT[i].i + leftFFT[i].i * rightFFT[i].r;
+    }
+    std::vector<float> convolved(left.fftSize);
+    kiss_fftr_cfg ifftConfig = kiss_fftr_alloc(int(left.fftSize), 1, nullptr, nullptr);
+    kiss_fftri(ifftConfig, &correlatedFFT[0], &convolved[0]);
+    kiss_fftr_free(ifftConfig);
+
+    // Same layout as the convolve() output
+    const size_t outSize = left.sourceSize + rightSize + 1;
+    out_correlated[0] = 0;
+    for (size_t i = 1; i < outSize; ++i) {
+        out_correlated[i] = qint64(convolved[i - 1]);
+    }
+    qCDebug(KDENLIVE_LOG) << "Correlation (cached FFT) computed in " << t.elapsed() << " ms.";
+}
@@ -6,6 +6,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #pragma once
 
 #include <QtGlobal>
+#include <vector>
+
 /** @class FFTCorrelation
     @brief This class provides methods to calculate convolution
     and correlation of two vectors by means of FFT, which
@@ -30,4 +32,38 @@ public:
     static void correlate(const qint64 *left, const size_t leftSize, const qint64 *right, const size_t rightSize, float *out_correlated);
 
     static void correlate(const qint64 *left, const size_t leftSize, const qint64 *right, const size_t rightSize, qint64 *out_correlated);
+
+    /**
+      Fourier transform of a normalized and zero padded vector, which
+      allows correlating several vectors with the same one while
+      transforming it only once.
+      */
+    struct Spectrum
+    {
+        size_t fftSize = 0;
+        size_t sourceSize = 0;
+        // Interleaved real and imaginary parts, fftSize / 2 + 1 pairs
+        std::vector<float> values;
+    };
+
+    /**
+      Returns the FFT size required to correlate vectors of
+      size \c leftSize and \c rightSize.
+      */
+    static size_t fftSize(const size_t leftSize, const size_t rightSize);
+
+    /**
+      Computes the spectrum of \c values padded to \c fftSize. When \c reversed
+      is true, the vector is reversed first (see correlate()).
+      */
+    static Spectrum spectrum(const qint64 *values, const size_t size, const size_t fftSize, bool reversed = false);
+
+    /**
+      Same as correlate() above, with the left vector given by its
+      precomputed spectrum (see spectrum()). The size of \c right must
+      not exceed the size the spectrum was computed for.
+      \c out_correlated must be a pre-allocated vector of size
+      \c left.sourceSize + \c rightSize + 1.
+      */
+    static void correlate(const Spectrum &left, const qint64 *right, const size_t rightSize, qint64 *out_correlated);
 };
@@ -0,0 +1,247 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "loudnessMeter.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+
+// Length of the true peak interpolation filter for each oversampling phase
+static const int peakTaps = 12;
+static const int oversampling = 4;
+static const quint32 mapMagic = 0x4b444c4e;
+static const quint16 mapVersion = 1;
+
+constexpr double LoudnessMeter::silence;
+
+LoudnessMeter::LoudnessMeter(int frequency, int channels)
+    : m_frequency(frequency)
+    , m_channels(channels)
+    , m_oversample(frequency < 96000)
+{
+    // K-weighting filter coefficients for the sample rate, as given in BS.1770 for 48kHz
+    double f0 = 1681.974450955533;
+    double gain = 3.999843853973347;
+    double q = 0.7071752369554196;
+    double k = std::tan(M_PI * f0 / frequency);
+    double vh = std::pow(10., gain / 20.);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1. + k / q + k * k;
+    m_shelf = {(vh + vb * k / q + k * k) / a0, 2. * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0, 2. * (k * k - 1.) / a0, (1. - k / q + k * k) / a0};
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+    k = std::tan(M_PI * f0 / frequency);
+    a0 = 1. + k / q + k * k;
+    m_highPass = {1., -2., 1., 2. * (k * k - 1.) / a0, (1. - k / q + k * k) / a0};
+
+    m_states.resize(size_t(channels));
+    for (int i = 0; i < channels; ++i) {
+        m_states[size_t(i)].history.assign(peakTaps, 0.);
+        if (channels == 6) {
+            // 5.1 layout: the LFE channel is ignored, surround channels are boosted
+            m_states[size_t(i)].weight = i == 3 ? 0. : (i > 3 ? 1.41 : 1.);
+        }
+    }
+    // Windowed sinc interpolation filter
+    m_phases.assign(oversampling, std::vector<double>(peakTaps, 0.));
+    const int length = oversampling * peakTaps;
+    for (int i = 0; i < length; ++i) {
+        double t = double(i - length / 2) / oversampling;
+        double sinc = t == 0. ? 1. : std::sin(M_PI * t) / (M_PI * t);
+        double window = 0.5 * (1. - std::cos(2. * M_PI * i / length));
+        m_phases[size_t(i % oversampling)][size_t(i / oversampling)] = sinc * window;
+    }
+    m_blockSamples = qMax(1, frequency / 10);
+}
+
+void LoudnessMeter::addSamples(const qint16 *samples, int count, int stride)
+{
+    for (int i = 0; i < count; ++i) {
+        const qint16 *frame = samples + i * stride;
+        for (int c = 0; c < m_channels; ++c) {
+            ChannelState &state = m_states[size_t(c)];
+            double x = frame[c] / 32768.;
+            // K-weighting, two biquads in transposed direct form II
+            double y = m_shelf.b0 * x + state.z[0];
+            state.z[0] = m_shelf.b1 * x - m_shelf.a1 * y + state.z[1];
+            state.z[1] = m_shelf.b2 * x - m_shelf.a2 * y;
+            double w = m_highPass.b0 * y + state.z[2];
+            state.z[2] = m_highPass.b1 * y - m_highPass.a1 * w + state.z[3];
+            state.z[3] = m_highPass.b2 * y - m_highPass.a2 * w;
+            m_blockSum += state.weight * w * w;
+
+            // True peak
+            if (m_oversample) {
+                std::rotate(state.history.rbegin(), state.history.rbegin() + 1, state.history.rend());
+                state.history[0] = x;
+                for (const std::vector<double> &taps : m_phases) {
+                    double value = 0.;
+                    for (int t = 0; t < peakTaps; ++t) {
+                        value += taps[size_t(t)] * state.history[size_t(t)];
+                    }
+                    m_peak = qMax(m_peak, std::abs(value));
+                }
+            } else {
+                m_peak = qMax(m_peak, std::abs(x));
+            }
+        }
+        if (++m_blockPosition == m_blockSamples) {
+            finishBlock();
+        }
+    }
+}
+
+void LoudnessMeter::finishBlock()
+{
+    m_blocks.push_back(m_blockSum / m_blockSamples);
+    m_blockSum = 0.;
+    m_blockPosition = 0;
+    if (m_blocks.size() >= 4) {
+        m_gatingBlocks.push_back(recentEnergy(4));
+    }
+    // Only the blocks of the short-term window are needed
+    if (m_blocks.size() > 30) {
+        m_blocks.erase(m_blocks.begin());
+    }
+}
+
+double LoudnessMeter::recentEnergy(int blocks) const
+{
+    if (m_blocks.empty()) {
+        return 0.;
+    }
+    int count = qMin(blocks, int(m_blocks.size()));
+    double sum = 0.;
+    for (auto it = m_blocks.end() - count; it != m_blocks.end(); ++it) {
+        sum += *it;
+    }
+    return sum / count;
+}
+
+double LoudnessMeter::momentary() const
+{
+    return toLoudness(recentEnergy(4));
+}
+
+double LoudnessMeter::shortTerm() const
+{
+    return toLoudness(recentEnergy(30));
+}
+
+double LoudnessMeter::integrated() const
+{
+    return gatedLoudness(m_gatingBlocks);
+}
+
+double LoudnessMeter::truePeak() const
+{
+    return m_peak > 0. ? qMax(silence, 20. * std::log10(m_peak)) : silence;
+}
+
+double LoudnessMeter::toLoudness(double energy)
+{
+    if (energy <= 0.) {
+        return silence;
+    }
+    return qMax(silence, -0.691 + 10. * std::log10(energy));
+}
+
+double LoudnessMeter::toEnergy(double loudness)
+{
+    return std::pow(10., (loudness + 0.691) / 10.);
+}
+
+double LoudnessMeter::gatedLoudness(const std::vector<double> &energies)
+{
+    const double absoluteGate = toEnergy(-70.);
+    double sum = 0.;
+    int count = 0;
+    for (double e : energies) {
+        if (e > absoluteGate) {
+            sum += e;
+            count++;
+        }
+    }
+    if (count == 0) {
+        return silence;
+    }
+    const double relativeGate = qMax(absoluteGate, toEnergy(toLoudness(sum / count) - 10.));
+    sum = 0.;
+    count = 0;
+    for (double e : energies) {
+        if (e > relativeGate) {
+            sum += e;
+            count++;
+        }
+    }
+    return count == 0 ? silence : toLoudness(sum / count);
+}
+
+bool LoudnessMap::isEmpty() const
+{
+    return shortTerm.isEmpty();
+}
+
+int LoudnessMap::frames() const
+{
+    return shortTerm.size();
+}
+
+double LoudnessMap::shortTermAt(int frame) const
+{
+    if (frame < 0 || frame >= shortTerm.size()) {
+        return LoudnessMeter::silence;
+    }
+    return shortTerm.at(frame) / 100.;
+}
+
+double LoudnessMap::rangeLoudness(int in, int out) const
+{
+    in = qMax(0, in);
+    out = qMin(out, momentary.size());
+    std::vector<double> energies;
+    energies.reserve(size_t(qMax(0, out - in)));
+    for (int i = in; i < out; ++i) {
+        energies.push_back(LoudnessMeter::toEnergy(momentary.at(i) / 100.));
+    }
+    return LoudnessMeter::gatedLoudness(energies);
+}
+
+bool LoudnessMap::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << mapMagic << mapVersion << integrated << truePeak << momentary << shortTerm;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+LoudnessMap LoudnessMap::load(const QString &path)
+{
+    LoudnessMap map;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return map;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+    quint32 magic;
+    quint16 version;
+    in >> magic >> version;
+    if (magic != mapMagic || version != mapVersion) {
+        return map;
+    }
+    in >> map.integrated >> map.truePeak >> map.momentary >> map.shortTerm;
+    if (in.status() != QDataStream::Ok || map.momentary.size() != map.shortTerm.size()) {
+        return LoudnessMap();
+    }
+    return map;
+}
@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <vector>
+
+/** @class LoudnessMeter
+    @brief Measures the loudness of a signal as defined by EBU R128 / ITU-R BS.1770.
+    Samples are K-weighted and summed per 100 ms block, from which the momentary (400 ms),
+    short-term (3 s) and gated integrated loudness are derived. The true peak is estimated
+    by 4x oversampling.
+ */
+class LoudnessMeter
+{
+public:
+    /** @brief Loudness reported for silence, in LUFS */
+    static constexpr double silence = -120.;
+
+    LoudnessMeter(int frequency, int channels);
+
+    /** @brief Process @param count samples per channel, starting at @param samples.
+        @param stride is the number of interleaved channels in the buffer, the channels
+        of this meter being the first ones */
+    void addSamples(const qint16 *samples, int count, int stride);
+
+    /** @brief Loudness of the last 400 ms, in LUFS */
+    double momentary() const;
+    /** @brief Loudness of the last 3 seconds, in LUFS */
+    double shortTerm() const;
+    /** @brief Gated loudness of everything processed so far, in LUFS */
+    double integrated() const;
+    /** @brief Highest true peak found so far, in dBTP */
+    double truePeak() const;
+
+    /** @brief Converts a mean square energy to LUFS */
+    static double toLoudness(double energy);
+    /** @brief Converts LUFS to a mean square energy */
+    static double toEnergy(double loudness);
+    /** @brief Applies the absolute (-70 LUFS) and relative (-10 LU) gates of BS.1770 to @param energies and returns the resulting loudness */
+    static double gatedLoudness(const std::vector<double> &energies);
+
+private:
+    struct Biquad
+    {
+        double b0, b1, b2, a1, a2;
+    };
+    struct ChannelState
+    {
+        // Filter memory of the two K-weighting stages
+        double z[4]{0., 0., 0., 0.};
+        // Last input samples for the true peak interpolation
+        std::vector<double> history;
+        double weight{1.};
+    };
+    /** @brief The energy of the last @param blocks 100 ms blocks */
+    double recentEnergy(int blocks) const;
+    void finishBlock();
+
+    int m_frequency;
+    int m_channels;
+    Biquad m_shelf;
+    Biquad m_highPass;
+    std::vector<ChannelState> m_states;
+    /** @brief Interpolation filter, one row of taps per oversampling phase */
+    std::vector<std::vector<double>> m_phases;
+    bool m_oversample;
+    int m_blockSamples;
+    int m_blockPosition{0};
+    double m_blockSum{0.};
+    /** @brief Energy of each 100 ms block */
+    std::vector<double> m_blocks;
+    /** @brief Energy of each complete 400 ms gating block, overlapping by 75% */
+    std::vector<double> m_gatingBlocks;
+    double m_peak{0.};
+};
+
+/** @class LoudnessMap
+    @brief The loudness analysis of a clip's audio stream, with one momentary and
+    short-term value per frame stored in hundredths of LU.
+ */
+class LoudnessMap
+{
+public:
+    double integrated{LoudnessMeter::silence};
+    double truePeak{LoudnessMeter::silence};
+    QVector<qint16> momentary;
+    QVector<qint16> shortTerm;
+
+    bool isEmpty() const;
+    int frames() const;
+    /** @brief Short-term loudness at @param frame, in LUFS */
+    double shortTermAt(int frame) const;
+    /** @brief Gated loudness of the frames in [@param in, @param out[, estimated from the momentary values */
+    double rangeLoudness(int in, int out) const;
+
+    /** @brief Writes the map to a compact binary file */
+    bool save(const QString &path) const;
+    /** @brief Reads a map written by save(), returns an empty map if the file is missing or invalid */
+    static LoudnessMap load(const QString &path);
+};
@@ -0,0 +1,91 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "silenceDetector.h"
+
+#include <QtGlobal>
+
+SilenceDetector::SilenceDetector(double threshold, int minSilence, int padding)
+    : m_threshold(threshold)
+    , m_minSilence(qMax(1, minSilence))
+    , m_padding(qMax(0, padding))
+{
+}
+
+void SilenceDetector::addFrame(double level)
+{
+    if (level < m_threshold) {
+        if (m_silenceStart < 0) {
+            m_silenceStart = m_frames;
+        }
+    } else if (m_silenceStart >= 0) {
+        closeSilence(m_frames, false);
+    }
+    m_frames++;
+}
+
+int SilenceDetector::frames() const
+{
+    return m_frames;
+}
+
+void SilenceDetector::closeSilence(int end, bool atEnd)
+{
+    if (end - m_silenceStart >= m_minSilence) {
+        // No padding is needed at the clip boundaries
+        int in = m_silenceStart == 0 ? 0 : m_silenceStart + m_padding;
+        int out = atEnd ? end - 1 : end - 1 - m_padding;
+        if (out >= in) {
+            m_silences.append({in, out});
+        }
+    }
+    m_silenceStart = -1;
+}
+
+QVector<QPair<int, int>> SilenceDetector::silences() const
+{
+    if (m_silenceStart < 0) {
+        return m_silences;
+    }
+    // Include the silence running until the end
+    SilenceDetector copy(*this);
+    copy.closeSilence(m_frames, true);
+    return copy.m_silences;
+}
+
+QVector<QPair<int, int>> SilenceDetector::activeRegions() const
+{
+    QVector<QPair<int, int>> regions;
+    int start = 0;
+    for (const auto &silence : silences()) {
+        if (silence.first > start) {
+            regions.append({start, silence.first - 1});
+        }
+        start = silence.second + 1;
+    }
+    if (start < m_frames) {
+        regions.append({start, m_frames - 1});
+    }
+    return regions;
+}
+
+double SilenceDetector::iecToDb(double iec)
+{
+    // Inverse of the IEC 60268-18 scale used for audio levels
+    if (iec <= 0.) {
+        return -100.;
+    } else if (iec < 0.025) {
+        return iec / 0.0025 - 70.;
+    } else if (iec < 0.075) {
+        return (iec - 0.025) / 0.005 - 60.;
+    } else if (iec < 0.15) {
+        return (iec - 0.075) / 0.0075 - 50.;
+    } else if (iec < 0.3) {
+        return (iec - 0.15) / 0.015 - 40.;
+    } else if (iec < 0.5) {
+        return (iec - 0.3) / 0.02 - 30.;
+    }
+    return qMin(0., (iec - 0.5) / 0.025 - 20.);
+}
@@ -0,0 +1,46 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QPair>
+#include <QVector>
+
+/** @class SilenceDetector
+    @brief Finds the silent parts of a clip from its per frame audio level.
+    Frames quieter than the threshold are silent, only runs of silent frames longer than
+    the minimum duration are reported. Silences are shrunk by the padding on both sides so
+    that cutting them keeps some air around speech.
+ */
+class SilenceDetector
+{
+public:
+    /** @param threshold level in dBFS under which a frame is silent
+        @param minSilence minimum duration of a silence, in frames
+        @param padding frames of silence kept next to the active parts */
+    SilenceDetector(double threshold, int minSilence, int padding);
+
+    /** @brief Add the level of the next frame, in dBFS */
+    void addFrame(double level);
+    /** @brief Number of frames processed */
+    int frames() const;
+    /** @brief The silent ranges found, as inclusive {in, out} frames */
+    QVector<QPair<int, int>> silences() const;
+    /** @brief The active ranges between the silences, as inclusive {in, out} frames */
+    QVector<QPair<int, int>> activeRegions() const;
+
+    /** @brief Converts a level of the audio thumbnails (IEC scale, 0-1) to dBFS */
+    static double iecToDb(double iec);
+
+private:
+    double m_threshold;
+    int m_minSilence;
+    int m_padding;
+    int m_frames{0};
+    /** @brief Start of the current run of silent frames, -1 if the last frame was active */
+    int m_silenceStart{-1};
+    QVector<QPair<int, int>> m_silences;
+    void closeSilence(int end, bool atEnd);
+};
@@ -0,0 +1,94 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "sceneDetector.h"
+
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SCENEDETECT_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+SceneDetector::Signature SceneDetector::fromLuma(const quint8 *luma, int w, int h, int lineStride)
+{
+    Signature signature;
+    if (luma == nullptr || w <= 0 || h <= 0) {
+        return signature;
+    }
+    signature.luma.resize(size_t(width * height));
+    quint8 *dest = signature.luma.data();
+    for (int y = 0; y < height; ++y) {
+        const quint8 *line = luma + (y * h / height) * lineStride;
+        for (int x = 0; x < width; ++x) {
+            *dest++ = line[x * w / width];
+        }
+    }
+    return signature;
+}
+
+SceneDetector::Signature SceneDetector::fromRgba(const quint8 *rgba, int w, int h)
+{
+    Signature signature;
+    if (rgba == nullptr || w <= 0 || h <= 0) {
+        return signature;
+    }
+    signature.luma.resize(size_t(width * height));
+    quint8 *dest = signature.luma.data();
+    for (int y = 0; y < height; ++y) {
+        const quint8 *line = rgba + (y * h / height) * w * 4;
+        for (int x = 0; x < width; ++x) {
+            const quint8 *pixel = line + (x * w / width) * 4;
+            // BT.601 luma, in fixed point
+            *dest++ = quint8((77 * pixel[0] + 150 * pixel[1] + 29 * pixel[2]) >> 8);
+        }
+    }
+    return signature;
+}
+
+quint64 SceneDetector::sumAbsDiff(const quint8 *a, const quint8 *b, int size)
+{
+    quint64 sum = 0;
+    int i = 0;
+#if defined(SCENEDETECT_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    quint64 parts[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(parts), acc);
+    sum = parts[0] + parts[1];
+#elif defined(__ARM_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t diff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        acc = vpadalq_u16(acc, vpaddlq_u8(diff));
+    }
+    sum = quint64(vgetq_lane_u32(acc, 0)) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+    for (; i < size; ++i) {
+        sum += quint64(std::abs(int(a[i]) - int(b[i])));
+    }
+    return sum;
+}
+
+double SceneDetector::meanAbsDiff(const Signature &a, const Signature &b)
+{
+    if (!a.isValid() || !b.isValid() || a.luma.size() != b.luma.size()) {
+        return 0.;
+    }
+    const int size = int(a.luma.size());
+    // Normalized like FFmpeg, on the full 8 bit range
+    return double(sumAbsDiff(a.luma.data(), b.luma.data(), size)) / (256. * size);
+}
+
+double SceneDetector::sceneScore(double mad, double previousMad)
+{
+    return qBound(0., qMin(mad, std::abs(mad - previousMad)), 1.);
+}
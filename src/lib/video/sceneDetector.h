@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+
+/** @class SceneDetector
+    @brief Compares small luma images of consecutive frames to detect scene changes.
+    Each frame is reduced to a fixed size luma thumbnail. Frames are compared with the scene value
+    of FFmpeg's select filter, computed from the mean absolute pixel difference with the previous frame.
+ */
+class SceneDetector
+{
+public:
+    /** @brief Size of the images compared */
+    static const int width = 128;
+    static const int height = 72;
+
+    struct Signature
+    {
+        std::vector<quint8> luma;
+        bool isValid() const { return !luma.empty(); }
+    };
+
+    /** @brief Builds the signature of a luma (Y) plane of @param w x @param h pixels */
+    static Signature fromLuma(const quint8 *luma, int w, int h, int lineStride);
+    /** @brief Builds the signature of an RGBA image of @param w x @param h pixels */
+    static Signature fromRgba(const quint8 *rgba, int w, int h);
+    /** @brief Mean absolute luma difference between two frames, from 0 (identical) to 1 */
+    static double meanAbsDiff(const Signature &a, const Signature &b);
+    /** @brief The scene change value of FFmpeg's select filter, from the mean absolute difference @param mad of a frame
+        with the previous one and @param previousMad, the same difference for the previous frame. Sustained motion
+        changes every frame by the same amount and does not score. */
+    static double sceneScore(double mad, double previousMad);
+    /** @brief Sum of absolute differences of @param size bytes, vectorized when possible */
+    static quint64 sumAbsDiff(const quint8 *a, const quint8 *b, int size);
+};
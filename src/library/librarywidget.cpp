@@ -210,7 +210,7 @@ LibraryWidget::LibraryWidget(ProjectManager *manager, QWidget *parent)
     connect(m_coreLister, &KCoreDirLister::itemsAdded, this, &LibraryWidget::slotItemsAdded);
     connect(m_coreLister, &KCoreDirLister::itemsDeleted, this, &LibraryWidget::slotItemsDeleted);
     connect(m_coreLister, SIGNAL(clear()), this, SLOT(slotClearAll()));
-    m_coreLister->openUrl(QUrl::fromLocalFile(m_directory.absolutePath()));
+    // The library content is listed when the widget is first shown
     m_libraryTree->setSortingEnabled(true);
     m_libraryTree->sortByColumn(0, Qt::AscendingOrder);
     connect(m_libraryTree, &LibraryTree::itemChanged, this, &LibraryWidget::slotItemEdited, Qt::UniqueConnection);
@@ -511,12 +511,29 @@ void LibraryWidget::slotUpdateLibraryPath()
         showMessage(i18n("Check your settings, Library path is invalid: %1", m_directory.absolutePath()), KMessageWidget::Warning);
         setEnabled(false);
     } else {
-        m_coreLister->openUrl(QUrl::fromLocalFile(m_directory.absolutePath()));
+        m_listed = false;
+        if (isVisible()) {
+            listLibrary();
+        }
         setEnabled(true);
     }
     m_libraryTree->blockSignals(false);
 }
 
+void LibraryWidget::listLibrary()
+{
+    m_listed = true;
+    m_coreLister->openUrl(QUrl::fromLocalFile(m_directory.absolutePath()));
+}
+
+void LibraryWidget::showEvent(QShowEvent *event)
+{
+    if (!m_listed) {
+        listLibrary();
+    }
+    QWidget::showEvent(event);
+}
+
 void LibraryWidget::slotGotPreview(const KFileItem &item, const QPixmap &pix)
 {
     const QString path = item.url().toLocalFile();
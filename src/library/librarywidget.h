@@ -180,6 +180,9 @@ private Q_SLOTS:
     void slotItemsDeleted(const KFileItemList &list);
     void slotClearAll();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private:
     LibraryTree *m_libraryTree;
     QToolBar *m_toolBar;
@@ -196,6 +199,10 @@ private:
     QDir m_directory;
     /** @brief if true, the next file appearing in the library will be selected */
     bool m_selectNewFile;
+    /** @brief true once the library folder content was requested */
+    bool m_listed{false};
+    /** @brief Start listing the library folder */
+    void listLibrary();
     void showMessage(const QString &text, KMessageWidget::MessageType type = KMessageWidget::Warning);
 
 Q_SIGNALS:
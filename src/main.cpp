@@ -17,6 +17,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "kcoreaddons_version.h"
 #include "kxmlgui_version.h"
 #include "mainwindow.h"
+#include "utils/startuptrace.h"
 
 #include <KAboutData>
 #include <KConfigGroup>
@@ -178,11 +179,16 @@ int main(int argc, char *argv[])
     parser.addOption(mltLogLevelOption);
     QCommandLineOption clipsOption(QStringLiteral("i"), i18n("Comma separated list of files to add as clips to the bin."), QStringLiteral("clips"));
     parser.addOption(clipsOption);
+    QCommandLineOption traceOption(QStringLiteral("startup-trace"), i18n("Write the duration of the startup phases to a JSON file."), QStringLiteral("file"));
+    parser.addOption(traceOption);
     parser.addPositionalArgument(QStringLiteral("file"), i18n("Kdenlive document to open."));
 
     // Parse command line
     parser.process(app);
     aboutData.processCommandLine(&parser);
+    if (parser.isSet(traceOption)) {
+        StartupTrace::enable(parser.value(traceOption));
+    }
 
     qApp->processEvents(QEventLoop::AllEvents);
 
@@ -342,7 +348,12 @@ int main(int argc, char *argv[])
     }
     qApp->processEvents(QEventLoop::AllEvents);
     int result = 0;
-    if (!Core::build(packageType)) {
+    bool built;
+    {
+        StartupTrace::Phase phase("Core::build");
+        built = Core::build(packageType);
+    }
+    if (!built) {
         // App is crashing, delete config files and restart
         result = EXIT_CLEAN_RESTART;
     } else {
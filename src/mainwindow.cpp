@@ -28,7 +28,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "effects/effectlist/view/effectlistwidget.hpp"
 #include "jobs/audiolevelstask.h"
 #include "jobs/customjobtask.h"
+#include "jobs/loudnesstask.h"
 #include "jobs/scenesplittask.h"
+#include "jobs/silencedetecttask.h"
 #include "jobs/speedtask.h"
 #include "jobs/stabilizetask.h"
 #include "jobs/transcodetask.h"
@@ -64,6 +66,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "titler/titlewidget.h"
 #include "transitions/transitionlist/view/transitionlistwidget.hpp"
 #include "transitions/transitionsrepository.hpp"
+#include "utils/startuptrace.h"
 #include "utils/thememanager.h"
 #include "widgets/progressbutton.h"
 #include <config-kdenlive.h>
@@ -105,6 +108,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QDesktopServices>
 #include <QDialogButtonBox>
 #include <QFileDialog>
+#include <QImageReader>
 #include <QMenu>
 #include <QMenuBar>
 #include <QPushButton>
@@ -123,6 +127,24 @@ class Producer;
 QMap<QString, QImage> MainWindow::m_lumacache;
 QMap<QString, QStringList> MainWindow::m_lumaFiles;
 
+QImage MainWindow::lumaThumbnail(const QString &path)
+{
+    auto it = m_lumacache.constFind(path);
+    if (it != m_lumacache.constEnd()) {
+        return it.value();
+    }
+    // Let the decoder scale down while reading when it supports it
+    QImageReader reader(path);
+    const QSize size = reader.size();
+    if (size.isValid()) {
+        reader.setScaledSize(size.scaled(50, 30, Qt::KeepAspectRatio));
+    }
+    QImage thumb = reader.read();
+    // Also remember failures, like MLT's builtin lumas that have no file
+    m_lumacache.insert(path, thumb);
+    return thumb;
+}
+
 /*static bool sortByNames(const QPair<QString, QAction *> &a, const QPair<QString, QAction*> &b)
 {
     return a.first < b.first;
@@ -157,6 +179,7 @@ MainWindow::MainWindow(QWidget *parent)
 
 void MainWindow::init(const QString &mltPath)
 {
+    StartupTrace::Phase initPhase("MainWindow::init");
     QString desktopStyle = QApplication::style()->objectName();
     // Load themes
     auto themeManager = new ThemeManager(actionCollection());
@@ -221,7 +244,10 @@ void MainWindow::init(const QString &mltPath)
     QString defaultProfile = KdenliveSettings::default_profile();
 
     // Initialise MLT connection
-    MltConnection::construct(mltPath);
+    {
+        StartupTrace::Phase phase("MLT connection");
+        MltConnection::construct(mltPath);
+    }
     pCore->setCurrentProfile(defaultProfile.isEmpty() ? ProjectManager::getDefaultProjectFormat() : defaultProfile);
     m_commandStack = new QUndoGroup();
 
@@ -232,7 +258,10 @@ void MainWindow::init(const QString &mltPath)
         pCore->setCurrentProfile(QStringLiteral("atsc_1080p_25"));
         KdenliveSettings::setDefault_profile(QStringLiteral("atsc_1080p_25"));
     }
-    m_gpuAllowed = EffectsRepository::get()->hasInternalEffect(QStringLiteral("glsl.manager"));
+    {
+        StartupTrace::Phase phase("Effects repository");
+        m_gpuAllowed = EffectsRepository::get()->hasInternalEffect(QStringLiteral("glsl.manager"));
+    }
 
     m_shortcutRemoveFocus = new QShortcut(QKeySequence(QStringLiteral("Esc")), this);
     connect(m_shortcutRemoveFocus, &QShortcut::activated, this, &MainWindow::slotRemoveFocus);
@@ -276,14 +305,17 @@ void MainWindow::init(const QString &mltPath)
     fr->setMaximumHeight(1);
     fr->setLineWidth(1);
     ctnLay->addWidget(fr);
-    setupActions();
+    {
+        StartupTrace::Phase phase("Actions");
+        setupActions();
+    }
     auto *layoutManager = new LayoutManagement(this);
     pCore->bin()->setupMenu();
     pCore->buildDocks();
 
     QDockWidget *libraryDock = addDock(i18n("Library"), QStringLiteral("library"), pCore->library());
     QDockWidget *subtitlesDock = addDock(i18n("Subtitles"), QStringLiteral("Subtitles"), pCore->subtitleWidget());
-    QDockWidget *textEditingDock = addDock(i18n("Speech Editor"), QStringLiteral("textedit"), pCore->textEditWidget());
+    QDockWidget *textEditingDock = addLazyDock(i18n("Speech Editor"), QStringLiteral("textedit"), [](QDockWidget *) { return pCore->buildTextEditWidget(); });
     QDockWidget *timeRemapDock = addDock(i18n("Time Remapping"), QStringLiteral("timeremap"), pCore->timeRemapWidget());
     QDockWidget *guidesDock = addDock(i18n("Guides"), QStringLiteral("guides"), pCore->guidesList());
     connect(pCore.get(), &Core::remapClip, this, [&, timeRemapDock](int id) {
@@ -309,6 +341,7 @@ void MainWindow::init(const QString &mltPath)
 
     connect(m_clipMonitor, &Monitor::passKeyPress, this, &MainWindow::triggerKey);
 
+    StartupTrace::mark("Clip monitor created");
     m_projectMonitor = new Monitor(Kdenlive::ProjectMonitor, pCore->monitorManager(), this);
     connect(m_projectMonitor, &Monitor::passKeyPress, this, &MainWindow::triggerKey);
     connect(m_projectMonitor, &Monitor::addMarker, this, &MainWindow::slotAddMarkerGuideQuickly);
@@ -321,6 +354,7 @@ void MainWindow::init(const QString &mltPath)
     });
     installEventFilter(this);
     pCore->monitorManager()->initMonitors(m_clipMonitor, m_projectMonitor);
+    StartupTrace::mark("Project monitor created");
 
     m_timelineTabs = new TimelineTabs(this);
     ctnLay->addWidget(m_timelineTabs);
@@ -365,17 +399,18 @@ void MainWindow::init(const QString &mltPath)
     QDockWidget *clipDockWidget = addDock(i18n("Media Browser"), QStringLiteral("bin_clip"), pCore->mediaBrowser());
 
     // Online resources widget
-    auto *onlineResources = new ResourceWidget(this);
-    m_onlineResourcesDock = addDock(i18n("Online Resources"), QStringLiteral("onlineresources"), onlineResources);
-    connect(onlineResources, &ResourceWidget::previewClip, this, [&](const QString &path, const QString &title) {
-        m_clipMonitor->slotPreviewResource(path, title);
-        m_clipMonitorDock->show();
-        m_clipMonitorDock->raise();
+    m_onlineResourcesDock = addLazyDock(i18n("Online Resources"), QStringLiteral("onlineresources"), [this](QDockWidget *) {
+        auto *onlineResources = new ResourceWidget(this);
+        connect(onlineResources, &ResourceWidget::previewClip, this, [this](const QString &path, const QString &title) {
+            m_clipMonitor->slotPreviewResource(path, title);
+            m_clipMonitorDock->show();
+            m_clipMonitorDock->raise();
+        });
+        connect(onlineResources, &ResourceWidget::addClip, this, &MainWindow::slotAddProjectClip);
+        connect(onlineResources, &ResourceWidget::addLicenseInfo, this, &MainWindow::slotAddTextNote);
+        return onlineResources;
     });
 
-    connect(onlineResources, &ResourceWidget::addClip, this, &MainWindow::slotAddProjectClip);
-    connect(onlineResources, &ResourceWidget::addLicenseInfo, this, &MainWindow::slotAddTextNote);
-
     // Close library and audiospectrum and others on first run
     screenGrabDock->close();
     libraryDock->close();
@@ -435,6 +470,7 @@ void MainWindow::init(const QString &mltPath)
         }
     });
 
+    StartupTrace::mark("Docks created");
     m_effectList2 = new EffectListWidget(this);
     connect(m_effectList2, &EffectListWidget::activateAsset, pCore->projectManager(), &ProjectManager::activateAsset);
     connect(m_assetPanel, &AssetPanel::reloadEffect, m_effectList2, &EffectListWidget::reloadCustomEffect);
@@ -568,7 +604,10 @@ void MainWindow::init(const QString &mltPath)
     previewButtonAction->setIcon(QIcon::fromTheme(QStringLiteral("preview-render-on")));
     previewButtonAction->setDefaultWidget(timelinePreview);
     addAction(QStringLiteral("timeline_preview_button"), previewButtonAction);
-    setupGUI(KXmlGuiWindow::ToolBar | KXmlGuiWindow::StatusBar | KXmlGuiWindow::Save | KXmlGuiWindow::Create);
+    {
+        StartupTrace::Phase phase("KXmlGui setup");
+        setupGUI(KXmlGuiWindow::ToolBar | KXmlGuiWindow::StatusBar | KXmlGuiWindow::Save | KXmlGuiWindow::Create);
+    }
 
     // Redirect help entry to our own function
     // First delete the default help action
@@ -621,7 +660,9 @@ void MainWindow::init(const QString &mltPath)
     auto *timelineClipMenu = new QMenu(this);
     timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("edit_copy")));
     timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("paste_effects")));
+    timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("paste_effects_linked")));
     timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("delete_effects")));
+    timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("measure_effect_cost")));
     timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("group_clip")));
     timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("ungroup_clip")));
     timelineClipMenu->addAction(actionCollection()->action(QStringLiteral("edit_item_duration")));
@@ -697,6 +738,13 @@ void MainWindow::init(const QString &mltPath)
     connect(normalize_channels, &QAction::triggered, this, &MainWindow::slotNormalizeAudioChannel);
     timelineHeadersMenu->addAction(normalize_channels);
 
+    QAction *loudness_overlay = new QAction(QIcon(), i18n("Show Loudness"), this);
+    loudness_overlay->setCheckable(true);
+    loudness_overlay->setChecked(KdenliveSettings::loudnessoverlay());
+    loudness_overlay->setData("loudness_overlay");
+    connect(loudness_overlay, &QAction::triggered, this, &MainWindow::slotShowLoudnessOverlay);
+    timelineHeadersMenu->addAction(loudness_overlay);
+
     QMenu *thumbsMenu = new QMenu(i18n("Thumbnails"), this);
     auto *thumbGroup = new QActionGroup(this);
     QAction *inFrame = new QAction(i18n("In Frame"), thumbGroup);
@@ -795,6 +843,14 @@ void MainWindow::init(const QString &mltPath)
     autoRender->setChecked(KdenliveSettings::autopreview());
     connect(autoRender, &QAction::triggered, this, &MainWindow::slotToggleAutoPreview);
     tlMenu->addAction(autoRender);
+
+    // Predictive timeline preview action
+    QAction *predictiveRender = new QAction(i18n("Predictive Preview"), this);
+    predictiveRender->setCheckable(true);
+    predictiveRender->setChecked(KdenliveSettings::predictivepreview());
+    predictiveRender->setToolTip(i18n("When idle, render the parts around the playhead that cannot be played in real time"));
+    connect(predictiveRender, &QAction::triggered, this, &MainWindow::slotTogglePredictivePreview);
+    tlMenu->addAction(predictiveRender);
     tlMenu->addSeparator();
     tlMenu->addAction(actionCollection()->action(QStringLiteral("disable_preview")));
     tlMenu->addAction(actionCollection()->action(QStringLiteral("manage_cache")));
@@ -1588,6 +1644,15 @@ void MainWindow::setupActions()
         Q_EMIT pCore->monitorManager()->updatePreviewScaling();
     });
 
+    QAction *autoScale = new QAction(i18n("Automatic (lower resolution while playback is too slow)"), this);
+    addAction(QStringLiteral("scale_auto_preview"), autoScale, QKeySequence(), resolutionActionCategory);
+    autoScale->setCheckable(true);
+    autoScale->setChecked(KdenliveSettings::autopreviewscaling());
+    connect(autoScale, &QAction::toggled, this, [](bool enable) {
+        KdenliveSettings::setAutopreviewscaling(enable);
+        Q_EMIT pCore->monitorManager()->updatePreviewScaling();
+    });
+
     QAction *dropFrames = new QAction(QIcon(), i18n("Real Time (drop frames)"), this);
     dropFrames->setCheckable(true);
     dropFrames->setChecked(KdenliveSettings::monitor_dropframes());
@@ -1734,6 +1799,12 @@ void MainWindow::setupActions()
     // alignAudio->setData('A');
     alignAudio->setEnabled(false);
 
+    QAction *measureCost = addAction(QStringLiteral("measure_effect_cost"), i18n("Measure Effect Cost"), this, SLOT(slotMeasureEffectCost()), QIcon(),
+                                     QKeySequence(), clipActionCategory);
+    // "C" as data means this action should only be available for clips - not for compositions
+    measureCost->setData('C');
+    measureCost->setEnabled(false);
+
     QAction *act = addAction(QStringLiteral("edit_item_duration"), i18n("Edit Duration"), this, SLOT(slotEditItemDuration()),
                              QIcon::fromTheme(QStringLiteral("measure")), QKeySequence(), clipActionCategory);
     act->setEnabled(false);
@@ -1780,6 +1851,13 @@ void MainWindow::setupActions()
     // "C" as data means this action should only be available for clips - not for compositions
     pasteEffects->setData('C');
 
+    QAction *pasteLinkedEffects = addAction(QStringLiteral("paste_effects_linked"), i18n("Paste Effects (Linked)"), this,
+                                            SLOT(slotPasteLinkedEffects()), QIcon::fromTheme(QStringLiteral("edit-link")), QKeySequence(), clipActionCategory);
+    pasteLinkedEffects->setEnabled(false);
+    pasteLinkedEffects->setWhatsThis(xi18nc("@info:whatsthis", "Pastes the copied effects, linked to the copied clip effects. Use <interface>Update All Linked "
+                                                             "Effects</interface> in an effect menu to apply its changes to all the linked clips."));
+    pasteLinkedEffects->setData('C');
+
     QAction *delEffects = new QAction(QIcon::fromTheme(QStringLiteral("edit-delete")), i18n("Delete Effects"), this);
     addAction(QStringLiteral("delete_effects"), delEffects, QKeySequence(), clipActionCategory);
     delEffects->setEnabled(false);
@@ -2694,7 +2772,7 @@ void MainWindow::slotDeleteItem()
             }
         }
     }
-    if (QApplication::focusWidget() != nullptr && pCore->textEditWidget()->isAncestorOf(QApplication::focusWidget())) {
+    if (QApplication::focusWidget() != nullptr && pCore->textEditWidget() && pCore->textEditWidget()->isAncestorOf(QApplication::focusWidget())) {
         pCore->textEditWidget()->deleteItem();
     } else {
         QWidget *widget = QApplication::focusWidget();
@@ -2884,6 +2962,12 @@ void MainWindow::slotNormalizeAudioChannel()
     }
 }
 
+void MainWindow::slotShowLoudnessOverlay()
+{
+    KdenliveSettings::setLoudnessoverlay(!KdenliveSettings::loudnessoverlay());
+    Q_EMIT getCurrentTimeline()->controller()->loudnessOverlayChanged();
+}
+
 void MainWindow::slotInsertTrack()
 {
     pCore->monitorManager()->activateMonitor(Kdenlive::ProjectMonitor);
@@ -3467,6 +3551,11 @@ void MainWindow::slotPasteEffects()
     getCurrentTimeline()->controller()->pasteEffects();
 }
 
+void MainWindow::slotPasteLinkedEffects()
+{
+    getCurrentTimeline()->controller()->pasteEffects(-1, true);
+}
+
 void MainWindow::slotClipInTimeline(const QString &clipId, const QList<int> &ids)
 {
     Q_UNUSED(clipId)
@@ -3665,6 +3754,11 @@ void MainWindow::slotAlignAudio()
     getCurrentTimeline()->controller()->alignAudio();
 }
 
+void MainWindow::slotMeasureEffectCost()
+{
+    getCurrentTimeline()->controller()->measureEffectCost();
+}
+
 void MainWindow::slotUpdateTimelineView(QAction *action)
 {
     int viewMode = action->data().toInt();
@@ -3745,6 +3839,10 @@ void MainWindow::buildDynamicActions()
             connect(action, &QAction::triggered, this, [&]() { SceneSplitTask::start(this); });
         } else if (k.key() == QLatin1String("timewarp")) {
             connect(action, &QAction::triggered, this, [&]() { SpeedTask::start(this); });
+        } else if (k.key() == QLatin1String("loudness")) {
+            connect(action, &QAction::triggered, this, [&]() { LoudnessTask::start(this); });
+        } else if (k.key() == QLatin1String("silencedetect")) {
+            connect(action, &QAction::triggered, this, [&]() { SilenceDetectTask::start(this); });
         } else {
             connect(action, &QAction::triggered, this, [&, jobId = k.key()]() { CustomJobTask::start(this, jobId); });
         }
@@ -4130,6 +4228,24 @@ QDockWidget *MainWindow::addDock(const QString &title, const QString &objectName
     return dockWidget;
 }
 
+QDockWidget *MainWindow::addLazyDock(const QString &title, const QString &objectName, const std::function<QWidget *(QDockWidget *)> &builder,
+                                     Qt::DockWidgetArea area)
+{
+    // The dock exists from the start so that its state is restored with the layout
+    QDockWidget *dockWidget = addDock(title, objectName, new QWidget(this), area);
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(dockWidget, &QDockWidget::visibilityChanged, this, [dockWidget, builder, connection](bool visible) {
+        if (!visible) {
+            return;
+        }
+        disconnect(*connection);
+        QWidget *placeholder = dockWidget->widget();
+        dockWidget->setWidget(builder(dockWidget));
+        placeholder->deleteLater();
+    });
+    return dockWidget;
+}
+
 bool MainWindow::isMixedTabbed() const
 {
     return !tabifiedDockWidgets(m_mixerDock).isEmpty();
@@ -4199,6 +4315,14 @@ void MainWindow::slotToggleAutoPreview(bool enable)
     }
 }
 
+void MainWindow::slotTogglePredictivePreview(bool enable)
+{
+    KdenliveSettings::setPredictivepreview(enable);
+    if (enable && getCurrentTimeline()) {
+        getCurrentTimeline()->controller()->initializePredictivePreview();
+    }
+}
+
 void MainWindow::showTimelineToolbarMenu(const QPoint &pos)
 {
     QMenu menu;
@@ -27,6 +27,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <knewstuff_version.h>
 #include <kxmlgui_version.h>
 #include <mlt++/Mlt.h>
+#include <functional>
 #include <utility>
 
 #include "bin/bin.h"
@@ -88,9 +89,9 @@ public:
     void init(const QString &mltPath);
     ~MainWindow() override;
 
-    /** @brief Cache for luma files thumbnails. */
-    static QMap<QString, QImage> m_lumacache;
     static QMap<QString, QStringList> m_lumaFiles;
+    /** @brief Returns the small thumbnail of a luma file, decoded on first use. Null if the file is not an image */
+    static QImage lumaThumbnail(const QString &path);
 
     /** @brief Adds an action to the action collection and stores the name. */
     void addAction(const QString &name, QAction *action, const QKeySequence &shortcut = QKeySequence(), KActionCategory *category = nullptr);
@@ -115,6 +116,9 @@ public:
      * @returns the created dock widget
      */
     QDockWidget *addDock(const QString &title, const QString &objectName, QWidget *widget, Qt::DockWidgetArea area = Qt::TopDockWidgetArea);
+    /** @brief Adds a dock whose widget is only created by @param builder when the dock is first shown. */
+    QDockWidget *addLazyDock(const QString &title, const QString &objectName, const std::function<QWidget *(QDockWidget *)> &builder,
+                             Qt::DockWidgetArea area = Qt::TopDockWidgetArea);
 
     QUndoGroup *m_commandStack;
     QUndoView *m_undoView;
@@ -214,6 +218,9 @@ private:
     /** @brief Rebuild the dock menu according to existing dock widgets. */
     void updateDockMenu();
 
+    /** @brief Cache for luma files thumbnails. */
+    static QMap<QString, QImage> m_lumacache;
+
     OtioConvertions m_otioConvertions;
     KColorSchemeManager *m_colorschemes;
 
@@ -475,12 +482,15 @@ private Q_SLOTS:
     void slotCopy();
     void slotPaste();
     void slotPasteEffects();
+    void slotPasteLinkedEffects();
     void slotResizeItemStart();
     void slotResizeItemEnd();
     void configureNotifications();
     void slotSeparateAudioChannel();
     /** @brief Normalize audio channels before displaying them */
     void slotNormalizeAudioChannel();
+    /** @brief Toggle the short-term loudness curve over audio thumbnails */
+    void slotShowLoudnessOverlay();
     /** @brief Toggle automatic fit track height */
     void slotAutoTrackHeight(bool enable);
     void slotInsertTrack();
@@ -507,6 +517,8 @@ private Q_SLOTS:
     void slotSwitchClip();
     void slotSetAudioAlignReference();
     void slotAlignAudio();
+    /** @brief Measure the playback cost of the effects of the selected timeline clips. */
+    void slotMeasureEffectCost();
     void slotUpdateTimelineView(QAction *action);
     void slotShowTimeline(bool show);
     void slotTranscodeClip();
@@ -559,6 +571,7 @@ private Q_SLOTS:
     void slotCheckTabPosition();
     /** @brief Toggle automatic timeline preview on/off */
     void slotToggleAutoPreview(bool enable);
+    void slotTogglePredictivePreview(bool enable);
     void showTimelineToolbarMenu(const QPoint &pos);
     /** @brief Open Cached Data management dialog. */
     void slotManageCache();
@@ -0,0 +1,432 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "audioscrubber.h"
+#include "core.h"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+
+#include <QAudioFormat>
+#include <QMutexLocker>
+#include <QtConcurrent>
+#include <cmath>
+#include <mlt++/Mlt.h>
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <QAudioDeviceInfo>
+#include <QAudioOutput>
+#else
+#include <QAudioDevice>
+#include <QAudioSink>
+#include <QMediaDevices>
+#endif
+
+// Duration of decoded audio kept around the playhead
+static const int ringSeconds = 4;
+
+AudioScrubber::AudioScrubber(QObject *parent)
+    : QIODevice(parent)
+    , m_frequency(48000)
+    , m_channels(pCore->audioChannels())
+{
+    configureDevice();
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(1000);
+    connect(&m_idleTimer, &QTimer::timeout, this, [this]() {
+        if (m_output) {
+            m_output->suspend();
+        }
+    });
+    open(QIODevice::ReadOnly);
+}
+
+void AudioScrubber::configureDevice()
+{
+    m_deviceName = KdenliveSettings::audiodevicename();
+    int frequency = 0;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QAudioDeviceInfo device = QAudioDeviceInfo::defaultOutputDevice();
+    if (!m_deviceName.isEmpty()) {
+        const QList<QAudioDeviceInfo> devices = QAudioDeviceInfo::availableDevices(QAudio::AudioOutput);
+        for (const QAudioDeviceInfo &info : devices) {
+            if (info.deviceName() == m_deviceName) {
+                device = info;
+                break;
+            }
+        }
+    }
+    frequency = device.preferredFormat().sampleRate();
+#else
+    QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    if (!m_deviceName.isEmpty()) {
+        const QList<QAudioDevice> devices = QMediaDevices::audioOutputs();
+        for (const QAudioDevice &info : devices) {
+            if (info.description() == m_deviceName || info.id() == m_deviceName.toUtf8()) {
+                device = info;
+                break;
+            }
+        }
+    }
+    frequency = device.preferredFormat().sampleRate();
+#endif
+    QMutexLocker lk(&m_mutex);
+    // Decode at the device rate, so that the sound server does not resample the grains
+    m_frequency = frequency > 0 ? frequency : 48000;
+    m_grainLength = m_frequency * 70 / 1000;
+    m_fadeLength = m_frequency * 15 / 1000;
+    m_ringSamples = ringSeconds * m_frequency;
+    m_ring.fill(0, m_ringSamples * m_channels);
+    m_firstFrame = m_lastFrame = -1;
+    m_firstSample = m_endSample = 0;
+}
+
+AudioScrubber::~AudioScrubber()
+{
+    m_mutex.lock();
+    m_abort = true;
+    m_decodeRequest.wakeAll();
+    m_mutex.unlock();
+    m_decodeFuture.waitForFinished();
+    if (m_output) {
+        m_output->stop();
+    }
+    close();
+}
+
+void AudioScrubber::setProducer(std::shared_ptr<Mlt::Producer> producer, double fps)
+{
+    stop();
+    int channels = pCore->audioChannels();
+    if (channels != m_channels) {
+        // The output format changed, the sound device will be reopened
+        m_output.reset();
+    }
+    QMutexLocker lk(&m_mutex);
+    m_sourceProducer = std::move(producer);
+    m_length = m_sourceProducer ? m_sourceProducer->get_length() : 0;
+    m_fps = fps;
+    if (channels != m_channels) {
+        m_channels = channels;
+        m_ring.fill(0, m_ringSamples * m_channels);
+    }
+    m_decoder.reset();
+    m_pendingXml.clear();
+    m_stale = true;
+    m_firstFrame = m_lastFrame = -1;
+    m_firstSample = m_endSample = 0;
+    m_decodeRequest.wakeAll();
+}
+
+void AudioScrubber::invalidate()
+{
+    QMutexLocker lk(&m_mutex);
+    m_decoder.reset();
+    m_stale = true;
+    m_firstFrame = m_lastFrame = -1;
+    m_firstSample = m_endSample = 0;
+}
+
+void AudioScrubber::setVolume(double volume)
+{
+    QMutexLocker lk(&m_mutex);
+    m_volume = qBound(0., volume, 1.);
+}
+
+static QByteArray serializeProducer(Mlt::Producer &producer)
+{
+    Mlt::Consumer c(pCore->getProjectProfile(), "xml", "string");
+    c.set("time_format", "frames");
+    c.set("no_meta", 1);
+    c.set("no_profile", 1);
+    c.set("store", "kdenlive");
+    c.set("no_root", 1);
+    c.set("root", "/");
+    c.connect(producer);
+    c.run();
+    return QByteArray(c.get("string"));
+}
+
+static std::shared_ptr<Mlt::Producer> parseProducer(const QByteArray &xml)
+{
+    std::shared_ptr<Mlt::Producer> clone(new Mlt::Producer(pCore->getProjectProfile(), "xml-string", xml.constData()));
+    if (!clone->is_valid()) {
+        return nullptr;
+    }
+    // Make sure we get audio at the requested frequency whatever the source
+    Mlt::Filter resample(pCore->getProjectProfile(), "swresample");
+    if (resample.is_valid()) {
+        clone->attach(resample);
+    }
+    return clone;
+}
+
+void AudioScrubber::scrub(int position)
+{
+    if (!m_sourceProducer || m_length <= 0) {
+        return;
+    }
+    if (m_deviceName != KdenliveSettings::audiodevicename()) {
+        // The sound device changed in the settings
+        m_output.reset();
+        configureDevice();
+    }
+    position = qBound(0, position, m_length - 1);
+    m_mutex.lock();
+    bool stale = m_stale;
+    m_mutex.unlock();
+    QByteArray xml;
+    if (stale) {
+        // The source must be serialized here as it is edited on this thread, parsing it is left to the decoding thread
+        xml = serializeProducer(*m_sourceProducer.get());
+    }
+    QMutexLocker lk(&m_mutex);
+    if (stale) {
+        m_pendingXml = xml;
+        m_stale = false;
+    }
+    m_target = position;
+    m_pendingGrain = mlt_audio_calculate_samples_to_position(float(m_fps), m_frequency, position);
+    if (!m_decoding && !m_abort) {
+        m_decoding = true;
+        m_decodeFuture = QtConcurrent::run([this]() { decodeLoop(); });
+    } else {
+        m_decodeRequest.wakeAll();
+    }
+    lk.unlock();
+    startOutput();
+    m_idleTimer.start();
+}
+
+void AudioScrubber::stop()
+{
+    m_idleTimer.stop();
+    QMutexLocker lk(&m_mutex);
+    m_pendingGrain = -1;
+    m_grainRemaining = 0;
+    m_fadeRemaining = 0;
+    lk.unlock();
+    if (m_output) {
+        m_output->suspend();
+    }
+}
+
+void AudioScrubber::startOutput()
+{
+    if (m_output) {
+        if (m_output->state() == QAudio::SuspendedState) {
+            m_output->resume();
+        }
+        return;
+    }
+    QAudioFormat format;
+    format.setSampleRate(m_frequency);
+    format.setChannelCount(m_channels);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    format.setSampleSize(16);
+    format.setCodec(QStringLiteral("audio/pcm"));
+    format.setByteOrder(QAudioFormat::Endian(QSysInfo::ByteOrder));
+    format.setSampleType(QAudioFormat::SignedInt);
+    QAudioDeviceInfo device = QAudioDeviceInfo::defaultOutputDevice();
+    const QList<QAudioDeviceInfo> devices = QAudioDeviceInfo::availableDevices(QAudio::AudioOutput);
+    for (const QAudioDeviceInfo &info : devices) {
+        if (!m_deviceName.isEmpty() && info.deviceName() == m_deviceName) {
+            device = info;
+            break;
+        }
+    }
+    m_output.reset(new QAudioOutput(device, format));
+#else
+    format.setSampleFormat(QAudioFormat::Int16);
+    QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    const QList<QAudioDevice> devices = QMediaDevices::audioOutputs();
+    for (const QAudioDevice &info : devices) {
+        if (!m_deviceName.isEmpty() && (info.description() == m_deviceName || info.id() == m_deviceName.toUtf8())) {
+            device = info;
+            break;
+        }
+    }
+    m_output.reset(new QAudioSink(device, format));
+#endif
+    // Keep the device buffer short for a low latency
+    m_output->setBufferSize(m_fadeLength * 2 * m_channels * 2);
+    m_output->start(this);
+}
+
+int AudioScrubber::nextFrameToDecode(int target) const
+{
+    if (target < 0) {
+        return -1;
+    }
+    const int ahead = qRound(m_fps * 1.5);
+    const int behind = qRound(m_fps * 0.5);
+    if (m_firstFrame < 0 || target < m_firstFrame - behind || target > m_lastFrame + ahead) {
+        // Jump, restart decoding from the target
+        return target;
+    }
+    if (m_lastFrame < target + ahead && m_lastFrame + 1 < m_length) {
+        return m_lastFrame + 1;
+    }
+    if (m_firstFrame > qMax(0, target - behind)) {
+        return m_firstFrame - 1;
+    }
+    return -1;
+}
+
+void AudioScrubber::decodeLoop()
+{
+    QMutexLocker lk(&m_mutex);
+    while (!m_abort && (m_decoder || !m_pendingXml.isEmpty())) {
+        if (!m_pendingXml.isEmpty()) {
+            // Opening the clips of a timeline copy can be slow, keep it out of the GUI thread
+            const QByteArray xml = m_pendingXml;
+            m_pendingXml.clear();
+            lk.unlock();
+            std::shared_ptr<Mlt::Producer> decoder = parseProducer(xml);
+            lk.relock();
+            if (!decoder) {
+                qCDebug(KDENLIVE_LOG) << "Cannot create audio scrubbing producer";
+            }
+            if (m_pendingXml.isEmpty()) {
+                m_decoder = decoder;
+                m_firstFrame = m_lastFrame = -1;
+                m_firstSample = m_endSample = 0;
+            }
+            continue;
+        }
+        int frame = nextFrameToDecode(m_target);
+        if (frame < 0) {
+            // Wait for a new scrub request, exit the thread when idle
+            if (!m_decodeRequest.wait(&m_mutex, 2000) && nextFrameToDecode(m_target) < 0) {
+                break;
+            }
+            continue;
+        }
+        std::shared_ptr<Mlt::Producer> decoder = m_decoder;
+        const float fps = float(m_fps);
+        const int outChannels = m_channels;
+        const int outFrequency = m_frequency;
+        lk.unlock();
+
+        decoder->seek(frame);
+        std::unique_ptr<Mlt::Frame> mltFrame(decoder->get_frame());
+        mlt_audio_format format = mlt_audio_s16;
+        int frequency = outFrequency;
+        int channels = outChannels;
+        int samples = mlt_audio_calculate_frame_samples(fps, outFrequency, frame);
+        const qint16 *data = nullptr;
+        if (mltFrame && mltFrame->is_valid()) {
+            data = static_cast<const qint16 *>(mltFrame->get_audio(format, frequency, channels, samples));
+        }
+
+        lk.relock();
+        if (decoder != m_decoder || outChannels != m_channels || outFrequency != m_frequency) {
+            // Source changed while decoding
+            continue;
+        }
+        const int capacityFrames = int((ringSeconds - 0.5) * m_fps);
+        if (m_firstFrame < 0 || frame < m_firstFrame - 1 || frame > m_lastFrame + 1) {
+            m_firstFrame = m_lastFrame = frame;
+        } else if (frame == m_lastFrame + 1) {
+            m_lastFrame = frame;
+            m_firstFrame = qMax(m_firstFrame, m_lastFrame - capacityFrames + 1);
+        } else if (frame == m_firstFrame - 1) {
+            m_firstFrame = frame;
+            m_lastFrame = qMin(m_lastFrame, m_firstFrame + capacityFrames - 1);
+        }
+        m_firstSample = mlt_audio_calculate_samples_to_position(fps, m_frequency, m_firstFrame);
+        m_endSample = mlt_audio_calculate_samples_to_position(fps, m_frequency, m_lastFrame + 1);
+        qint64 start = mlt_audio_calculate_samples_to_position(fps, m_frequency, frame);
+        for (int i = 0; i < samples; ++i) {
+            qint16 *dest = m_ring.data() + ((start + i) % m_ringSamples) * m_channels;
+            for (int c = 0; c < m_channels; ++c) {
+                dest[c] = (data && channels > 0) ? data[i * channels + qMin(c, channels - 1)] : 0;
+            }
+        }
+    }
+    m_decoding = false;
+}
+
+qint16 AudioScrubber::sampleAt(qint64 samplePos, int channel) const
+{
+    if (samplePos < m_firstSample || samplePos >= m_endSample) {
+        return 0;
+    }
+    return m_ring.at(int(samplePos % m_ringSamples) * m_channels + channel);
+}
+
+// Hann shaped fade, @param x goes from 0 (silent) to 1 (full volume)
+static inline float fadeGain(float x)
+{
+    float s = std::sin(float(M_PI_2) * x);
+    return s * s;
+}
+
+qint64 AudioScrubber::readData(char *data, qint64 maxSize)
+{
+    QMutexLocker lk(&m_mutex);
+    const int frameSize = int(sizeof(qint16)) * m_channels;
+    const qint64 frames = maxSize / frameSize;
+    auto *out = reinterpret_cast<qint16 *>(data);
+    for (qint64 i = 0; i < frames; ++i) {
+        // Start the requested grain once the current one has faded in
+        if (m_pendingGrain >= 0 && (m_grainRemaining <= 0 || m_grainLength - m_grainRemaining >= m_fadeLength)) {
+            if (m_grainRemaining > 0) {
+                m_fadePos = m_grainPos;
+                m_fadeRemaining = qMin(m_fadeLength, m_grainRemaining);
+            }
+            m_grainPos = m_pendingGrain;
+            m_grainRemaining = m_grainLength;
+            m_pendingGrain = -1;
+        }
+        float grainGain = 0.;
+        if (m_grainRemaining > 0) {
+            int played = m_grainLength - m_grainRemaining;
+            if (played < m_fadeLength) {
+                grainGain = fadeGain(float(played) / m_fadeLength);
+            } else if (m_grainRemaining < m_fadeLength) {
+                grainGain = fadeGain(float(m_grainRemaining) / m_fadeLength);
+            } else {
+                grainGain = 1.;
+            }
+        }
+        float fadeOutGain = m_fadeRemaining > 0 ? fadeGain(float(m_fadeRemaining) / m_fadeLength) : 0.;
+        for (int c = 0; c < m_channels; ++c) {
+            float value = 0.;
+            if (grainGain > 0.) {
+                value += grainGain * sampleAt(m_grainPos, c);
+            }
+            if (fadeOutGain > 0.) {
+                value += fadeOutGain * sampleAt(m_fadePos, c);
+            }
+            out[i * m_channels + c] = qint16(qBound(-32768L, std::lrint(value * m_volume), 32767L));
+        }
+        if (m_grainRemaining > 0) {
+            m_grainPos++;
+            m_grainRemaining--;
+        }
+        if (m_fadeRemaining > 0) {
+            m_fadePos++;
+            m_fadeRemaining--;
+        }
+    }
+    return frames * frameSize;
+}
+
+qint64 AudioScrubber::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+    return 0;
+}
+
+qint64 AudioScrubber::bytesAvailable() const
+{
+    // We generate silence when there is nothing to play, so data is always available
+    return qint64(m_grainLength) * m_channels * int(sizeof(qint16)) + QIODevice::bytesAvailable();
+}
+
+bool AudioScrubber::isSequential() const
+{
+    return true;
+}
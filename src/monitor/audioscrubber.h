@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QFuture>
+#include <QIODevice>
+#include <QMutex>
+#include <QTimer>
+#include <QVector>
+#include <QWaitCondition>
+#include <memory>
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+class QAudioOutput;
+#else
+class QAudioSink;
+#endif
+
+namespace Mlt {
+class Producer;
+}
+
+/** @class AudioScrubber
+    @brief Plays audio feedback while seeking a monitor, independently of video decoding.
+    A worker thread decodes the audio around the playhead from a private copy of the monitor
+    producer into a ring buffer. The copy is only rebuilt when the audio content changes, and
+    parsed on the worker thread. Each seek request plays a short grain read from that buffer,
+    crossfaded with the previous one, so that jogging produces continuous low latency sound.
+ */
+class AudioScrubber : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit AudioScrubber(QObject *parent = nullptr);
+    ~AudioScrubber() override;
+
+    /** @brief Use @param producer as audio source, it is only copied on the first scrub request */
+    void setProducer(std::shared_ptr<Mlt::Producer> producer, double fps);
+    /** @brief Discard the decoded audio, because the audio of the source changed */
+    void invalidate();
+    /** @brief Set the output gain, like the monitor @param volume (0 to mute, 1 for full volume) */
+    void setVolume(double volume);
+    /** @brief Play a short grain of audio at frame @param position */
+    void scrub(int position);
+    /** @brief Stop the sound output, for example when playback starts */
+    void stop();
+
+    qint64 bytesAvailable() const override;
+    bool isSequential() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    /** @brief The decoding loop, exits after some time without request */
+    void decodeLoop();
+    /** @brief Returns the next frame to decode to cover the region around @param target, or -1 if done */
+    int nextFrameToDecode(int target) const;
+    /** @brief Returns the sample at @param samplePos for @param channel, or 0 if not decoded */
+    qint16 sampleAt(qint64 samplePos, int channel) const;
+    void startOutput();
+    /** @brief Select the sound device set in the settings and use its sample rate */
+    void configureDevice();
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    std::unique_ptr<QAudioOutput> m_output;
+#else
+    std::unique_ptr<QAudioSink> m_output;
+#endif
+    /** @brief Suspends the sound output when no scrub request comes */
+    QTimer m_idleTimer;
+    /** @brief The name of the sound device in use, empty for the default one */
+    QString m_deviceName;
+    std::shared_ptr<Mlt::Producer> m_sourceProducer;
+    double m_fps{25.};
+    int m_length{0};
+    int m_frequency;
+    int m_channels;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_decodeRequest;
+    QFuture<void> m_decodeFuture;
+    bool m_decoding{false};
+    bool m_abort{false};
+    /** @brief The private copy of the source, only used in the decoding thread */
+    std::shared_ptr<Mlt::Producer> m_decoder;
+    /** @brief The serialized source, to be parsed by the decoding thread as the new decoder */
+    QByteArray m_pendingXml;
+    /** @brief True if the decoder does not match the source audio anymore */
+    bool m_stale{true};
+    double m_volume{1.};
+    // The frame around which audio should be decoded
+    int m_target{-1};
+    // The interleaved samples, indexed by absolute sample position modulo the ring size
+    QVector<qint16> m_ring;
+    int m_ringSamples{0};
+    // The range of decoded frames stored in the ring, inclusive
+    int m_firstFrame{-1};
+    int m_lastFrame{-1};
+    // The same range, in absolute sample positions, end excluded
+    qint64 m_firstSample{0};
+    qint64 m_endSample{0};
+
+    // Grain playback state, in absolute sample positions
+    qint64 m_pendingGrain{-1};
+    qint64 m_grainPos{-1};
+    int m_grainRemaining{0};
+    qint64 m_fadePos{-1};
+    int m_fadeRemaining{0};
+    int m_grainLength;
+    int m_fadeLength;
+};
@@ -0,0 +1,112 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "framequeue.h"
+
+#include <QMutexLocker>
+
+FrameQueue::FrameQueue()
+    : m_maxFrames(3)
+    , m_maxBytes(0)
+    , m_maxLatency(500)
+    , m_queuedBytes(0)
+    , m_totalLatency(0)
+{
+}
+
+void FrameQueue::setLimits(int maxFrames, int maxMegabytes, int maxLatency)
+{
+    QMutexLocker lock(&m_mutex);
+    m_maxFrames = qMax(1, maxFrames);
+    m_maxBytes = qint64(qMax(0, maxMegabytes)) * 1024 * 1024;
+    m_maxLatency = qMax(0, maxLatency);
+    m_notFull.wakeAll();
+}
+
+bool FrameQueue::hasRoom(qint64 bytes) const
+{
+    if (m_frames.empty()) {
+        // Always accept at least one frame, whatever its size
+        return true;
+    }
+    if (int(m_frames.size()) >= m_maxFrames) {
+        return false;
+    }
+    return m_maxBytes == 0 || m_queuedBytes + bytes <= m_maxBytes;
+}
+
+bool FrameQueue::push(Mlt::Frame &frame, int timeout)
+{
+    // Estimate the decoded image size, yuv422 uses 2 bytes per pixel
+    qint64 bytes = qint64(frame.get_int("width")) * frame.get_int("height") * 2;
+    QMutexLocker lock(&m_mutex);
+    QElapsedTimer waited;
+    waited.start();
+    while (!hasRoom(bytes)) {
+        int remaining = timeout - int(waited.elapsed());
+        if (remaining <= 0) {
+            m_stats.dropped++;
+            return false;
+        }
+        m_notFull.wait(&m_mutex, remaining);
+    }
+    Entry entry{frame, bytes, QElapsedTimer()};
+    entry.age.start();
+    m_frames.push_back(entry);
+    m_queuedBytes += bytes;
+    m_stats.queued = int(m_frames.size());
+    m_stats.maxQueued = qMax(m_stats.maxQueued, m_stats.queued);
+    return true;
+}
+
+bool FrameQueue::pop(Mlt::Frame &frame)
+{
+    QMutexLocker lock(&m_mutex);
+    // Skip frames that waited too long, unless it is the most recent one
+    while (m_frames.size() > 1 && m_maxLatency > 0 && m_frames.front().age.elapsed() > m_maxLatency) {
+        m_queuedBytes -= m_frames.front().bytes;
+        m_frames.pop_front();
+        m_stats.late++;
+    }
+    if (m_frames.empty()) {
+        return false;
+    }
+    Entry &entry = m_frames.front();
+    int latency = int(entry.age.elapsed());
+    frame = entry.frame;
+    m_queuedBytes -= entry.bytes;
+    m_frames.pop_front();
+    m_stats.displayed++;
+    m_stats.queued = int(m_frames.size());
+    m_stats.maxLatency = qMax(m_stats.maxLatency, latency);
+    m_totalLatency += latency;
+    m_stats.averageLatency = double(m_totalLatency) / m_stats.displayed;
+    m_notFull.wakeAll();
+    return true;
+}
+
+void FrameQueue::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_frames.clear();
+    m_queuedBytes = 0;
+    m_stats.queued = 0;
+    m_notFull.wakeAll();
+}
+
+FrameQueue::Statistics FrameQueue::statistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
+
+void FrameQueue::resetStatistics()
+{
+    QMutexLocker lock(&m_mutex);
+    int queued = m_stats.queued;
+    m_stats = Statistics();
+    m_stats.queued = queued;
+    m_totalLatency = 0;
+}
@@ -0,0 +1,72 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <deque>
+#include <mlt++/MltFrame.h>
+
+/** @class FrameQueue
+    @brief A bounded queue of rendered frames between the MLT consumer thread and the FrameRenderer.
+    The queue absorbs short stalls of the display thread instead of dropping frames. Its size is
+    limited in frames and optionally in memory, and frames waiting longer than the allowed latency
+    are skipped when a more recent frame is available.
+ */
+class FrameQueue
+{
+public:
+    struct Statistics
+    {
+        /** @brief Frames currently waiting for display */
+        int queued = 0;
+        /** @brief Highest number of frames waiting at the same time */
+        int maxQueued = 0;
+        /** @brief Frames displayed since last reset */
+        int displayed = 0;
+        /** @brief Frames rejected because the queue was full */
+        int dropped = 0;
+        /** @brief Frames skipped because they exceeded the latency limit */
+        int late = 0;
+        /** @brief Average and maximum time (in ms) spent by a frame in the queue */
+        double averageLatency = 0.;
+        int maxLatency = 0;
+    };
+
+    FrameQueue();
+    /** @brief Set the queue limits. @param maxMegabytes is ignored if 0, @param maxLatency is in milliseconds */
+    void setLimits(int maxFrames, int maxMegabytes, int maxLatency);
+    /** @brief Append a frame, waiting at most @param timeout ms for a free slot.
+     *  @returns false if the frame was dropped */
+    bool push(Mlt::Frame &frame, int timeout);
+    /** @brief Take the oldest frame that is still within the latency limit.
+     *  @returns false if the queue is empty */
+    bool pop(Mlt::Frame &frame);
+    /** @brief Discard all waiting frames, for example after a seek */
+    void clear();
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Entry
+    {
+        Mlt::Frame frame;
+        qint64 bytes;
+        QElapsedTimer age;
+    };
+    std::deque<Entry> m_frames;
+    mutable QMutex m_mutex;
+    QWaitCondition m_notFull;
+    int m_maxFrames;
+    qint64 m_maxBytes;
+    int m_maxLatency;
+    qint64 m_queuedBytes;
+    Statistics m_stats;
+    qint64 m_totalLatency;
+    /** @brief Returns true if a frame of @param bytes can be added without exceeding the limits */
+    bool hasRoom(qint64 bytes) const;
+};
@@ -35,11 +35,13 @@
 #include <KMessageBox>
 
 
+#include "audioscrubber.h"
 #include "bin/model/markersortmodel.h"
 #include "core.h"
 #include "glwidget.h"
 #include "monitorproxy.h"
 #include "profiles/profilemodel.hpp"
+#include "scrubcache.h"
 #include "timeline2/view/qml/timelineitems.h"
 #include "timeline2/view/qmltypes/thumbnailprovider.h"
 #include <lib/localeHandling.h>
@@ -107,6 +109,10 @@ GLWidget::GLWidget(int id, QWidget *parent)
     , m_isLoopMode(false)
     , m_loopIn(0)
     , m_offset(QPoint(0, 0))
+    , m_scrubTarget(-1)
+    , m_autoScaling(1)
+    , m_autoScalingFrames(0)
+    , m_lastPlayedFrame(-1)
     , m_fbo(nullptr)
     , m_shareContext(nullptr)
     , m_openGLSync(false)
@@ -157,6 +163,14 @@ GLWidget::GLWidget(int id, QWidget *parent)
     m_blackClip->set("kdenlive:id", "black");
     m_blackClip->set("out", 3);
     connect(&m_refreshTimer, &QTimer::timeout, this, &GLWidget::refresh);
+    m_scrubTimer.setSingleShot(true);
+    m_scrubTimer.setInterval(150);
+    connect(&m_scrubTimer, &QTimer::timeout, this, [this]() {
+        if (m_scrubTarget > -1 && qFuzzyIsNull(m_producer->get_speed())) {
+            requestSeek(m_scrubTarget, true);
+        }
+        m_scrubTarget = -1;
+    });
     m_producer = m_blackClip;
     rootContext()->setContextProperty("markersModel", nullptr);
     if (!initGPUAccel()) {
@@ -251,9 +265,9 @@ void GLWidget::initializeGL()
     }
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    m_frameRenderer = new FrameRenderer(quickWindow()->openglContext(), &m_offscreenSurface, m_ClientWaitSync);
+    m_frameRenderer = new FrameRenderer(quickWindow()->openglContext(), &m_offscreenSurface, m_ClientWaitSync, &m_frameQueue);
 #else
-    m_frameRenderer = new FrameRenderer(&context, &m_offscreenSurface, m_ClientWaitSync);
+    m_frameRenderer = new FrameRenderer(&context, &m_offscreenSurface, m_ClientWaitSync, &m_frameQueue);
 #endif
 
     m_frameRenderer->sendAudioForAnalysis = KdenliveSettings::monitor_audio();
@@ -726,22 +740,96 @@ bool GLWidget::isReady() const
 
 void GLWidget::requestSeek(int position, bool noAudioScrub)
 {
+    // Audio grains are decoded separately, so they also play for frames displayed from the scrub cache
+    bool grainScrub = KdenliveSettings::audio_scrub() && KdenliveSettings::audioscrubengine() && !noAudioScrub && qFuzzyIsNull(m_producer->get_speed());
+    if (grainScrub) {
+        if (!m_audioScrubber) {
+            m_audioScrubber = std::make_unique<AudioScrubber>();
+            m_audioScrubber->setProducer(m_producer, pCore->getCurrentFps());
+            m_audioScrubber->setVolume(qMax(0, volume()) / 100.);
+        }
+        m_audioScrubber->scrub(position);
+    }
+    if (KdenliveSettings::scrubcache() && qFuzzyIsNull(m_producer->get_speed())) {
+        bool fastScrub = m_lastSeek.isValid() && m_lastSeek.elapsed() < 100;
+        m_lastSeek.start();
+        m_scrubTimer.stop();
+        if (seekFromScrubCache(position)) {
+            return;
+        }
+        if (fastScrub) {
+            // Decoding the closest keyframe is much faster than decoding from it to the requested frame
+            int keyframe = ScrubCache::get()->previousKeyframe(m_scrubResource, position, pCore->getCurrentFps());
+            if (keyframe > -1 && keyframe < position && position - keyframe <= 2 * qRound(pCore->getCurrentFps())) {
+                m_scrubTarget = position;
+                m_scrubTimer.start();
+                if (seekFromScrubCache(keyframe)) {
+                    return;
+                }
+                position = keyframe;
+            }
+        }
+    }
     m_producer->seek(position);
     if (!qFuzzyIsNull(m_producer->get_speed())) {
         m_consumer->purge();
+        m_frameQueue.clear();
     }
     restartConsumer();
     m_consumer->set("refresh", 1);
-    if (KdenliveSettings::audio_scrub() && !noAudioScrub) {
+    if (KdenliveSettings::audio_scrub() && !noAudioScrub && !grainScrub) {
         m_consumer->set("scrub_audio", 1);
     } else {
         m_consumer->set("scrub_audio", 0);
     }
 }
 
+bool GLWidget::seekFromScrubCache(int position)
+{
+    // GPU frames reference textures that are recycled, they cannot be cached
+    if (m_glslManager || m_frameRenderer == nullptr || m_consumer == nullptr) {
+        return false;
+    }
+    Mlt::Frame frame;
+    if (!ScrubCache::get()->getFrame(m_scrubKey, position, frame)) {
+        return false;
+    }
+    if (frame.get_int("width") != m_consumer->get_int("width") || frame.get_int("height") != m_consumer->get_int("height")) {
+        // Frame cached by the other monitor at another resolution
+        return false;
+    }
+    m_producer->seek(position);
+    m_frameQueue.clear();
+    if (m_frameQueue.push(frame, 0)) {
+        QMetaObject::invokeMethod(m_frameRenderer, "showFrame", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+void GLWidget::invalidateScrubCache()
+{
+    ScrubCache::get()->invalidate(m_scrubKey);
+}
+
+void GLWidget::invalidateAudioScrub()
+{
+    if (m_audioScrubber) {
+        m_audioScrubber->invalidate();
+    }
+}
+
+void GLWidget::requestGopIndex(const QString &resource)
+{
+    if (KdenliveSettings::scrubcache()) {
+        m_scrubResource = resource;
+        ScrubCache::get()->requestGopIndex(resource);
+    }
+}
+
 void GLWidget::requestRefresh()
 {
     if (m_producer && qFuzzyIsNull(m_producer->get_speed())) {
+        invalidateScrubCache();
         m_consumer->set("scrub_audio", 0);
         m_refreshTimer.start();
     }
@@ -755,6 +843,7 @@ QString GLWidget::frameToTime(int frames) const
 void GLWidget::refresh()
 {
     m_refreshTimer.stop();
+    invalidateScrubCache();
     QMutexLocker locker(&m_mltMutex);
     if (m_consumer) {
         restartConsumer();
@@ -766,6 +855,10 @@ bool GLWidget::checkFrameNumber(int pos, bool isPlaying)
 {
     const double speed = m_producer->get_speed();
     m_proxy->positionFromConsumer(pos, isPlaying);
+    if (m_id == Kdenlive::ProjectMonitor) {
+        recordPlayedFrame(pos, isPlaying, speed);
+    }
+    updateAutoScaling(isPlaying && qFuzzyCompare(speed, 1.0));
     if (m_isLoopMode || m_isZoneMode) {
         // not sure why we need to check against pos + 1 but otherwise the
         // playback shows one frame after the intended out frame
@@ -1023,6 +1116,15 @@ int GLWidget::setProducer(const std::shared_ptr<Mlt::Producer> &producer, bool i
     }
     m_producer->set_speed(0);
     m_proxy->setSpeed(0);
+    // Identify the content rather than the monitor, so that both monitors share the frames of a clip
+    m_scrubKey = QString(m_producer->parent().get("kdenlive:id"));
+    if (m_scrubKey.isEmpty()) {
+        m_scrubKey = QStringLiteral("producer:%1").arg(quintptr(m_producer->get_producer()));
+    }
+    m_scrubResource.clear();
+    if (m_audioScrubber) {
+        m_audioScrubber->setProducer(m_producer, pCore->getCurrentFps());
+    }
     error = reconfigure();
     if (error == 0) {
         // The profile display aspect ratio may have changed.
@@ -1059,6 +1161,105 @@ void GLWidget::resetDrops()
     if (m_consumer) {
         m_consumer->set("drop_count", 0);
     }
+    m_frameQueue.resetStatistics();
+}
+
+FrameQueue::Statistics GLWidget::frameQueueStatistics() const
+{
+    return m_frameQueue.statistics();
+}
+
+void GLWidget::recordPlayedFrame(int pos, bool isPlaying, double speed)
+{
+    if (!isPlaying || !qFuzzyCompare(speed, 1.0)) {
+        m_lastPlayedFrame = -1;
+        return;
+    }
+    const int chunkSize = KdenliveSettings::timelinechunks();
+    int dropped = 0;
+    if (m_lastPlayedFrame >= 0) {
+        int delta = pos - m_lastPlayedFrame;
+        if (delta <= 0 || delta > chunkSize) {
+            // Seek or loop during playback, not a frame drop
+            m_lastPlayedFrame = pos;
+            return;
+        }
+        dropped = delta - 1;
+    }
+    m_lastPlayedFrame = pos;
+    QMutexLocker lock(&m_chunkDropsMutex);
+    QPoint &stats = m_chunkDrops[pos - pos % chunkSize];
+    if (stats.x() >= 4 * chunkSize) {
+        // Decay older measurements so that the cost follows the latest playbacks
+        stats /= 2;
+    }
+    stats.rx()++;
+    stats.ry() += dropped;
+}
+
+void GLWidget::updateAutoScaling(bool isPlaying)
+{
+    if (!KdenliveSettings::autopreviewscaling()) {
+        return;
+    }
+    if (!isPlaying) {
+        m_autoScalingTimer.invalidate();
+        if (m_autoScaling > 1) {
+            // Paused, display the frame at full preview resolution
+            m_autoScaling = 1;
+            if (updateScaling()) {
+                m_refreshTimer.start();
+            }
+        }
+        return;
+    }
+    if (!m_autoScalingTimer.isValid()) {
+        m_autoScalingTimer.start();
+        m_autoScalingFrames = 0;
+        return;
+    }
+    m_autoScalingFrames++;
+    qint64 elapsed = m_autoScalingTimer.elapsed();
+    if (elapsed < 1000) {
+        return;
+    }
+    // Compare the average time spent per displayed frame with the frame duration
+    double frameTime = double(elapsed) / m_autoScalingFrames;
+    double budget = 1000. / pCore->getCurrentFps();
+    if (frameTime > budget * 1.1 && m_autoScaling < 4) {
+        m_autoScaling *= 2;
+        updateScaling();
+    }
+    m_autoScalingTimer.start();
+    m_autoScalingFrames = 0;
+}
+
+QMap<int, double> GLWidget::chunkPlaybackCosts() const
+{
+    QMap<int, double> costs;
+    QMutexLocker lock(&m_chunkDropsMutex);
+    QMapIterator<int, QPoint> i(m_chunkDrops);
+    while (i.hasNext()) {
+        i.next();
+        if (i.value().x() > 0) {
+            costs.insert(i.key(), double(i.value().x() + i.value().y()) / i.value().x());
+        }
+    }
+    return costs;
+}
+
+void GLWidget::resetChunkDrops(int startFrame, int endFrame)
+{
+    QMutexLocker lock(&m_chunkDropsMutex);
+    if (startFrame < 0) {
+        m_chunkDrops.clear();
+        return;
+    }
+    const int chunkSize = KdenliveSettings::timelinechunks();
+    auto it = m_chunkDrops.lowerBound(startFrame - startFrame % chunkSize);
+    while (it != m_chunkDrops.end() && it.key() <= endFrame) {
+        it = m_chunkDrops.erase(it);
+    }
 }
 
 void GLWidget::stopCapture()
@@ -1147,6 +1348,8 @@ int GLWidget::reconfigure()
             dropFrames = -dropFrames;
         }
         m_consumer->set("real_time", dropFrames);
+        m_frameQueue.setLimits(KdenliveSettings::monitor_framequeue(), KdenliveSettings::monitor_framequeuemb(),
+                               KdenliveSettings::monitor_framequeuelatency());
         m_consumer->set("channels", pCore->audioChannels());
         if (KdenliveSettings::previewScaling() > 1) {
             m_consumer->set("scale", 1.0 / KdenliveSettings::previewScaling());
@@ -1383,9 +1586,13 @@ void GLWidget::on_frame_show(mlt_consumer, GLWidget *widget, mlt_event_data data
 {
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.is_valid() && frame.get_int("rendered")) {
+        if (KdenliveSettings::scrubcache() && qFuzzyIsNull(frame.get_double("_speed"))) {
+            // Paused or seeking, keep the frame for scrubbing
+            ScrubCache::get()->storeFrame(widget->m_scrubKey, frame.get_position(), frame);
+        }
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
-        if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
-            QMetaObject::invokeMethod(widget->m_frameRenderer, "showFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
+        if ((widget->m_frameRenderer != nullptr) && widget->m_frameQueue.push(frame, timeout)) {
+            QMetaObject::invokeMethod(widget->m_frameRenderer, "showFrame", Qt::QueuedConnection);
         }
     }
 }
@@ -1395,8 +1602,8 @@ void GLWidget::on_gl_nosync_frame_show(mlt_consumer, GLWidget *widget, mlt_event
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.get_int("rendered") != 0) {
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
-        if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
-            QMetaObject::invokeMethod(widget->m_frameRenderer, "showGLNoSyncFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
+        if ((widget->m_frameRenderer != nullptr) && widget->m_frameQueue.push(frame, timeout)) {
+            QMetaObject::invokeMethod(widget->m_frameRenderer, "showGLNoSyncFrame", Qt::QueuedConnection);
         }
     }
 }
@@ -1406,8 +1613,8 @@ void GLWidget::on_gl_frame_show(mlt_consumer, GLWidget *widget, mlt_event_data d
     auto frame = Mlt::EventData(data).to_frame();
     if (frame.get_int("rendered") != 0) {
         int timeout = (widget->consumer()->get_int("real_time") > 0) ? 0 : 1000;
-        if ((widget->m_frameRenderer != nullptr) && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
-            QMetaObject::invokeMethod(widget->m_frameRenderer, "showGLFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
+        if ((widget->m_frameRenderer != nullptr) && widget->m_frameQueue.push(frame, timeout)) {
+            QMetaObject::invokeMethod(widget->m_frameRenderer, "showGLFrame", Qt::QueuedConnection);
         }
     }
 }
@@ -1449,9 +1656,9 @@ void RenderThread::run()
     }
 }
 
-FrameRenderer::FrameRenderer(QOpenGLContext *shareContext, QSurface *surface, GLWidget::ClientWaitSync_fp clientWaitSync)
+FrameRenderer::FrameRenderer(QOpenGLContext *shareContext, QSurface *surface, GLWidget::ClientWaitSync_fp clientWaitSync, FrameQueue *queue)
     : QThread(nullptr)
-    , m_semaphore(3)
+    , m_queue(queue)
     , m_context(nullptr)
     , m_surface(surface)
     , m_ClientWaitSync(clientWaitSync)
@@ -1480,8 +1687,13 @@ FrameRenderer::~FrameRenderer()
     delete m_gl32;
 }
 
-void FrameRenderer::showFrame(Mlt::Frame frame)
+void FrameRenderer::showFrame()
 {
+    Mlt::Frame frame;
+    if (!m_queue->pop(frame)) {
+        // Frame was skipped or queue purged
+        return;
+    }
     // Save this frame for future use and to keep a reference to the GL Texture.
     m_displayFrame = SharedFrame(frame);
 
@@ -1503,11 +1715,15 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
     // The frame is now done being modified and can be shared with the rest
     // of the application.
     Q_EMIT frameDisplayed(m_displayFrame);
-    m_semaphore.release();
 }
 
-void FrameRenderer::showGLFrame(Mlt::Frame frame)
+void FrameRenderer::showGLFrame()
 {
+    Mlt::Frame frame;
+    if (!m_queue->pop(frame)) {
+        // Frame was skipped or queue purged
+        return;
+    }
     if ((m_context != nullptr) && m_context->isValid()) {
         m_context->makeCurrent(m_surface);
         pipelineSyncToFrame(frame);
@@ -1521,11 +1737,15 @@ void FrameRenderer::showGLFrame(Mlt::Frame frame)
     // The frame is now done being modified and can be shared with the rest
     // of the application.
     Q_EMIT frameDisplayed(m_displayFrame);
-    m_semaphore.release();
 }
 
-void FrameRenderer::showGLNoSyncFrame(Mlt::Frame frame)
+void FrameRenderer::showGLNoSyncFrame()
 {
+    Mlt::Frame frame;
+    if (!m_queue->pop(frame)) {
+        // Frame was skipped or queue purged
+        return;
+    }
     if ((m_context != nullptr) && m_context->isValid()) {
 
         frame.set("movit.convert.use_texture", 1);
@@ -1540,7 +1760,6 @@ void FrameRenderer::showGLNoSyncFrame(Mlt::Frame frame)
     // The frame is now done being modified and can be shared with the rest
     // of the application.
     Q_EMIT frameDisplayed(m_displayFrame);
-    m_semaphore.release();
 }
 
 void FrameRenderer::cleanup()
@@ -1612,6 +1831,9 @@ void GLWidget::switchPlay(bool play, int offset, double speed)
             m_producer->seek(0);
         }
         qDebug() << "pos: " << m_consumer->position() << "out-offset: " << m_producer->get_out() - offset;
+        if (m_audioScrubber) {
+            m_audioScrubber->stop();
+        }
         double current_speed = m_producer->get_speed();
         m_producer->set_speed(speed);
         m_proxy->setSpeed(speed);
@@ -1627,6 +1849,7 @@ void GLWidget::switchPlay(bool play, int offset, double speed)
         } else {
             // Speed change, purge to reduce latency
             m_consumer->purge();
+            m_frameQueue.clear();
             m_producer->seek(m_consumer->position() + (speed > 1. ? 1 : 0));
         }
     } else {
@@ -1636,6 +1859,7 @@ void GLWidget::switchPlay(bool play, int offset, double speed)
         m_proxy->setSpeed(0);
         m_producer->seek(m_consumer->position() + 1);
         m_consumer->purge();
+        m_frameQueue.clear();
         m_consumer->start();
         m_consumer->set("scrub_audio", 0);
     }
@@ -1777,6 +2001,7 @@ void GLWidget::stop()
     }
     if (m_consumer) {
         m_consumer->purge();
+        m_frameQueue.clear();
         if (!m_consumer->is_stopped()) {
             m_consumer->stop();
         }
@@ -1822,6 +2047,9 @@ void GLWidget::setVolume(double volume)
             m_consumer->set("volume", volume);
         }
     }
+    if (m_audioScrubber) {
+        m_audioScrubber->setVolume(volume);
+    }
 }
 
 int GLWidget::duration() const
@@ -1867,12 +2095,24 @@ bool GLWidget::updateScaling()
         pWidth++;
     }
     QSize profileSize(pWidth, previewHeight);
+    if (!KdenliveSettings::autopreviewscaling()) {
+        m_autoScaling = 1;
+    }
+    if (m_autoScaling > 1) {
+        // The reduced size only applies to this monitor's consumer, the profile is shared with the other monitor
+        int scaledHeight = previewHeight / m_autoScaling;
+        int scaledWidth = pWidth / m_autoScaling;
+        profileSize = QSize(scaledWidth + scaledWidth % 2, scaledHeight + scaledHeight % 2);
+    } else if (pCore->getMonitorProfile().width() != pWidth || pCore->getMonitorProfile().height() != previewHeight) {
+        // Cached frames don't match the new monitor resolution
+        ScrubCache::get()->clear();
+        pCore->getMonitorProfile().set_width(pWidth);
+        pCore->getMonitorProfile().set_height(previewHeight);
+    }
     if (profileSize == m_profileSize) {
         return false;
     }
     m_profileSize = profileSize;
-    pCore->getMonitorProfile().set_width(m_profileSize.width());
-    pCore->getMonitorProfile().set_height(m_profileSize.height());
     if (m_consumer) {
         m_consumer->set("width", m_profileSize.width());
         m_consumer->set("height", m_profileSize.height());
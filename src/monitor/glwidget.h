@@ -15,6 +15,7 @@
 #include <QOpenGLFunctions>
 #include <QOpenGLShaderProgram>
 #include <QQuickWidget>
+#include <QElapsedTimer>
 #include <QRect>
 #include <QSemaphore>
 #include <QThread>
@@ -22,6 +23,7 @@
 
 #include "bin/model/markerlistmodel.hpp"
 #include "definitions.h"
+#include "framequeue.h"
 #include "kdenlivesettings.h"
 #include "scopes/sharedframe.h"
 
@@ -35,6 +37,7 @@ class Producer;
 class Consumer;
 } // namespace Mlt
 
+class AudioScrubber;
 class RenderThread;
 class FrameRenderer;
 class MonitorProxy;
@@ -96,6 +99,13 @@ public:
     void releaseMonitor();
     int droppedFrames() const;
     void resetDrops();
+    /** @brief Returns drop and latency statistics of the queue between consumer and display */
+    FrameQueue::Statistics frameQueueStatistics() const;
+    /** @brief Returns the estimated real-time cost of timeline preview chunks measured during playback,
+     *  keyed by chunk start frame. A cost of 1.0 means the chunk exactly fits in the frame budget. */
+    QMap<int, double> chunkPlaybackCosts() const;
+    /** @brief Forget playback measurements for chunks between @param startFrame and @param endFrame (all chunks if -1) */
+    void resetChunkDrops(int startFrame = -1, int endFrame = -1);
     bool checkFrameNumber(int pos, bool isPlaying);
     /** @brief Return current timeline position */
     int getCurrentPos() const;
@@ -126,6 +136,12 @@ public:
     void switchRuler(bool show);
     /** @brief Returns true if consumer is initialized */
     bool isReady() const;
+    /** @brief Discard the frames cached for scrubbing, because the displayed content changed */
+    void invalidateScrubCache();
+    /** @brief Rebuild the audio scrubbing source on next seek, because the audio of the displayed content changed */
+    void invalidateAudioScrub();
+    /** @brief Build the keyframe index of the displayed clip to allow keyframe snapping while scrubbing */
+    void requestGopIndex(const QString &resource);
 
 protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
@@ -210,6 +226,8 @@ private:
     Mlt::Event *m_displayEvent;
     Mlt::Event *m_renderEvent;
     FrameRenderer *m_frameRenderer;
+    /** @brief Frames rendered by the consumer, waiting to be displayed */
+    FrameQueue m_frameQueue;
     int m_projectionLocation;
     int m_modelViewLocation;
     int m_vertexLocation;
@@ -229,6 +247,31 @@ private:
     QPoint m_offset;
     MonitorProxy *m_proxy;
     std::shared_ptr<Mlt::Producer> m_blackClip;
+    /** @brief Per chunk playback statistics: x is the count of displayed frames, y the count of dropped frames */
+    QMap<int, QPoint> m_chunkDrops;
+    mutable QMutex m_chunkDropsMutex;
+    /** @brief Identifies the displayed producer in the scrub cache */
+    QString m_scrubKey;
+    /** @brief The file displayed, whose keyframes are used to scrub fast */
+    QString m_scrubResource;
+    /** @brief Used to display the exact frame once fast scrubbing stops */
+    QTimer m_scrubTimer;
+    QElapsedTimer m_lastSeek;
+    int m_scrubTarget;
+    /** @brief Plays audio grains while seeking, created on first use */
+    std::unique_ptr<AudioScrubber> m_audioScrubber;
+    /** @brief Display the frame at @param position from the scrub cache, returns false if not cached */
+    bool seekFromScrubCache(int position);
+    /** @brief Resolution divider applied on top of the preview scaling while playback is too slow (1, 2 or 4) */
+    int m_autoScaling;
+    QElapsedTimer m_autoScalingTimer;
+    int m_autoScalingFrames;
+    /** @brief Measure the display rate during playback and adjust the automatic preview scaling */
+    void updateAutoScaling(bool isPlaying);
+    /** @brief Last frame displayed during normal speed playback, -1 if none */
+    int m_lastPlayedFrame;
+    /** @brief Update the per chunk drop counter with the newly displayed frame */
+    void recordPlayedFrame(int pos, bool isPlaying, double speed);
     static void on_frame_show(mlt_consumer, GLWidget* widget, mlt_event_data);
     static void on_frame_render(mlt_consumer, GLWidget *widget, mlt_frame frame);
     static void on_gl_frame_show(mlt_consumer, GLWidget *widget, mlt_event_data data);
@@ -309,13 +352,13 @@ class FrameRenderer : public QThread
 {
     Q_OBJECT
 public:
-    explicit FrameRenderer(QOpenGLContext *shareContext, QSurface *surface, GLWidget::ClientWaitSync_fp clientWaitSync);
+    explicit FrameRenderer(QOpenGLContext *shareContext, QSurface *surface, GLWidget::ClientWaitSync_fp clientWaitSync, FrameQueue *queue);
     ~FrameRenderer() override;
-    QSemaphore *semaphore() { return &m_semaphore; }
     QOpenGLContext *context() const { return m_context; }
-    Q_INVOKABLE void showFrame(Mlt::Frame frame);
-    Q_INVOKABLE void showGLFrame(Mlt::Frame frame);
-    Q_INVOKABLE void showGLNoSyncFrame(Mlt::Frame frame);
+    /** @brief Display the next frame waiting in the queue */
+    Q_INVOKABLE void showFrame();
+    Q_INVOKABLE void showGLFrame();
+    Q_INVOKABLE void showGLNoSyncFrame();
 
 public Q_SLOTS:
     void cleanup();
@@ -325,7 +368,7 @@ Q_SIGNALS:
     void frameDisplayed(const SharedFrame &frame);
 
 private:
-    QSemaphore m_semaphore;
+    FrameQueue *m_queue;
     SharedFrame m_displayFrame;
     QOpenGLContext *m_context;
     QSurface *m_surface;
@@ -328,6 +328,7 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
     m_playAction->setInactiveIcon(QIcon::fromTheme(QStringLiteral("media-playback-start")));
     m_playAction->setActiveIcon(QIcon::fromTheme(QStringLiteral("media-playback-pause")));
     connect(m_glMonitor, &GLWidget::monitorPlay, m_playAction, &QAction::trigger);
+    connect(m_playAction, &KDualAction::activeChanged, this, &Monitor::playStateChanged);
 
     QString strippedTooltip = m_playAction->toolTip().remove(QRegularExpression(QStringLiteral("\\s\\(.*\\)")));
     // append shortcut if it exists for action
@@ -1523,6 +1524,7 @@ void Monitor::forceMonitorRefresh()
 
 void Monitor::refreshMonitor(bool directUpdate)
 {
+    m_glMonitor->invalidateScrubCache();
     if (!m_glMonitor->isReady() || isPlaying()) {
         return;
     }
@@ -1555,6 +1557,8 @@ bool Monitor::monitorVisible() const
 
 void Monitor::refreshMonitorIfActive(bool directUpdate)
 {
+    // Frames cached for scrubbing are outdated, even if the monitor is not active
+    m_glMonitor->invalidateScrubCache();
     if (!m_glMonitor->isReady() || !isActive()) {
         return;
     }
@@ -1658,6 +1662,16 @@ bool Monitor::isPlaying() const
     return m_playAction->isActive();
 }
 
+QMap<int, double> Monitor::chunkPlaybackCosts() const
+{
+    return m_glMonitor->chunkPlaybackCosts();
+}
+
+void Monitor::resetChunkPlaybackCosts(int startFrame, int endFrame)
+{
+    m_glMonitor->resetChunkDrops(startFrame, endFrame);
+}
+
 void Monitor::resetPlayOrLoopZone(const QString &binId)
 {
     if (activeClipId() == binId) {
@@ -1843,6 +1857,9 @@ void Monitor::slotOpenClip(const std::shared_ptr<ProjectClip> &controller, int i
                 slotActivateMonitor();
             }
             buildBackgroundedProducer(in);
+            if (controller->clipType() == ClipType::AV || controller->clipType() == ClipType::Video) {
+                m_glMonitor->requestGopIndex(controller->clipUrl());
+            }
         } else {
             qDebug() << "*************** CONTROLLER NOT READY";
         }
@@ -1933,6 +1950,7 @@ void Monitor::resetProfile()
     m_glMonitor->rootObject()->setProperty("framesize", QRect(0, 0, m_glMonitor->profileSize().width(), m_glMonitor->profileSize().height()));
     // Update drop frame info
     m_qmlManager->setProperty(QStringLiteral("dropped"), false);
+    m_qmlManager->setProperty(QStringLiteral("queueInfo"), QString());
     m_qmlManager->setProperty(QStringLiteral("fps"), QString::number(pCore->getCurrentFps(), 'f', 2));
 }
 
@@ -2146,12 +2164,20 @@ void Monitor::onFrameDisplayed(const SharedFrame &frame)
 void Monitor::checkDrops()
 {
     int dropped = m_glMonitor->droppedFrames();
+    // Frames dropped or skipped by the display queue are not counted by MLT
+    const FrameQueue::Statistics stats = m_glMonitor->frameQueueStatistics();
+    if (stats.dropped > 0 || stats.late > 0) {
+        m_qmlManager->setProperty(QStringLiteral("queueInfo"),
+                                  i18n("Display: %1 dropped, %2 late, %3ms latency", stats.dropped, stats.late, stats.maxLatency));
+    } else {
+        m_qmlManager->setProperty(QStringLiteral("queueInfo"), QString());
+    }
+    m_glMonitor->resetDrops();
     if (dropped == 0) {
         // No dropped frames since last check
-        m_qmlManager->setProperty(QStringLiteral("dropped"), false);
+        m_qmlManager->setProperty(QStringLiteral("dropped"), stats.dropped > 0 || stats.late > 0);
         m_qmlManager->setProperty(QStringLiteral("fps"), QString::number(pCore->getCurrentFps(), 'f', 2));
     } else {
-        m_glMonitor->resetDrops();
         dropped = int(pCore->getCurrentFps() - dropped);
         m_qmlManager->setProperty(QStringLiteral("dropped"), true);
         m_qmlManager->setProperty(QStringLiteral("fps"), QString::number(dropped, 'f', 2));
@@ -2164,10 +2190,16 @@ void Monitor::reloadProducer(const QString &id)
         return;
     }
     if (m_controller->AbstractProjectItem::clipId() == id) {
+        m_glMonitor->invalidateScrubCache();
         slotOpenClip(m_controller);
     }
 }
 
+void Monitor::invalidateAudioScrub()
+{
+    m_glMonitor->invalidateAudioScrub();
+}
+
 QString Monitor::getMarkerThumb(GenTime pos)
 {
     if (!m_controller) {
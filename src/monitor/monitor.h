@@ -75,6 +75,8 @@ public:
     /** @brief Controller for the clip currently displayed (only valid for clip monitor). */
     std::shared_ptr<ProjectClip> currentController() const;
     void reloadProducer(const QString &id);
+    /** @brief The audio of the displayed content changed, audio scrubbing has to reload it. */
+    void invalidateAudioScrub();
     /** @brief Reimplemented from QWidget, updates the palette colors. */
     void setPalette(const QPalette &p);
     /** @brief Returns current project's fps. */
@@ -142,6 +144,10 @@ public:
     void normalizeAudioThumbs();
     /** @brief Returns true if monitor is playing */
     bool isPlaying() const;
+    /** @brief Returns the real-time cost of timeline chunks measured during playback, keyed by chunk start frame */
+    QMap<int, double> chunkPlaybackCosts() const;
+    /** @brief Discard playback measurements for the chunks between @param startFrame and @param endFrame */
+    void resetChunkPlaybackCosts(int startFrame = -1, int endFrame = -1);
     /** @brief Enables / disables effect scene*/
     void enableEffectScene(bool enable);
     /** @brief Update the document's uuid - used for qml thumb cache*/
@@ -357,6 +363,8 @@ public Q_SLOTS:
 Q_SIGNALS:
     void screenChanged(int screenIndex);
     void seekPosition(int pos);
+    /** @brief Playback started or stopped */
+    void playStateChanged(bool playing);
     void seekRemap(int pos);
     void updateScene();
     void durationChanged(int);
@@ -9,6 +9,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "doc/kdenlivedoc.h"
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
+#include "scrubcache.h"
 #include "timeline2/view/timelinewidget.h"
 
 #include <mlt++/Mlt.h>
@@ -609,6 +610,17 @@ void MonitorManager::setupActions()
     audioScrub->setCheckable(true);
     audioScrub->setChecked(KdenliveSettings::audio_scrub());
 
+    QAction *scrubCache = new QAction(i18n("Cache Frames for Scrubbing"), this);
+    connect(scrubCache, &QAction::triggered, this, [&](bool enable) {
+        KdenliveSettings::setScrubcache(enable);
+        if (!enable) {
+            ScrubCache::get()->clear();
+        }
+    });
+    pCore->window()->addAction(QStringLiteral("mlt_scrub_cache"), scrubCache);
+    scrubCache->setCheckable(true);
+    scrubCache->setChecked(KdenliveSettings::scrubcache());
+
     m_muteAction = new KDualAction(i18n("Mute Monitor"), i18n("Unmute Monitor"), this);
     m_muteAction->setActiveIcon(QIcon::fromTheme(QStringLiteral("audio-volume-medium")));
     m_muteAction->setInactiveIcon(QIcon::fromTheme(QStringLiteral("audio-volume-muted")));
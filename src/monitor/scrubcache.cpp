@@ -0,0 +1,184 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "scrubcache.h"
+#include "kdenlivesettings.h"
+
+#include <QMutexLocker>
+#include <QProcess>
+#include <QtConcurrent>
+#include <algorithm>
+
+// Number of files for which the keyframe index is kept
+static const size_t maxGopIndexes = 32;
+
+std::unique_ptr<ScrubCache> ScrubCache::instance;
+std::once_flag ScrubCache::m_onceFlag;
+
+ScrubCache::ScrubCache()
+    : m_maxCost(qint64(KdenliveSettings::scrubcachesize()) * 1024 * 1024)
+{
+}
+
+std::unique_ptr<ScrubCache> &ScrubCache::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new ScrubCache()); });
+    return instance;
+}
+
+static QString frameKey(const QString &key, int pos)
+{
+    return QStringLiteral("%1#%2").arg(key).arg(pos);
+}
+
+void ScrubCache::remove(const QString &frameKey)
+{
+    auto found = m_cache.find(frameKey);
+    if (found == m_cache.end()) {
+        return;
+    }
+    auto it = found->second;
+    m_currentCost -= it->second.second;
+    m_cache.erase(found);
+    m_data.erase(it);
+}
+
+bool ScrubCache::getFrame(const QString &key, int pos, Mlt::Frame &frame)
+{
+    QMutexLocker lock(&m_mutex);
+    auto found = m_cache.find(frameKey(key, pos));
+    if (found == m_cache.end()) {
+        return false;
+    }
+    // Move to front to remember last access
+    m_data.splice(m_data.begin(), m_data, found->second);
+    frame = found->second->second.first;
+    return true;
+}
+
+void ScrubCache::storeFrame(const QString &key, int pos, Mlt::Frame &frame)
+{
+    // yuv422 uses 2 bytes per pixel
+    qint64 cost = qint64(frame.get_int("width")) * frame.get_int("height") * 2;
+    QMutexLocker lock(&m_mutex);
+    if (cost <= 0 || cost > m_maxCost) {
+        return;
+    }
+    const QString id = frameKey(key, pos);
+    remove(id);
+    m_data.push_front({id, {frame, cost}});
+    m_cache[id] = m_data.begin();
+    m_currentCost += cost;
+    while (m_currentCost > m_maxCost) {
+        remove(m_data.back().first);
+    }
+}
+
+void ScrubCache::invalidate(const QString &key)
+{
+    if (key.isEmpty()) {
+        return;
+    }
+    const QString prefix = key + QLatin1Char('#');
+    QMutexLocker lock(&m_mutex);
+    for (auto it = m_data.begin(); it != m_data.end();) {
+        if (it->first.startsWith(prefix)) {
+            m_currentCost -= it->second.second;
+            m_cache.erase(it->first);
+            it = m_data.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ScrubCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_data.clear();
+    m_cache.clear();
+    m_currentCost = 0;
+}
+
+void ScrubCache::updateCapacity()
+{
+    QMutexLocker lock(&m_mutex);
+    m_maxCost = qint64(KdenliveSettings::scrubcachesize()) * 1024 * 1024;
+    while (!m_data.empty() && m_currentCost > m_maxCost) {
+        remove(m_data.back().first);
+    }
+}
+
+void ScrubCache::requestGopIndex(const QString &resource)
+{
+    if (KdenliveSettings::ffprobepath().isEmpty() || resource.isEmpty()) {
+        return;
+    }
+    QMutexLocker lock(&m_mutex);
+    auto found = std::find(m_gopOrder.begin(), m_gopOrder.end(), resource);
+    if (found != m_gopOrder.end()) {
+        // Already built or in progress
+        m_gopOrder.splice(m_gopOrder.begin(), m_gopOrder, found);
+        return;
+    }
+    m_gopIndex[resource] = std::vector<double>();
+    m_gopOrder.push_front(resource);
+    while (m_gopOrder.size() > maxGopIndexes) {
+        m_gopIndex.erase(m_gopOrder.back());
+        m_gopOrder.pop_back();
+    }
+    lock.unlock();
+    QtConcurrent::run([this, resource]() {
+        // Only decode keyframes, which is fast even for long files
+        QProcess probe;
+        probe.start(KdenliveSettings::ffprobepath(), {QStringLiteral("-v"), QStringLiteral("error"), QStringLiteral("-select_streams"), QStringLiteral("v:0"),
+                                                      QStringLiteral("-skip_frame"), QStringLiteral("nokey"), QStringLiteral("-show_entries"),
+                                                      QStringLiteral("frame=pts_time"), QStringLiteral("-of"), QStringLiteral("csv=p=0"), resource});
+        if (!probe.waitForFinished(-1) || probe.exitCode() != 0) {
+            return;
+        }
+        std::vector<double> keyframes;
+        const QList<QByteArray> lines = probe.readAllStandardOutput().split('\n');
+        bool ok;
+        double start = -1;
+        for (const QByteArray &line : lines) {
+            double time = line.trimmed().toDouble(&ok);
+            if (!ok) {
+                continue;
+            }
+            if (start < 0) {
+                // Producer positions start at the first frame of the stream
+                start = time;
+            }
+            keyframes.push_back(time - start);
+        }
+        std::sort(keyframes.begin(), keyframes.end());
+        QMutexLocker lock(&m_mutex);
+        auto found = m_gopIndex.find(resource);
+        if (found != m_gopIndex.end()) {
+            // Not evicted while building
+            found->second = std::move(keyframes);
+        }
+    });
+}
+
+int ScrubCache::previousKeyframe(const QString &resource, int pos, double fps) const
+{
+    if (fps <= 0.) {
+        return -1;
+    }
+    QMutexLocker lock(&m_mutex);
+    auto found = m_gopIndex.find(resource);
+    if (found == m_gopIndex.end() || found->second.empty()) {
+        return -1;
+    }
+    const std::vector<double> &keyframes = found->second;
+    // Tolerate rounding of the keyframe times to the frame positions
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), (pos + 0.5) / fps);
+    if (it == keyframes.begin()) {
+        return -1;
+    }
+    return qRound(*(--it) * fps);
+}
@@ -0,0 +1,68 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <list>
+#include <memory>
+#include <mlt++/MltFrame.h>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/** @class ScrubCache
+    @brief Frames recently displayed by the monitors, to make scrubbing over the same region instant.
+    Frames are stored as rendered by the monitor consumer (so at monitor resolution) in a LRU cache
+    shared by clip and project monitors. Each source is identified by a key that does not depend on
+    the monitor, so a monitor can reuse the frames of the same source displayed by the other one.
+    All frames of a key are discarded as soon as its content changes.
+    For clips with long GOP compression, an index of the keyframe times of each file is built in the
+    background with ffprobe so that fast scrubbing can display the closest keyframe, which is cheap to decode.
+ * Note that this class is a Singleton
+ */
+class ScrubCache
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<ScrubCache> &get();
+
+    /** @brief Fetch the frame displayed at @param pos for @param key, returns false if not cached */
+    bool getFrame(const QString &key, int pos, Mlt::Frame &frame);
+    /** @brief Store a displayed frame, its cost is the size of its image */
+    void storeFrame(const QString &key, int pos, Mlt::Frame &frame);
+    /** @brief Discard all frames of a source because its content changed */
+    void invalidate(const QString &key);
+    /** @brief Discard all frames, for example when the monitor resolution changed */
+    void clear();
+    /** @brief Update the memory limit from the settings */
+    void updateCapacity();
+
+    /** @brief Build the keyframe index of @param resource in a background thread, if not already done */
+    void requestGopIndex(const QString &resource);
+    /** @brief Returns the last keyframe of @param resource before or at frame @param pos, or -1 if unknown */
+    int previousKeyframe(const QString &resource, int pos, double fps) const;
+
+protected:
+    // Constructor is protected because class is a Singleton
+    ScrubCache();
+    static std::unique_ptr<ScrubCache> instance;
+    static std::once_flag m_onceFlag; // flag to create the cache only once
+
+    void remove(const QString &frameKey);
+
+    mutable QMutex m_mutex;
+    qint64 m_maxCost;
+    qint64 m_currentCost{0};
+    // The frames are stored as (key,(frame, cost)) in a std::list, most recently used first
+    std::list<std::pair<QString, std::pair<Mlt::Frame, qint64>>> m_data;
+    std::unordered_map<QString, decltype(m_data.begin())> m_cache;
+    // The sorted keyframe times (in seconds) for each file, an empty vector means the index is being built
+    std::unordered_map<QString, std::vector<double>> m_gopIndex;
+    // The indexed files, most recently requested first
+    std::list<QString> m_gopOrder;
+};
@@ -26,6 +26,7 @@ Item {
     property bool captureRightClick: false
     property bool dropped: false
     property string fps: '-'
+    property string queueInfo: ''
     property bool showMarkers: false
     property bool showTimecode: false
     property bool showFps: false
@@ -193,7 +194,7 @@ Item {
                 background: Rectangle {
                     color: root.dropped ? "#99ff0000" : "#66004400"
                 }
-                text: i18n("%1fps", root.fps)
+                text: root.queueInfo.length > 0 ? i18n("%1fps", root.fps) + "\n" + root.queueInfo : i18n("%1fps", root.fps)
                 visible: root.showFps
                 anchors {
                     right: timecode.visible ? timecode.left : parent.right
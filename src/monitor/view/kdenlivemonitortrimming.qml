@@ -24,6 +24,7 @@ Item {
     property bool captureRightClick: false
     property bool dropped: false
     property string fps: '-'
+    property string queueInfo: ''
     property bool showMarkers: false
     property bool showTimecode: false
     property bool showFps: false
@@ -154,14 +154,9 @@ SlideshowClip::SlideshowClip(const Timecode &tc, QString clipFolder, ProjectClip
         const QString &entry = values.at(i);
         // Create thumbnails
         if (!entry.isEmpty() && (entry.endsWith(QLatin1String(".png")) || entry.endsWith(QLatin1String(".pgm")))) {
-            if (MainWindow::m_lumacache.contains(entry)) {
-                m_view.luma_file->addItem(QPixmap::fromImage(MainWindow::m_lumacache.value(entry)), names.at(i), entry);
-            } else {
-                QImage pix(entry);
-                if (!pix.isNull()) {
-                    MainWindow::m_lumacache.insert(entry, pix.scaled(50, 30, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-                    m_view.luma_file->addItem(QPixmap::fromImage(MainWindow::m_lumacache.value(entry)), names.at(i), entry);
-                }
+            const QImage thumb = MainWindow::lumaThumbnail(entry);
+            if (!thumb.isNull()) {
+                m_view.luma_file->addItem(QPixmap::fromImage(thumb), names.at(i), entry);
             }
         }
     }
@@ -290,20 +290,27 @@ void ScopeManager::checkActiveColourScopes()
 
 void ScopeManager::createScopes()
 {
-    createScopeDock(new Vectorscope(pCore->window()), i18n("Vectorscope"), QStringLiteral("vectorscope"));
-    createScopeDock(new Waveform(pCore->window()), i18n("Waveform"), QStringLiteral("waveform"));
-    createScopeDock(new RGBParade(pCore->window()), i18n("RGB Parade"), QStringLiteral("rgb_parade"));
-    createScopeDock(new Histogram(pCore->window()), i18n("Histogram"), QStringLiteral("histogram"));
+    createScopeDock<Vectorscope>(i18n("Vectorscope"), QStringLiteral("vectorscope"));
+    createScopeDock<Waveform>(i18n("Waveform"), QStringLiteral("waveform"));
+    createScopeDock<RGBParade>(i18n("RGB Parade"), QStringLiteral("rgb_parade"));
+    createScopeDock<Histogram>(i18n("Histogram"), QStringLiteral("histogram"));
     // Deprecated scopes
     // createScopeDock(new Spectrogram(pCore->window()),   i18n("Spectrogram"));
     // createScopeDock(new AudioSignal(pCore->window()),   i18n("Audio Signal"));
     // createScopeDock(new AudioSpectrum(pCore->window()), i18n("AudioSpectrum"));
 }
 
-template <class T> void ScopeManager::createScopeDock(T *scopeWidget, const QString &title, const QString &name)
+template <class T> void ScopeManager::createScopeDock(const QString &title, const QString &name)
 {
-    QDockWidget *dock = pCore->window()->addDock(title, name, scopeWidget);
-    addScope(scopeWidget, dock);
+    // Scopes are only created when their dock is first shown
+    QDockWidget *dock = pCore->window()->addLazyDock(title, name, [this](QDockWidget *scopeDock) {
+        T *scopeWidget = new T(pCore->window());
+        addScope(scopeWidget, scopeDock);
+        // The dock was just shown, ask for data
+        slotCheckActiveScopes();
+        slotRequestFrame(scopeWidget->widgetName());
+        return scopeWidget;
+    });
 
     // close for initial layout
     // actual state will be restored by session management
@@ -114,6 +114,8 @@ bool constructTimelineFromTractor(const std::shared_ptr<TimelineItemModel> &time
     // Import master track effects
     std::shared_ptr<Mlt::Service> serv = std::make_shared<Mlt::Service>(tractor.get_service());
     timeline->importMasterEffects(serv);
+    // Clip effects are built in parallel once all tracks are loaded
+    timeline->startQueueingClipEffects();
 
     QList<int> videoTracksIndexes;
     QList<int> lockedTracksIndexes;
@@ -231,6 +233,7 @@ bool constructTimelineFromTractor(const std::shared_ptr<TimelineItemModel> &time
             qWarning() << "Unexpected track type" << track->type();
         }
     }
+    timeline->importQueuedClipEffects();
     timeline->_resetView();
 
     // Loading compositions
@@ -356,6 +359,8 @@ bool constructTimelineFromMelt(const std::shared_ptr<TimelineItemModel> &timelin
     // Import master track effects
     std::shared_ptr<Mlt::Service> serv = std::make_shared<Mlt::Service>(tractor.get_service());
     timeline->importMasterEffects(serv);
+    // Clip effects are built in parallel once all tracks are loaded
+    timeline->startQueueingClipEffects();
 
     QList<int> videoTracksIndexes;
     QList<int> lockedTracksIndexes;
@@ -470,6 +475,7 @@ bool constructTimelineFromMelt(const std::shared_ptr<TimelineItemModel> &timelin
             qWarning() << "Unexpected track type" << track->type();
         }
     }
+    timeline->importQueuedClipEffects();
     timeline->_resetView();
 
     // Loading compositions
@@ -52,10 +52,20 @@ ClipModel::ClipModel(const std::shared_ptr<TimelineModel> &parent, std::shared_p
     }
     QObject::connect(m_effectStack.get(), &EffectStackModel::dataChanged, [&](const QModelIndex &, const QModelIndex &, const QVector<int> &roles) {
         qDebug() << "// GOT CLIP STACK DATA CHANGE: " << roles;
+        // Any change of the effects makes a previous cost measurement obsolete. The stack may be
+        // modified while this clip is locked, so don't lock here: like setEffectCost, this runs in the GUI thread
+        const bool hadCost = m_effectCost >= 0;
+        m_effectCost = -1;
         if (m_currentTrackId != -1) {
             if (auto ptr = m_parent.lock()) {
                 QModelIndex ix = ptr->makeClipIndexFromID(m_id);
-                Q_EMIT ptr->dataChanged(ix, ix, roles);
+                if (hadCost) {
+                    QVector<int> updatedRoles = roles;
+                    updatedRoles << TimelineModel::EffectCostRole;
+                    Q_EMIT ptr->dataChanged(ix, ix, updatedRoles);
+                } else {
+                    Q_EMIT ptr->dataChanged(ix, ix, roles);
+                }
                 qDebug() << "// GOT CLIP STACK DATA CHANGE DONE: " << ix << " = " << roles;
             }
         }
@@ -131,7 +141,9 @@ int ClipModel::construct(const std::shared_ptr<TimelineModel> &parent, const QSt
             producer->parent().set("out", out);
         }
     }
-    clip->m_effectStack->importEffects(producer, state, result.second, originalDecimalPoint);
+    if (!parent->queueClipEffects(id, clip->m_effectStack, producer, state, result.second, originalDecimalPoint)) {
+        clip->m_effectStack->importEffects(producer, state, result.second, originalDecimalPoint);
+    }
     clip->m_clipMarkerModel->setReferenceModel(binClip->getMarkerModel(), speed);
     return id;
 }
@@ -1269,6 +1281,18 @@ const QStringList ClipModel::externalFiles() const
     return m_effectStack->externalFiles();
 }
 
+void ClipModel::setEffectCost(double cost)
+{
+    QWriteLocker locker(&m_lock);
+    m_effectCost = cost;
+}
+
+double ClipModel::effectCost() const
+{
+    READ_LOCK();
+    return m_effectCost;
+}
+
 int ClipModel::getFakeTrackId() const
 {
     return m_fakeTrack;
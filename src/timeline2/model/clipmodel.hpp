@@ -83,6 +83,11 @@ public:
     /** @brief Returns a list of external files (e.g. LUTs) used by the effects of the clip */
     const QStringList externalFiles() const;
 
+    /** @brief Store the measured playback cost of the clip with its effects, as a ratio of the frame duration */
+    void setEffectCost(double cost);
+    /** @brief Returns the measured playback cost of the clip with its effects, -1 if unknown or if the effects changed since the measurement */
+    double effectCost() const;
+
     /** @brief Returns the timeline clip status (video / audio only) */
     PlaylistState::ClipState clipState() const;
     /** @brief Returns the bin clip type (image, color, AV, ...) */
@@ -277,4 +282,6 @@ protected:
     int m_mixCutPos;
     /** @brief True if the clip has a timeremap effect */
     bool m_hasTimeRemap;
+    /** @brief Playback cost of the clip with its effects, reset to -1 when its effect stack changes */
+    double m_effectCost = -1;
 };
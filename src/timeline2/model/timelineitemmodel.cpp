@@ -280,6 +280,7 @@ QHash<int, QByteArray> TimelineItemModel::roleNames() const
     roles[EffectNamesRole] = "effectNames";
     roles[EffectsEnabledRole] = "isStackEnabled";
     roles[EffectZonesRole] = "effectZones";
+    roles[EffectCostRole] = "effectCost";
     roles[GrabbedRole] = "isGrabbed";
     roles[SelectedRole] = "selected";
     return roles;
@@ -369,6 +370,8 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
             return m_groups->isInGroup(id);
         case EffectNamesRole:
             return clip->effectNames();
+        case EffectCostRole:
+            return clip->effectCost();
         case InPointRole:
             return clip->getIn();
         case OutPointRole:
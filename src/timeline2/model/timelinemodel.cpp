@@ -31,11 +31,13 @@
 #include <QDebug>
 #include <QModelIndex>
 #include <QThread>
+#include <QtConcurrent>
 #include <mlt++/MltConsumer.h>
 #include <mlt++/MltField.h>
 #include <mlt++/MltProfile.h>
 #include <mlt++/MltTractor.h>
 #include <mlt++/MltTransition.h>
+#include <numeric>
 #include <queue>
 #include <set>
 
@@ -5649,6 +5651,46 @@ void TimelineModel::importMasterEffects(std::weak_ptr<Mlt::Service> service)
     m_masterStack->importEffects(std::move(service), PlaylistState::Disabled, false, QString(), m_uuid);
 }
 
+void TimelineModel::startQueueingClipEffects()
+{
+    m_queueClipEffects = true;
+}
+
+bool TimelineModel::queueClipEffects(int clipId, const std::shared_ptr<EffectStackModel> &stack, const std::shared_ptr<Mlt::Producer> &producer,
+                                     PlaylistState::ClipState state, bool alreadyExist, const QString &originalDecimalPoint)
+{
+    if (!m_queueClipEffects) {
+        return false;
+    }
+    m_queuedEffectImports.push_back({clipId, stack, producer, state, alreadyExist, originalDecimalPoint});
+    return true;
+}
+
+void TimelineModel::importQueuedClipEffects()
+{
+    m_queueClipEffects = false;
+    std::vector<QueuedEffectImport> imports;
+    std::swap(imports, m_queuedEffectImports);
+    // Parsing the effects and building their keyframes is the slow part, do it for all clips in parallel.
+    // This thread waits so that the models can safely query the timeline while they are built.
+    std::vector<std::vector<EffectStackModel::BuiltEffect>> built(imports.size());
+    std::vector<size_t> indexes(imports.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    QtConcurrent::blockingMap(indexes, [&imports, &built](size_t ix) {
+        const QueuedEffectImport &job = imports[ix];
+        built[ix] = job.stack->buildEffects(job.producer, job.alreadyExist, job.originalDecimalPoint);
+    });
+    // Insert the models sequentially, in clip order
+    for (size_t ix = 0; ix < imports.size(); ++ix) {
+        const QueuedEffectImport &job = imports[ix];
+        if (!isClip(job.clipId)) {
+            // Clip was removed while loading, for example because of a broken mix
+            continue;
+        }
+        job.stack->insertEffects(job.producer, std::move(built[ix]), job.state, job.alreadyExist);
+    }
+}
+
 QStringList TimelineModel::extractCompositionLumas() const
 {
     QStringList urls;
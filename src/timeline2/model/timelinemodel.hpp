@@ -164,7 +164,8 @@ public:
         SelectedRole,       /// clip+composition only
         TrackActiveRole,    /// track only
         AudioRecordRole,    /// track only
-        EffectZonesRole     /// track only
+        EffectZonesRole,    /// track only
+        EffectCostRole      /// clip only
     };
 
     ~TimelineModel() override;
@@ -843,6 +844,13 @@ public:
     void prepareClose(bool softDelete = false);
     /** @brief Import project's master effects */
     void importMasterEffects(std::weak_ptr<Mlt::Service> service);
+    /** @brief Start queueing the effect imports of the constructed clips, so that importQueuedClipEffects can build them in parallel on project load */
+    void startQueueingClipEffects();
+    /** @brief Queue the import of the effects of @param producer into the stack of clip @param clipId. Returns false if imports are not queued */
+    bool queueClipEffects(int clipId, const std::shared_ptr<EffectStackModel> &stack, const std::shared_ptr<Mlt::Producer> &producer,
+                          PlaylistState::ClipState state, bool alreadyExist, const QString &originalDecimalPoint);
+    /** @brief Stop queueing, build the queued clip effects on worker threads and insert them in their stacks */
+    void importQueuedClipEffects();
     /** @brief Create a mix selection with currently selected clip. If delta = -1, mix with previous clip, +1 with next clip and 0 will check cursor position*/
     bool mixClip(int idToMove = -1, const QString &mixId = QStringLiteral("luma"), int delta = 0);
     Q_INVOKABLE bool resizeStartMix(int cid, int duration, bool singleResize);
@@ -1004,6 +1012,19 @@ protected:
 
     static int next_id; /// next valid id to assign
 
+    /** @brief A clip effect import delayed until all the tracks are loaded */
+    struct QueuedEffectImport
+    {
+        int clipId;
+        std::shared_ptr<EffectStackModel> stack;
+        std::shared_ptr<Mlt::Producer> producer;
+        PlaylistState::ClipState state;
+        bool alreadyExist;
+        QString originalDecimalPoint;
+    };
+    bool m_queueClipEffects{false};
+    std::vector<QueuedEffectImport> m_queuedEffectImports;
+
     std::unique_ptr<GroupsModel> m_groups;
     std::shared_ptr<SnapModel> m_snaps;
     std::shared_ptr<SubtitleModel> m_subtitleModel{nullptr};
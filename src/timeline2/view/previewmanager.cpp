@@ -35,9 +35,14 @@ PreviewManager::PreviewManager(Mlt::Tractor *tractor, QUuid uuid, QObject *paren
     , m_warnOnCrash(true)
     , m_previewTrackIndex(-1)
     , m_initialized(false)
+    , m_predictiveRender(false)
+    , m_playheadPosition(0)
+    , m_playbackDirection(1)
 {
     m_previewGatherTimer.setSingleShot(true);
     m_previewGatherTimer.setInterval(200);
+    m_predictiveTimer.setSingleShot(true);
+    m_predictiveTimer.setInterval(5000);
     QObject::connect(&m_previewProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &PreviewManager::processEnded);
 
     // Find path for Kdenlive renderer
@@ -125,6 +130,10 @@ bool PreviewManager::initialize()
     connect(&m_previewTimer, &QTimer::timeout, this, &PreviewManager::startPreviewRender);
     connect(this, &PreviewManager::previewRender, this, &PreviewManager::gotPreviewRender, Qt::DirectConnection);
     connect(&m_previewGatherTimer, &QTimer::timeout, this, &PreviewManager::slotProcessDirtyChunks);
+    connect(&m_predictiveTimer, &QTimer::timeout, this, &PreviewManager::slotPredictiveRender);
+    connect(pCore->getMonitor(Kdenlive::ProjectMonitor), &Monitor::seekPosition, this, &PreviewManager::slotPlayheadMoved);
+    connect(pCore->getMonitor(Kdenlive::ProjectMonitor), &Monitor::playStateChanged, this,
+            [this]() { slotPlayheadMoved(pCore->getMonitor(Kdenlive::ProjectMonitor)->position()); });
     m_initialized = true;
     return true;
 }
@@ -189,6 +198,7 @@ void PreviewManager::loadChunks(QVariantList previewChunks, QVariantList dirtyCh
         Q_EMIT dirtyChunksChanged();
     }
     if (!previewChunks.isEmpty()) {
+        loadPredictiveChunks();
         Q_EMIT renderedChunksChanged();
     }
 }
@@ -201,6 +211,7 @@ void PreviewManager::deletePreviewTrack()
     m_previewTrack = nullptr;
     m_dirtyChunks.clear();
     m_renderedChunks.clear();
+    m_predictiveChunks.clear();
     Q_EMIT dirtyChunksChanged();
     Q_EMIT renderedChunksChanged();
     m_tractor->unlock();
@@ -448,6 +459,10 @@ void PreviewManager::clearPreviewRange(bool resetZones)
     }
     m_tractor->unlock();
     m_renderedChunks.clear();
+    m_predictiveChunks.clear();
+    if (pCore->currentTimelineId() == m_uuid) {
+        pCore->getMonitor(Kdenlive::ProjectMonitor)->resetChunkPlaybackCosts();
+    }
     // Reload preview params
     loadParams();
     if (resetZones) {
@@ -466,6 +481,8 @@ void PreviewManager::addPreviewRange(const QPoint zone, bool add)
     QMutexLocker lock(&m_dirtyMutex);
     for (int i = startChunk; i <= endChunk; i++) {
         int frame = i * chunkSize;
+        // Chunks in a user defined zone are not managed by predictive rendering anymore
+        m_predictiveChunks.removeAll(frame);
         if (add) {
             if (!m_renderedChunks.contains(frame) && !m_dirtyChunks.contains(frame)) {
                 m_dirtyChunks << frame;
@@ -514,7 +531,7 @@ void PreviewManager::addPreviewRange(const QPoint zone, bool add)
     }
 }
 
-void PreviewManager::abortRendering()
+void PreviewManager::abortRendering(bool wait)
 {
     if (m_previewProcess.state() == QProcess::NotRunning) {
         return;
@@ -522,6 +539,10 @@ void PreviewManager::abortRendering()
     // Don't display error message on voluntary abort
     m_warnOnCrash = false;
     Q_EMIT abortPreview();
+    if (!wait) {
+        // processEnded will do the cleanup
+        return;
+    }
     m_previewProcess.waitForFinished();
     if (m_previewProcess.state() != QProcess::NotRunning) {
         m_previewProcess.kill();
@@ -542,25 +563,31 @@ void PreviewManager::startPreviewRender()
     if (!m_dirtyChunks.isEmpty()) {
         // Abort any rendering
         abortRendering();
-        m_waitingThumbs.clear();
-        // clear log
-        m_errorLog.clear();
-        const QString sceneList = m_cacheDir.absoluteFilePath(QStringLiteral("preview.mlt"));
-        if (!KdenliveSettings::proxypreview() && pCore->currentDoc()->useProxy()) {
-            const QString playlist =
-                pCore->projectItemModel()->sceneList(m_cacheDir.absolutePath(), QString(), QString(), pCore->currentDoc()->getTimeline(m_uuid)->tractor(), -1);
-            QDomDocument doc;
-            doc.setContent(playlist);
-            KdenliveDoc::useOriginals(doc);
-            if (!Xml::docContentToFile(doc, sceneList)) {
-                return;
-            }
-        } else {
-            pCore->currentDoc()->getTimeline(m_uuid)->sceneList(m_cacheDir.absolutePath(), sceneList);
+        m_predictiveRender = false;
+        renderDirtyChunks();
+    }
+}
+
+void PreviewManager::renderDirtyChunks()
+{
+    m_waitingThumbs.clear();
+    // clear log
+    m_errorLog.clear();
+    const QString sceneList = m_cacheDir.absoluteFilePath(QStringLiteral("preview.mlt"));
+    if (!KdenliveSettings::proxypreview() && pCore->currentDoc()->useProxy()) {
+        const QString playlist =
+            pCore->projectItemModel()->sceneList(m_cacheDir.absolutePath(), QString(), QString(), pCore->currentDoc()->getTimeline(m_uuid)->tractor(), -1);
+        QDomDocument doc;
+        doc.setContent(playlist);
+        KdenliveDoc::useOriginals(doc);
+        if (!Xml::docContentToFile(doc, sceneList)) {
+            return;
         }
-        m_previewTimer.stop();
-        doPreviewRender(sceneList);
+    } else {
+        pCore->currentDoc()->getTimeline(m_uuid)->sceneList(m_cacheDir.absolutePath(), sceneList);
     }
+    m_previewTimer.stop();
+    doPreviewRender(sceneList);
 }
 
 void PreviewManager::receivedStderr()
@@ -592,8 +619,18 @@ void PreviewManager::doPreviewRender(const QString &scene)
     QMutexLocker lock(&m_dirtyMutex);
     Q_ASSERT(m_previewProcess.state() == QProcess::NotRunning);
     std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunkSort);
-    const QStringList dirtyChunks = getCompressedList(m_dirtyChunks);
-    m_chunksToRender = m_dirtyChunks.count();
+    QVariantList chunks = m_dirtyChunks;
+    if (m_predictiveRender) {
+        // Only render our own chunks, leave the user defined zones alone
+        chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [this](const QVariant &c) { return !m_predictiveChunks.contains(c.toInt()); }),
+                     chunks.end());
+        if (chunks.isEmpty()) {
+            m_predictiveRender = false;
+            return;
+        }
+    }
+    const QStringList dirtyChunks = getCompressedList(chunks);
+    m_chunksToRender = chunks.count();
     m_processedChunks = 0;
     int chunkSize = KdenliveSettings::timelinechunks();
     QStringList args{QStringLiteral("preview-chunks"),
@@ -629,6 +666,10 @@ void PreviewManager::processEnded(int exitCode, QProcess::ExitStatus status)
     }
     workingPreview = -1;
     m_warnOnCrash = true;
+    if (m_predictiveRender) {
+        m_predictiveRender = false;
+        dropPendingPredictiveChunks();
+    }
     Q_EMIT workingPreviewChanged();
 }
 
@@ -664,12 +705,16 @@ void PreviewManager::slotRemoveInvalidUndo(int ix)
 
 void PreviewManager::invalidatePreview(int startFrame, int endFrame)
 {
-    if (m_previewTrack == nullptr) {
-        return;
-    }
     int chunkSize = KdenliveSettings::timelinechunks();
     int start = startFrame - startFrame % chunkSize;
     int end = endFrame - endFrame % chunkSize;
+    if (pCore->currentTimelineId() == m_uuid) {
+        // Playback cost of the modified chunks is unknown until played again
+        pCore->getMonitor(Kdenlive::ProjectMonitor)->resetChunkPlaybackCosts(start, end);
+    }
+    if (m_previewTrack == nullptr) {
+        return;
+    }
 
     m_previewGatherTimer.stop();
     bool previewWasRunning = m_previewProcess.state() == QProcess::Running;
@@ -707,6 +752,12 @@ void PreviewManager::invalidatePreview(int startFrame, int endFrame)
                 delete prod;
                 QVariant val(i);
                 m_renderedChunks.removeAll(val);
+                if (m_predictiveChunks.removeAll(i) > 0) {
+                    // Predictive chunks are only rendered again if they are still too heavy
+                    m_cacheDir.remove(QStringLiteral("%1.%2").arg(i).arg(m_extension));
+                    chunksChanged = true;
+                    continue;
+                }
                 if (!m_dirtyChunks.contains(val)) {
                     QMutexLocker lock(&m_dirtyMutex);
                     m_dirtyChunks << val;
@@ -836,6 +887,7 @@ void PreviewManager::removeOverlayTrack()
 QPair<QStringList, QStringList> PreviewManager::previewChunks()
 {
     QMutexLocker lock(&m_dirtyMutex);
+    savePredictiveChunks();
     std::sort(m_renderedChunks.begin(), m_renderedChunks.end(), chunkSort);
     const QStringList renderedChunks = getCompressedList(m_renderedChunks);
     std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunkSort);
@@ -907,3 +959,198 @@ bool PreviewManager::isRunning() const
 {
     return workingPreview >= 0 || m_previewProcess.state() != QProcess::NotRunning;
 }
+
+void PreviewManager::slotPlayheadMoved(int position)
+{
+    if (!KdenliveSettings::predictivepreview() || pCore->currentTimelineId() != m_uuid) {
+        return;
+    }
+    if (position != m_playheadPosition) {
+        m_playbackDirection = position < m_playheadPosition ? -1 : 1;
+        m_playheadPosition = position;
+    }
+    if (pCore->getMonitor(Kdenlive::ProjectMonitor)->isPlaying()) {
+        m_predictiveTimer.stop();
+        if (m_predictiveRender) {
+            // Don't compete with playback for the cpu, and don't block it while the process exits
+            abortRendering(false);
+        }
+        return;
+    }
+    m_predictiveTimer.start();
+}
+
+void PreviewManager::slotPredictiveRender()
+{
+    if (!KdenliveSettings::predictivepreview() || m_previewTrack == nullptr || isRunning() || pCore->currentTimelineId() != m_uuid) {
+        return;
+    }
+    Monitor *monitor = pCore->getMonitor(Kdenlive::ProjectMonitor);
+    if (monitor->isPlaying()) {
+        return;
+    }
+    const QMap<int, double> costs = monitor->chunkPlaybackCosts();
+    if (costs.isEmpty()) {
+        return;
+    }
+    int chunkSize = KdenliveSettings::timelinechunks();
+    int range = KdenliveSettings::predictivepreviewrange();
+    int current = m_playheadPosition - m_playheadPosition % chunkSize;
+    // Chunks ahead of the playhead in playback direction come first, then a few behind it
+    QList<int> candidates;
+    for (int i = 0; i <= range; i++) {
+        candidates << current + m_playbackDirection * i * chunkSize;
+    }
+    for (int i = 1; i <= range / 4; i++) {
+        candidates << current - m_playbackDirection * i * chunkSize;
+    }
+    QList<int> toRender;
+    for (int chunk : qAsConst(candidates)) {
+        if (chunk < 0 || costs.value(chunk) <= 1.) {
+            // Chunk plays in real time or was never played
+            continue;
+        }
+        if (m_renderedChunks.contains(chunk) || m_dirtyChunks.contains(chunk)) {
+            continue;
+        }
+        toRender << chunk;
+    }
+    if (toRender.isEmpty()) {
+        return;
+    }
+    // Make sure we stay below the disk quota
+    qint64 averageSize = 0;
+    qint64 usage = cacheUsage(&averageSize);
+    qint64 quota = qint64(KdenliveSettings::predictivepreviewquota()) * 1024 * 1024;
+    qint64 missing = usage + averageSize * toRender.count() - quota;
+    if (missing > 0) {
+        missing = evictPredictiveChunks(missing, candidates);
+        if (missing > 0) {
+            int excess = int((missing + averageSize - 1) / averageSize);
+            toRender = toRender.mid(0, qMax(0, toRender.count() - excess));
+        }
+    }
+    if (toRender.isEmpty()) {
+        return;
+    }
+    m_dirtyMutex.lock();
+    for (int chunk : qAsConst(toRender)) {
+        m_dirtyChunks << chunk;
+        m_predictiveChunks << chunk;
+    }
+    m_dirtyMutex.unlock();
+    Q_EMIT dirtyChunksChanged();
+    QMutexLocker lock(&m_previewMutex);
+    m_predictiveRender = true;
+    renderDirtyChunks();
+}
+
+qint64 PreviewManager::cacheUsage(qint64 *averageSize) const
+{
+    const QFileInfoList chunks = m_cacheDir.entryInfoList({QStringLiteral("*.%1").arg(m_extension)}, QDir::Files);
+    qint64 total = 0;
+    for (const QFileInfo &info : chunks) {
+        total += info.size();
+    }
+    // Without any rendered chunk, assume a high bitrate intermediate codec (~100Mb/s)
+    *averageSize = chunks.isEmpty() ? qint64(KdenliveSettings::timelinechunks() / pCore->getCurrentFps() * 12500000) : total / chunks.count();
+    *averageSize = qMax(*averageSize, qint64(1));
+    return total;
+}
+
+qint64 PreviewManager::evictPredictiveChunks(qint64 bytes, const QList<int> &keep)
+{
+    QList<int> evictable;
+    for (int chunk : qAsConst(m_predictiveChunks)) {
+        if (!keep.contains(chunk) && m_renderedChunks.contains(chunk)) {
+            evictable << chunk;
+        }
+    }
+    // Remove chunks farthest from the playhead first
+    std::sort(evictable.begin(), evictable.end(),
+              [this](int c1, int c2) { return qAbs(c1 - m_playheadPosition) > qAbs(c2 - m_playheadPosition); });
+    m_tractor->lock();
+    bool chunksChanged = false;
+    for (int chunk : qAsConst(evictable)) {
+        if (bytes <= 0) {
+            break;
+        }
+        const QString fileName = QStringLiteral("%1.%2").arg(chunk).arg(m_extension);
+        bytes -= QFileInfo(m_cacheDir.absoluteFilePath(fileName)).size();
+        m_cacheDir.remove(fileName);
+        int trackIx = m_previewTrack->get_clip_index_at(chunk);
+        if (!m_previewTrack->is_blank(trackIx)) {
+            Mlt::Producer *prod = m_previewTrack->replace_with_blank(trackIx);
+            delete prod;
+        }
+        m_renderedChunks.removeAll(QVariant(chunk));
+        m_predictiveChunks.removeAll(chunk);
+        // The measured cost was the one of the rendered chunk
+        pCore->getMonitor(Kdenlive::ProjectMonitor)->resetChunkPlaybackCosts(chunk, chunk);
+        chunksChanged = true;
+    }
+    if (chunksChanged) {
+        m_previewTrack->consolidate_blanks();
+    }
+    m_tractor->unlock();
+    if (chunksChanged) {
+        Q_EMIT renderedChunksChanged();
+    }
+    return bytes;
+}
+
+void PreviewManager::dropPendingPredictiveChunks()
+{
+    bool chunksChanged = false;
+    QMutexLocker lock(&m_dirtyMutex);
+    for (int i = m_predictiveChunks.count() - 1; i >= 0; i--) {
+        int chunk = m_predictiveChunks.at(i);
+        if (m_dirtyChunks.removeAll(QVariant(chunk)) > 0) {
+            m_predictiveChunks.removeAt(i);
+            chunksChanged = true;
+        }
+    }
+    lock.unlock();
+    if (chunksChanged) {
+        Q_EMIT dirtyChunksChanged();
+    }
+}
+
+void PreviewManager::savePredictiveChunks()
+{
+    const QString fileName = m_cacheDir.absoluteFilePath(QStringLiteral("predictive.txt"));
+    QVariantList chunks;
+    for (int chunk : qAsConst(m_predictiveChunks)) {
+        if (m_renderedChunks.contains(chunk)) {
+            chunks << chunk;
+        }
+    }
+    if (chunks.isEmpty()) {
+        QFile::remove(fileName);
+        return;
+    }
+    std::sort(chunks.begin(), chunks.end(), chunkSort);
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(getCompressedList(chunks).join(QLatin1Char(',')).toUtf8());
+    }
+}
+
+void PreviewManager::loadPredictiveChunks()
+{
+    QFile file(m_cacheDir.absoluteFilePath(QStringLiteral("predictive.txt")));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QStringList ranges = QString::fromUtf8(file.readAll()).split(QLatin1Char(','), Qt::SkipEmptyParts);
+    int chunkSize = KdenliveSettings::timelinechunks();
+    for (const QString &range : ranges) {
+        int start = range.section(QLatin1Char('-'), 0, 0).toInt();
+        int end = range.contains(QLatin1Char('-')) ? range.section(QLatin1Char('-'), 1, 1).toInt() : start;
+        for (int i = start; i <= end; i += chunkSize) {
+            if (m_renderedChunks.contains(i) && !m_predictiveChunks.contains(i)) {
+                m_predictiveChunks << i;
+            }
+        }
+    }
+}
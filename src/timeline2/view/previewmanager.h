@@ -30,6 +30,8 @@ class Producer;
     This allow us to get a preview with a smooth playback of our project.
     Only the preview zone is rendered. Once defined, a preview zone shows as a red line below
     the timeline ruler. As chunks are rendered, the zone turns to green.
+    In predictive mode, chunks around the playhead that dropped frames during playback are
+    also rendered when the project monitor is idle, within a disk quota.
  */
 class PreviewManager : public QObject
 {
@@ -49,8 +51,8 @@ public:
     void addPreviewRange(const QPoint zone, bool add);
     /** @brief: Remove all existing previews. */
     void clearPreviewRange(bool resetZones);
-    /** @brief: stops current rendering process. */
-    void abortRendering();
+    /** @brief: stops current rendering process, without waiting for the process to exit if @param wait is false. */
+    void abortRendering(bool wait = true);
     /** @brief: rendering parameters have changed, reload them. */
     bool loadParams();
     /** @brief: Create the preview track if not existing. */
@@ -115,6 +117,28 @@ private:
     void reloadChunks(const QVariantList &chunks);
     /** @brief: A chunk failed to render, abort. */
     void corruptedChunk(int workingPreview, const QString &fileName);
+    /** @brief: Timer used to start predictive rendering once the project monitor is idle. */
+    QTimer m_predictiveTimer;
+    /** @brief: Chunks that were added by predictive rendering and not by the user. */
+    QList<int> m_predictiveChunks;
+    /** @brief: True if the current render process only handles predictive chunks. */
+    bool m_predictiveRender;
+    /** @brief: Last known playhead position and playback direction (1 or -1). */
+    int m_playheadPosition;
+    int m_playbackDirection;
+    /** @brief: Write the preview playlist and start rendering dirty chunks. */
+    void renderDirtyChunks();
+    /** @brief: Returns the disk space used by rendered chunks, and their average size in @param averageSize. */
+    qint64 cacheUsage(qint64 *averageSize) const;
+    /** @brief: Delete predictive chunks far from the playhead until @param bytes are freed, never touching @param keep.
+     *  @returns the amount of bytes that could not be freed */
+    qint64 evictPredictiveChunks(qint64 bytes, const QList<int> &keep);
+    /** @brief: Remove predictive chunks that were not rendered from the dirty list. */
+    void dropPendingPredictiveChunks();
+    /** @brief: Store the list of predictive chunks in the cache folder, so that they can still be evicted after reopening the project. */
+    void savePredictiveChunks();
+    /** @brief: Restore the list of predictive chunks that are still rendered. */
+    void loadPredictiveChunks();
     /** @brief: Get a compressed list of chunks, like: "0-500,525,575". */
     const QStringList getCompressedList(const QVariantList items) const;
 
@@ -135,6 +159,10 @@ private Q_SLOTS:
     /** @brief: Process preview rendering output. */
     void receivedStderr();
     void processEnded(int exitCode, QProcess::ExitStatus status);
+    /** @brief: The project monitor moved or was paused, restart the idle timer for predictive rendering. */
+    void slotPlayheadMoved(int position);
+    /** @brief: Render the heavy chunks around the playhead that are not rendered yet. */
+    void slotPredictiveRender();
 
 public Q_SLOTS:
     /** @brief: Prepare and start rendering. */
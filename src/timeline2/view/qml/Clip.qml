@@ -23,6 +23,7 @@ Rectangle {
     property string clipResource: ''
     property string mltService: ''
     property string effectNames
+    property real effectCost: -1
     property int modelStart
     property int mixDuration: 0
     property int mixCut: 0
@@ -1018,6 +1019,28 @@ Rectangle {
                         styleColor: 'black'
                     }
                }
+               Rectangle {
+                    // playback cost of the effects, shown when they cannot play in real time
+                    id: effectCostRect
+                    color: '#cc0033'
+                    width: effectCostLabel.width + 2
+                    height: effectLabel.height
+                    anchors.top: effectsRect.top
+                    anchors.left: effectsRect.right
+                    visible: effectsRect.visible && clipRoot.effectCost > 1
+                    Text {
+                        id: effectCostLabel
+                        text: Math.round(clipRoot.effectCost * 100) + '%'
+                        font: miniFont
+                        visible: effectCostRect.visible
+                        anchors {
+                            top: effectCostRect.top
+                            left: effectCostRect.left
+                            leftMargin: 1
+                        }
+                        color: 'white'
+                    }
+               }
                Rectangle{
                     //proxy 
                     id:proxyRect
@@ -11,7 +11,7 @@ import com.enums 1.0
 Rectangle
 {
     id: keyframeContainer
-    property int kfrCount : keyframes.count
+    property int kfrCount : 0
     anchors.fill: parent
     color: Qt.rgba(1,1,0.8, 0.3)
     property int activeIndex
@@ -23,12 +23,39 @@ Rectangle
     property var kfrModel
     property int scrollStart
     property alias kfrCanvas: keyframecanvas
+    // Keyframe handles are only created when there is enough room to use them
+    property bool showHandles: keyframeContainer.selected && keyframeContainer.width > root.baseUnit * 3 && (kfrCount < (keyframeContainer.width / root.baseUnit)) && kfrCount > 1
     signal seek(int position)
 
+    function updateCount() {
+        kfrCount = kfrModel ? kfrModel.rowCount() : 0
+    }
+
+    onKfrModelChanged: updateCount()
+
+    Connections {
+        target: kfrModel
+        function onRowsInserted() { updateCount() }
+        function onRowsRemoved() { updateCount() }
+        function onDataChanged() {
+            if (!keyframeContainer.showHandles) {
+                keyframecanvas.requestPaint()
+            }
+        }
+        function onModelReset() {
+            updateCount()
+            keyframecanvas.requestPaint()
+        }
+    }
+
     onKfrCountChanged: {
         keyframecanvas.requestPaint()
     }
 
+    onShowHandlesChanged: {
+        keyframecanvas.requestPaint()
+    }
+
     onInPointChanged: {
         keyframecanvas.requestPaint()
     }
@@ -93,10 +120,10 @@ Rectangle
         // Keyframes container
         anchors.fill: parent
         z: 5
-        visible: keyframeContainer.selected && keyframeContainer.width > root.baseUnit * 3 && (kfrCount < (keyframeContainer.width / root.baseUnit)) && kfrCount > 1
+        visible: keyframeContainer.showHandles
         Repeater {
             id: keyframes
-            model: kfrModel
+            model: keyframeContainer.showHandles ? kfrModel : 0
             Rectangle {
                 id: keyframe
                 visible: root.activeTool === ProjectTool.SelectTool
@@ -309,6 +336,20 @@ Rectangle
             PathLine { }
         }
         property var paths : []
+        // Append the path elements reaching a keyframe, type is the type of the previous keyframe
+        function appendKeyframe(xpos, ypos, previousYpos, type) {
+            if (type === 0) {
+                // discrete
+                paths.push(compline.createObject(keyframecanvas, {"x": xpos, "y": previousYpos} ))
+            }
+            if (type < 2) {
+                // linear
+                paths.push(compline.createObject(keyframecanvas, {"x": xpos, "y": ypos} ))
+            } else if (type === 2) {
+                // curve
+                paths.push(comp.createObject(keyframecanvas, {"x": xpos, "y": ypos} ))
+            }
+        }
         Path {
             id: myPath
             startX: 0
@@ -325,29 +366,35 @@ Rectangle
             paths = []
             var xpos
             var ypos
-            for(var i = 0; i < keyframes.count; i++)
-            {
-                if (i + 1 < keyframes.count) {
-                    if (keyframes.itemAt(i + 1).tmpPos < offset) {
-                        continue;
+            var type
+            if (keyframes.count > 0) {
+                // Follow the handles, which can be dragged
+                for(var i = 0; i < keyframes.count; i++)
+                {
+                    if (i + 1 < keyframes.count) {
+                        if (keyframes.itemAt(i + 1).tmpPos < offset) {
+                            continue;
+                        }
+                    }
+                    xpos = keyframes.itemAt(i).tmpPos - offset
+                    type = i > 0 ? keyframes.itemAt(i-1).frameType : keyframes.itemAt(i).frameType
+                    appendKeyframe(xpos, keyframes.itemAt(i).tmpVal, ypos, type)
+                    ypos = keyframes.itemAt(i).tmpVal
+                    if (xpos > scrollView.width) {
+                        break;
                     }
                 }
-                xpos = keyframes.itemAt(i).tmpPos - offset
-                var type = i > 0 ? keyframes.itemAt(i-1).frameType : keyframes.itemAt(i).frameType
-                if (type === 0) {
-                    // discrete
-                    paths.push(compline.createObject(keyframecanvas, {"x": xpos, "y": ypos} ))
-                }
-                ypos = keyframes.itemAt(i).tmpVal
-                if (type < 2) {
-                    // linear
-                    paths.push(compline.createObject(keyframecanvas, {"x": xpos, "y": ypos} ))
-                } else if (type === 2) {
-                    // curve
-                    paths.push(comp.createObject(keyframecanvas, {"x": xpos, "y": ypos} ))
-                }
-                if (xpos > scrollView.width) {
-                    break;
+            } else {
+                // Only query the visible part of the curve, with at most one keyframe per pixel
+                var firstFrame = keyframeContainer.inPoint + Math.floor(offset / timeScale)
+                var points = kfrModel.curvePoints(firstFrame, firstFrame + Math.ceil(width / timeScale), Math.max(1, Math.round(width)))
+                for(var j = 0; j < points.length; j += 3)
+                {
+                    xpos = (points[j] - keyframeContainer.inPoint) * timeScale - offset
+                    type = j > 0 ? points[j - 1] : points[j + 2]
+                    var value = parent.height * (1 - points[j + 1])
+                    appendKeyframe(xpos, value, ypos, type)
+                    ypos = value
                 }
             }
             paths.push(compline.createObject(keyframecanvas, {"x": keyframecanvas.width, "y": ypos} ))
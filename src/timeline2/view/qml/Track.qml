@@ -144,6 +144,12 @@ Item{
                     value: model.effectNames
                     when: loader.status == Loader.Ready && clipItem
                 }
+                Binding {
+                    target: loader.item
+                    property: "effectCost"
+                    value: model.effectCost
+                    when: loader.status == Loader.Ready && clipItem
+                }
                 Binding {
                     target: loader.item
                     property: "clipStatus"
@@ -9,6 +9,7 @@
 #include "capture/mediacapture.h"
 #include "core.h"
 #include "kdenlivesettings.h"
+#include "lib/audio/loudnessMeter.h"
 #include <QElapsedTimer>
 #include <QPainter>
 #include <QPainterPath>
@@ -86,6 +87,7 @@ class TimelineWaveform : public QQuickPaintedItem
     Q_PROPERTY(bool format MEMBER m_format NOTIFY propertyChanged)
     Q_PROPERTY(bool enforceRepaint MEMBER m_repaint NOTIFY propertyChanged)
     Q_PROPERTY(bool normalize MEMBER m_normalize NOTIFY normalizeChanged)
+    Q_PROPERTY(bool showLoudness MEMBER m_showLoudness NOTIFY loudnessChanged)
     Q_PROPERTY(bool isFirstChunk MEMBER m_firstChunk)
     Q_PROPERTY(bool isOpaque MEMBER m_opaquePaint)
 
@@ -93,6 +95,7 @@ public:
     TimelineWaveform(QQuickItem *parent = nullptr)
         : QQuickPaintedItem(parent)
         , m_repaint(false)
+        , m_showLoudness(false)
         , m_speed(1.)
         , m_opaquePaint(false)
     {
@@ -110,6 +113,7 @@ public:
                 } else {
                     // Clip changed, reset levels
                     m_audioLevels.clear();
+                    m_loudness = LoudnessMap();
                 }
             }
         });
@@ -117,6 +121,17 @@ public:
             m_audioMax = KdenliveSettings::normalizechannels() ? pCore->projectItemModel()->getAudioMaxLevel(m_binId, m_stream) : 0;
             update();
         });
+        connect(this, &TimelineWaveform::loudnessChanged, [&]() {
+            m_loudness = LoudnessMap();
+            update();
+        });
+        connect(pCore.get(), &Core::loudnessUpdated, this, [&](const QString &binId) {
+            // A new analysis replaces the one we cached
+            if (binId == m_binId) {
+                m_loudness = LoudnessMap();
+                update();
+            }
+        });
         connect(this, &TimelineWaveform::propertyChanged, this, static_cast<void (QQuickItem::*)()>(&QQuickItem::update));
     }
 
@@ -272,17 +287,61 @@ public:
                 }
             }
         }
+        if (m_showLoudness) {
+            paintLoudness(painter, startPos, indicesPrPixel, reverse);
+        }
+    }
+
+    /** @brief Draw the short-term loudness from -60 LUFS (bottom) to 0 LUFS (top), and the normalization target */
+    void paintLoudness(QPainter *painter, int startPos, qreal indicesPrPixel, bool reverse)
+    {
+        if (m_loudness.isEmpty()) {
+            m_loudness = pCore->projectItemModel()->getLoudnessByBinID(m_binId, m_stream);
+            if (m_loudness.isEmpty()) {
+                return;
+            }
+        }
+        const double h = height();
+        QPainterPath path;
+        for (int i = 0; i <= width(); i++) {
+            int idx = reverse ? qCeil((startPos - i) * indicesPrPixel) : qCeil((startPos + i) * indicesPrPixel);
+            int frame = idx / m_channels;
+            if (frame < 0 || frame >= m_loudness.frames()) {
+                break;
+            }
+            double level = qBound(0., (m_loudness.shortTermAt(frame) + 60.) / 60., 1.);
+            if (i == 0) {
+                path.moveTo(i, h - level * h);
+            } else {
+                path.lineTo(i, h - level * h);
+            }
+        }
+        QPen pen(QColor(255, 170, 0));
+        pen.setWidthF(1.5);
+        painter->setOpacity(1);
+        painter->setBrush(Qt::NoBrush);
+        painter->setPen(pen);
+        painter->drawPath(path);
+        double target = h - qBound(0., (KdenliveSettings::loudnesstarget() + 60.) / 60., 1.) * h;
+        pen.setWidthF(0);
+        pen.setStyle(Qt::DashLine);
+        painter->setPen(pen);
+        painter->setOpacity(0.6);
+        painter->drawLine(QLineF(0., target, width(), target));
+        painter->setOpacity(1);
     }
 
 Q_SIGNALS:
     void levelsChanged();
     void propertyChanged();
     void normalizeChanged();
+    void loudnessChanged();
     void inPointChanged();
     void audioChannelsChanged();
 
 private:
     QVector<uint8_t> m_audioLevels;
+    LoudnessMap m_loudness;
     int m_inPoint;
     int m_outPoint;
     QString m_binId;
@@ -292,6 +351,7 @@ private:
     bool m_format;
     bool m_repaint;
     bool m_normalize;
+    bool m_showLoudness;
     int m_channels;
     int m_precisionFactor;
     int m_stream;
@@ -338,8 +398,10 @@ public:
 
     void paint(QPainter *painter) override
     {
-        const QVector<double> &audioLevels = pCore->getAudioDevice()->recLevels();
-        if (audioLevels.isEmpty()) {
+        const LivePeaks &audioLevels = pCore->getAudioDevice()->livePeaks();
+        // Only the values below this count can be read while recording
+        int maxLength = audioLevels.count();
+        if (maxLength == 0) {
             return;
         }
 
@@ -351,7 +413,6 @@ public:
             painter->fillRect(bgRect, m_bgColor);
         }
         QPen pen(painter->pen());
-        int maxLength = audioLevels.length();
         double increment = 1 / m_scale;
         qreal indicesPrPixel = m_channels / m_scale; // qreal(m_outPoint - m_inPoint) / width() * m_precisionFactor;
         int h = int(height());
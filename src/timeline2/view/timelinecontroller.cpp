@@ -24,6 +24,7 @@
 #include "effects/effectsrepository.hpp"
 #include "effects/effectstack/model/effectstackmodel.hpp"
 #include "glaxnimatelauncher.h"
+#include "jobs/effectcosttask.h"
 #include "kdenlivesettings.h"
 #include "lib/audio/audioEnvelope.h"
 #include "mainwindow.h"
@@ -40,15 +41,18 @@
 #include "timeline2/view/timelinewidget.h"
 #include "transitions/transitionsrepository.hpp"
 #include "ui_import_subtitle_ui.h"
+#include "xml/xml.hpp"
 
 #include <KCharsets>
 #include <KColorScheme>
 #include <KMessageBox>
+#include <KMessageWidget>
 #include <KRecentDirs>
 #include <KUrlRequesterDialog>
 #include <QClipboard>
 #include <QFontDatabase>
 #include <QQuickItem>
+#include <QUuid>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #include <QTextCodec>
 #endif
@@ -131,6 +135,7 @@ void TimelineController::setModel(std::shared_ptr<TimelineItemModel> model)
     connect(this, &TimelineController::videoTargetChanged, this, &TimelineController::updateVideoTarget);
     connect(this, &TimelineController::audioTargetChanged, this, &TimelineController::updateAudioTarget);
     connect(m_model.get(), &TimelineItemModel::requestMonitorRefresh, [&]() { pCore->refreshProjectMonitorOnce(); });
+    connect(m_model.get(), &TimelineModel::invalidateZone, this, [](int, int) { pCore->monitorManager()->projectMonitor()->invalidateAudioScrub(); });
     connect(m_model.get(), &TimelineModel::durationUpdated, this, &TimelineController::checkDuration);
     connect(m_model.get(), &TimelineModel::selectionChanged, this, &TimelineController::selectionChanged);
     connect(m_model.get(), &TimelineModel::selectedMixChanged, this, &TimelineController::showMixModel);
@@ -836,6 +841,11 @@ bool TimelineController::audioThumbNormalize() const
     return KdenliveSettings::normalizechannels();
 }
 
+bool TimelineController::loudnessOverlay() const
+{
+    return KdenliveSettings::loudnessoverlay();
+}
+
 bool TimelineController::showWaveforms() const
 {
     return KdenliveSettings::audiothumbnails();
@@ -2490,6 +2500,17 @@ void TimelineController::startPreviewRender()
     }
 }
 
+void TimelineController::initializePredictivePreview()
+{
+    if (!m_model->hasTimelinePreview()) {
+        initializePreview();
+    }
+    if (m_model->hasTimelinePreview() && !m_usePreview && !m_disablePreview->isChecked()) {
+        m_model->buildPreviewTrack();
+        m_usePreview = true;
+    }
+}
+
 void TimelineController::stopPreviewRender()
 {
     if (m_model->hasTimelinePreview()) {
@@ -3274,17 +3295,31 @@ void TimelineController::setAudioRef(int clipId)
     m_audioRef = clipId;
     std::unique_ptr<AudioEnvelope> envelope(new AudioEnvelope(getClipBinId(clipId), clipId));
     m_audioCorrelator.reset(new AudioCorrelation(std::move(envelope)));
-    connect(m_audioCorrelator.get(), &AudioCorrelation::gotAudioAlignData, this, [&](int cid, int shift) {
-        // Ensure the clip was not deleted while processing calculations
-        if (m_model->isClip(cid)) {
-            int pos = m_model->getClipPosition(m_audioRef) + shift - m_model->getClipIn(m_audioRef);
-            bool result = m_model->requestClipMove(cid, m_model->getClipTrackId(cid), pos, true, true, true);
-            if (!result) {
-                pCore->displayMessage(i18n("Cannot move clip to frame %1.", (pos + shift)), ErrorMessage, 500);
-            }
-        } else {
-            // Clip was deleted, discard audio reference
+    m_pendingAlignPositions.clear();
+    connect(m_audioCorrelator.get(), &AudioCorrelation::gotAudioAlignBatch, this, [this](const QMap<int, int> &shifts, const QMap<int, double> &remainders) {
+        if (!m_model->isClip(m_audioRef)) {
+            // Reference clip was deleted, discard audio reference
             m_audioRef = -1;
+            m_pendingAlignPositions.clear();
+            return;
+        }
+        QMap<int, int> positions = m_pendingAlignPositions;
+        m_pendingAlignPositions.clear();
+        const int refStart = m_model->getClipPosition(m_audioRef) - m_model->getClipIn(m_audioRef);
+        // Clip positions are frame based, move each clip to the closest frame and report what could not be applied
+        double residual = 0.;
+        QMapIterator<int, int> i(shifts);
+        while (i.hasNext()) {
+            i.next();
+            const double remainder = remainders.value(i.key());
+            const int correction = qRound(remainder);
+            residual = qMax(residual, qAbs(remainder - correction));
+            positions.insert(i.key(), refStart + i.value() + correction);
+        }
+        applyAudioAlignment(positions);
+        if (!shifts.isEmpty()) {
+            pCore->displayMessage(i18n("Audio aligned, remaining offset: %1 ms", qRound(1000. * residual / pCore->getCurrentFps())), OperationCompletedMessage,
+                                  300);
         }
     });
     connect(m_audioCorrelator.get(), &AudioCorrelation::displayMessage, pCore.get(), &Core::displayMessage);
@@ -3313,6 +3348,7 @@ void TimelineController::alignAudio(int clipId)
         clipsToAnalyse.insert(clipId);
     }
     QList<int> processedGroups;
+    QList<AudioEnvelope *> envelopes;
     int processed = 0;
     for (int cid : clipsToAnalyse) {
         if (!m_model->isClip(cid) || cid == m_audioRef) {
@@ -3340,23 +3376,128 @@ void TimelineController::alignAudio(int clipId)
             // easy, same clip.
             int newPos = m_model->getClipPosition(m_audioRef) - m_model->getClipIn(m_audioRef) + m_model->getClipIn(cid);
             if (newPos) {
-                bool result = m_model->requestClipMove(cid, m_model->getClipTrackId(cid), newPos, true, true, true);
+                m_pendingAlignPositions.insert(cid, newPos);
                 processed++;
-                if (!result) {
-                    pCore->displayMessage(i18n("Cannot move clip to frame %1.", newPos), ErrorMessage, 500);
-                }
                 continue;
             }
         }
         processed++;
         // Perform audio calculation
-        auto *envelope =
-            new AudioEnvelope(otherBinId, cid, size_t(m_model->getClipIn(cid)), size_t(m_model->getClipPlaytime(cid)), size_t(m_model->getClipPosition(cid)));
-        m_audioCorrelator->addChild(envelope);
+        envelopes << new AudioEnvelope(otherBinId, cid, size_t(m_model->getClipIn(cid)), size_t(m_model->getClipPlaytime(cid)),
+                                       size_t(m_model->getClipPosition(cid)));
     }
     if (processed == 0) {
         // TODO: improve feedback message after freeze
         pCore->displayMessage(i18n("Select a clip to apply an effect"), ErrorMessage, 500);
+    } else if (envelopes.isEmpty()) {
+        // Nothing to analyse, move the clips now
+        applyAudioAlignment(m_pendingAlignPositions);
+        m_pendingAlignPositions.clear();
+    } else {
+        // All envelopes are computed and correlated concurrently, the moves are applied when the last one is done
+        m_audioCorrelator->addChildren(envelopes);
+    }
+}
+
+void TimelineController::measureEffectCost(int clipId)
+{
+    std::unordered_set<int> clips;
+    if (clipId == -1) {
+        clips = m_model->getCurrentSelection();
+    } else {
+        clips.insert(clipId);
+    }
+    int count = 0;
+    for (int cid : clips) {
+        if (!m_model->isClip(cid) || m_model->getClipEffectStackModel(cid)->rowCount() == 0) {
+            continue;
+        }
+        m_slowClips.removeAll(cid);
+        int in = m_model->getClipIn(cid);
+        EffectCostTask::start(ObjectId(ObjectType::TimelineClip, cid), m_model->uuid(), getClipBinId(cid), in, in + m_model->getClipPlaytime(cid) - 1, this);
+        count++;
+    }
+    if (count == 0) {
+        pCore->displayMessage(i18n("No clip with effects selected"), InformationMessage, 500);
+    }
+}
+
+void TimelineController::setEffectCost(int clipId, double cost, double effectsMs)
+{
+    if (!m_model->isClip(clipId)) {
+        return;
+    }
+    m_model->getClipPtr(clipId)->setEffectCost(cost);
+    QModelIndex ix = m_model->makeClipIndexFromID(clipId);
+    Q_EMIT m_model->dataChanged(ix, ix, {TimelineModel::EffectCostRole});
+    if (cost <= 1.) {
+        pCore->displayMessage(i18n("Clip plays in real time, its effects take %1 ms per frame", QString::number(effectsMs, 'f', 1)), InformationMessage,
+                              2000);
+        return;
+    }
+    m_slowClips << clipId;
+    // Forget the clips that were deleted or whose effects changed since their measurement
+    m_slowClips.erase(std::remove_if(m_slowClips.begin(), m_slowClips.end(),
+                                     [this](int cid) { return !m_model->isClip(cid) || m_model->getClipPtr(cid)->effectCost() <= 1.; }),
+                      m_slowClips.end());
+    // The bin message deletes its actions when replaced, but a closed message keeps them: only keep the action of the last message
+    delete m_renderSlowClipsAction;
+    m_renderSlowClipsAction = new QAction(i18n("Render Preview"), this);
+    connect(m_renderSlowClipsAction, &QAction::triggered, this, [this]() {
+        renderClipsPreview(m_slowClips);
+        m_slowClips.clear();
+        m_renderSlowClipsAction->deleteLater();
+    });
+    pCore->displayBinMessage(i18np("%1 clip cannot play its effects in real time", "%1 clips cannot play their effects in real time", m_slowClips.count()),
+                             int(KMessageWidget::Warning), {m_renderSlowClipsAction}, true);
+}
+
+void TimelineController::renderClipsPreview(const QList<int> &clipIds)
+{
+    if (!m_model->hasTimelinePreview()) {
+        initializePreview();
+    }
+    if (!m_model->hasTimelinePreview()) {
+        return;
+    }
+    for (int cid : clipIds) {
+        if (!m_model->isClip(cid)) {
+            continue;
+        }
+        int position = m_model->getClipPosition(cid);
+        m_model->previewManager()->addPreviewRange(QPoint(position, position + m_model->getClipPlaytime(cid) - 1), true);
+    }
+    startPreviewRender();
+}
+
+void TimelineController::applyAudioAlignment(const QMap<int, int> &positions)
+{
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    bool moved = false;
+    QMapIterator<int, int> i(positions);
+    while (i.hasNext()) {
+        i.next();
+        int cid = i.key();
+        // Ensure the clip was not deleted while processing calculations
+        if (!m_model->isClip(cid)) {
+            continue;
+        }
+        bool result;
+        if (m_model->m_groups->isInGroup(cid)) {
+            int groupId = m_model->m_groups->getRootId(cid);
+            result = m_model->requestGroupMove(cid, groupId, 0, i.value() - m_model->getClipPosition(cid), true, true, undo, redo);
+        } else {
+            result = m_model->requestClipMove(cid, m_model->getClipTrackId(cid), i.value(), true, true, true, true, undo, redo);
+        }
+        if (result) {
+            moved = true;
+        } else {
+            pCore->displayMessage(i18n("Cannot move clip to frame %1.", i.value()), ErrorMessage, 500);
+        }
+    }
+    if (moved) {
+        pCore->pushUndo(undo, redo, i18n("Align Audio"));
     }
 }
 
@@ -3636,7 +3777,7 @@ void TimelineController::deleteEffects(int targetId)
     pCore->pushUndo(undo, redo, i18n("Delete effects"));
 }
 
-void TimelineController::pasteEffects(int targetId)
+void TimelineController::pasteEffects(int targetId, bool linked)
 {
     std::unordered_set<int> targetIds;
     std::unordered_set<int> sel;
@@ -3687,6 +3828,31 @@ void TimelineController::pasteEffects(int targetId)
     }
     std::function<bool(void)> undo = []() { return true; };
     std::function<bool(void)> redo = []() { return true; };
+    if (linked) {
+        // Link the pasted effects to the copied ones if these are still in the timeline, and to each other
+        const bool sameDocument =
+            copiedItems.documentElement().attribute(QStringLiteral("documentid")) == pCore->currentDoc()->getDocumentProperty(QStringLiteral("documentid"));
+        for (int i = 0; i < clips.size(); i++) {
+            QDomElement clip = clips.at(i).toElement();
+            int sourceId = clip.attribute(QStringLiteral("id"), QStringLiteral("-1")).toInt();
+            std::shared_ptr<EffectStackModel> sourceStack;
+            if (sameDocument && m_model->isClip(sourceId) && m_model->getClipBinId(sourceId) == clip.attribute(QStringLiteral("binid"))) {
+                sourceStack = m_model->getClipEffectStackModel(sourceId);
+            }
+            QDomNodeList effectNodes = clip.firstChildElement(QStringLiteral("effects")).elementsByTagName(QStringLiteral("effect"));
+            for (int j = 0; j < effectNodes.count(); j++) {
+                QDomElement effectNode = effectNodes.item(j).toElement();
+                QString linkId;
+                if (sourceStack) {
+                    linkId = sourceStack->linkEffect(j, effectNode.attribute(QStringLiteral("id")), undo, redo);
+                }
+                if (linkId.isEmpty()) {
+                    linkId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+                }
+                Xml::setXmlProperty(effectNode, QStringLiteral("kdenlive:link_id"), linkId);
+            }
+        }
+    }
     QDomElement effects = clips.at(0).firstChildElement(QStringLiteral("effects"));
     effects.setAttribute(QStringLiteral("parentIn"), clips.at(0).toElement().attribute(QStringLiteral("in")));
     for (int i = 1; i < clips.size(); i++) {
@@ -3705,7 +3871,7 @@ void TimelineController::pasteEffects(int targetId)
         }
     }
     if (insertedEffects > 0) {
-        pCore->pushUndo(undo, redo, i18n("Paste effects"));
+        pCore->pushUndo(undo, redo, linked ? i18n("Paste linked effects") : i18n("Paste effects"));
     } else {
         pCore->displayMessage(i18n("Cannot paste effect on selected clip"), ErrorMessage, 500);
         undo();
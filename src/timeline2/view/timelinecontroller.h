@@ -12,6 +12,7 @@
 #include <KActionCollection>
 #include <QApplication>
 #include <QDir>
+#include <QPointer>
 
 class QAction;
 class QQuickItem;
@@ -33,6 +34,7 @@ class TimelineController : public QObject
     Q_PROPERTY(int fullDuration READ fullDuration NOTIFY durationChanged)
     Q_PROPERTY(bool audioThumbFormat READ audioThumbFormat NOTIFY audioThumbFormatChanged)
     Q_PROPERTY(bool audioThumbNormalize READ audioThumbNormalize NOTIFY audioThumbNormalizeChanged)
+    Q_PROPERTY(bool loudnessOverlay READ loudnessOverlay NOTIFY loudnessOverlayChanged)
     Q_PROPERTY(int zoneIn READ zoneIn WRITE setZoneIn NOTIFY zoneChanged)
     Q_PROPERTY(int zoneOut READ zoneOut WRITE setZoneOut NOTIFY zoneChanged)
     Q_PROPERTY(bool ripple READ ripple NOTIFY rippleChanged)
@@ -281,6 +283,7 @@ public:
     bool showMarkers() const;
     bool audioThumbFormat() const;
     bool audioThumbNormalize() const;
+    bool loudnessOverlay() const;
     /** @brief Do we want to display audio thumbnails
      */
     Q_INVOKABLE bool showWaveforms() const;
@@ -459,6 +462,12 @@ public:
     Q_INVOKABLE void splitVideo(int clipId);
     Q_INVOKABLE void setAudioRef(int clipId = -1);
     Q_INVOKABLE void alignAudio(int clipId = -1);
+    /** @brief Measure the playback cost of the effects of the selected clips, or of @param clipId */
+    void measureEffectCost(int clipId = -1);
+    /** @brief Receive the cost measured for @param clipId as a ratio of the frame duration, @param effectsMs being the part of the effects */
+    void setEffectCost(int clipId, double cost, double effectsMs);
+    /** @brief Render the timeline preview over the clips @param clipIds so that they play in real time */
+    void renderClipsPreview(const QList<int> &clipIds);
     Q_INVOKABLE void urlDropped(QStringList droppedFile, int frame, int tid);
 
     Q_INVOKABLE bool endFakeMove(int clipId, int position, bool updateView, bool logUndo, bool invalidateTimeline);
@@ -470,7 +479,10 @@ public:
 
     /** @brief Seeks to selected clip start / end
      */
-    Q_INVOKABLE void pasteEffects(int targetId = -1);
+    /** @brief Paste the effects of the copied clips on the selection or on @param targetId.
+        If @param linked is true, the pasted effects are linked to the copied ones and to each other
+     */
+    Q_INVOKABLE void pasteEffects(int targetId = -1, bool linked = false);
     Q_INVOKABLE void deleteEffects(int targetId = -1);
     Q_INVOKABLE double fps() const;
     Q_INVOKABLE void addEffectKeyframe(int cid, int frame, double val);
@@ -571,6 +583,8 @@ public:
     void clearPreviewRange(bool resetZones);
     void startPreviewRender();
     void stopPreviewRender();
+    /** @brief Make sure the preview track exists so that heavy chunks can be rendered in predictive mode */
+    void initializePredictivePreview();
     QVariantList dirtyChunks() const;
     QVariantList renderedChunks() const;
     /** @brief returns the frame currently processed by timeline preview, -1 if none
@@ -736,6 +750,10 @@ private:
     int m_audioTarget;
     int m_videoTarget;
     int m_audioRef;
+    /** @brief The measured clips that cannot play in real time */
+    QList<int> m_slowClips;
+    /** @brief The action of the last slow clips message, deleted by the bin when another message replaces it */
+    QPointer<QAction> m_renderSlowClipsAction;
     int m_hasAudioTarget {0};
     bool m_hasVideoTarget {false};
     int m_lastVideoTarget {-1};
@@ -750,6 +768,8 @@ private:
     double m_scale;
     QAction *m_disablePreview;
     std::shared_ptr<AudioCorrelation> m_audioCorrelator;
+    /** @brief Positions of clips aligned without analysis (same source as the reference), applied with the next analysis batch */
+    QMap<int, int> m_pendingAlignPositions;
     QMutex m_metaMutex;
     bool m_ready;
     std::vector<int> m_activeSnaps;
@@ -764,6 +784,8 @@ private:
 
     void initializePreview();
     int getMenuOrTimelinePos() const;
+    /** @brief Move all clips of an audio alignment to their new position {clip id, position} in one undo entry */
+    void applyAudioAlignment(const QMap<int, int> &positions);
 
 Q_SIGNALS:
     void selected(Mlt::Producer *producer);
@@ -774,6 +796,7 @@ Q_SIGNALS:
     void scaleFactorChanged();
     void audioThumbFormatChanged();
     void audioThumbNormalizeChanged();
+    void loudnessOverlayChanged();
     void durationChanged(int duration);
     void audioTargetChanged();
     void videoTargetChanged();
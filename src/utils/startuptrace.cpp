@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "startuptrace.h"
+#include "kdenlive_debug.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+struct TraceEntry
+{
+    QString name;
+    qint64 start;
+    // -1 for instant events
+    qint64 duration;
+    int depth;
+};
+
+struct TraceState
+{
+    bool enabled{false};
+    QString path;
+    QElapsedTimer timer;
+    QVector<TraceEntry> entries;
+    int depth{0};
+};
+
+TraceState &state()
+{
+    static TraceState trace;
+    return trace;
+}
+} // namespace
+
+StartupTrace::Phase::Phase(const char *name)
+    : m_name(name)
+    , m_start(-1)
+    , m_depth(0)
+{
+    TraceState &trace = state();
+    if (trace.enabled) {
+        m_start = trace.timer.nsecsElapsed();
+        m_depth = trace.depth++;
+    }
+}
+
+StartupTrace::Phase::~Phase()
+{
+    TraceState &trace = state();
+    if (m_start < 0 || !trace.enabled) {
+        return;
+    }
+    trace.depth = m_depth;
+    trace.entries.append({QString::fromUtf8(m_name), m_start, trace.timer.nsecsElapsed() - m_start, m_depth});
+}
+
+void StartupTrace::enable(const QString &outputPath)
+{
+    TraceState &trace = state();
+    trace.enabled = true;
+    trace.path = outputPath;
+    trace.timer.start();
+}
+
+bool StartupTrace::isEnabled()
+{
+    return state().enabled;
+}
+
+void StartupTrace::mark(const char *name)
+{
+    TraceState &trace = state();
+    if (trace.enabled) {
+        trace.entries.append({QString::fromUtf8(name), trace.timer.nsecsElapsed(), -1, trace.depth});
+    }
+}
+
+void StartupTrace::finish()
+{
+    TraceState &trace = state();
+    if (!trace.enabled) {
+        return;
+    }
+    trace.enabled = false;
+    const qint64 total = trace.timer.nsecsElapsed();
+    // Phases are recorded when they end, list them in start order
+    std::stable_sort(trace.entries.begin(), trace.entries.end(), [](const TraceEntry &a, const TraceEntry &b) { return a.start < b.start; });
+    QJsonArray phases;
+    for (const TraceEntry &entry : qAsConst(trace.entries)) {
+        QJsonObject phase;
+        phase.insert(QStringLiteral("name"), entry.name);
+        phase.insert(QStringLiteral("start"), entry.start / 1000000.);
+        if (entry.duration >= 0) {
+            phase.insert(QStringLiteral("duration"), entry.duration / 1000000.);
+        }
+        phase.insert(QStringLiteral("depth"), entry.depth);
+        phases.append(phase);
+        qCDebug(KDENLIVE_LOG) << "Startup:" << QString(entry.depth * 2, QLatin1Char(' ')) + entry.name << "at" << entry.start / 1000000 << "ms"
+                              << (entry.duration >= 0 ? QStringLiteral("took %1 ms").arg(entry.duration / 1000000.) : QString());
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("total"), total / 1000000.);
+    root.insert(QStringLiteral("phases"), phases);
+    QSaveFile file(trace.path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson()) < 0 || !file.commit()) {
+        qCWarning(KDENLIVE_LOG) << "Cannot write startup trace to" << trace.path;
+    }
+    trace.entries.clear();
+}
@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QString>
+
+/** @class StartupTrace
+    @brief Records the wall time of the startup phases, enabled with the --startup-trace command line option.
+    When enabled, the phases are written as JSON to the requested file once the main window is interactive.
+    All calls are expected from the main thread and do nothing if the trace is not enabled.
+ */
+class StartupTrace
+{
+public:
+    /** @class Phase
+        @brief Measures the phase @param name, from construction to destruction
+     */
+    class Phase
+    {
+    public:
+        explicit Phase(const char *name);
+        ~Phase();
+
+    private:
+        const char *m_name;
+        qint64 m_start;
+        int m_depth;
+    };
+
+    /** @brief Start the trace, the result will be written to @param outputPath */
+    static void enable(const QString &outputPath);
+    static bool isEnabled();
+    /** @brief Record the instant event @param name, like the first display of a widget */
+    static void mark(const char *name);
+    /** @brief Write the trace file, later phases are ignored */
+    static void finish();
+};
@@ -0,0 +1,50 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+
+#include "lib/audio/audioCorrelation.h"
+#include "lib/audio/fftCorrelation.h"
+
+#include <cmath>
+#include <vector>
+
+// A decaying tone burst, which has a single clear correlation peak
+static std::vector<qint64> burst(size_t size, size_t start, double period)
+{
+    std::vector<qint64> values(size, 0);
+    for (size_t i = start; i < size; ++i) {
+        double t = double(i - start);
+        values[i] = qint64(10000 * std::exp(-t / 200.) * std::sin(2 * M_PI * t / period));
+    }
+    return values;
+}
+
+TEST_CASE("Audio correlation", "[AudioCorrelation]")
+{
+    SECTION("Cached reference spectrum gives the same result as the plain FFT correlation")
+    {
+        std::vector<qint64> main = burst(1000, 400, 17.);
+        std::vector<qint64> sub = burst(300, 50, 17.);
+        std::vector<qint64> expected(main.size() + sub.size() + 1);
+        std::vector<qint64> result(main.size() + sub.size() + 1);
+        FFTCorrelation::correlate(&main[0], main.size(), &sub[0], sub.size(), &expected[0]);
+        const FFTCorrelation::Spectrum spectrum =
+            FFTCorrelation::spectrum(&main[0], main.size(), FFTCorrelation::fftSize(main.size(), sub.size()));
+        FFTCorrelation::correlate(spectrum, &sub[0], sub.size(), &result[0]);
+        for (size_t i = 0; i < result.size(); ++i) {
+            REQUIRE(qAbs(result[i] - expected[i]) <= 1);
+        }
+    }
+
+    SECTION("Fine lag is found with sample precision")
+    {
+        // sub[0] matches main[350 + 3]
+        std::vector<qint64> main = burst(2000, 400, 23.);
+        std::vector<qint64> sub(main.begin() + 353, main.begin() + 1353);
+        REQUIRE(qAbs(AudioCorrelation::fineLag(main, sub, 350, 20) - 3.) < 0.5);
+        // A lag outside the search range is not found
+        REQUIRE(qAbs(AudioCorrelation::fineLag(main, sub, 300, 20) - 53.) > 1.);
+    }
+}
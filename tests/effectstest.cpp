@@ -16,6 +16,7 @@
 #include "definitions.h"
 #define private public
 #define protected public
+#include "assets/keyframes/model/keyframemodel.hpp"
 #include "core.h"
 #include "effects/effectsrepository.hpp"
 #include "effects/effectstack/model/effectitemmodel.hpp"
@@ -110,3 +111,107 @@ TEST_CASE("Effects stack", "[Effects]")
     }
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
+
+TEST_CASE("Linked effects", "[Effects]")
+{
+    auto binModel = pCore->projectItemModel();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    KdenliveDoc document(undoStack);
+
+    pCore->projectManager()->m_project = &document;
+    QDateTime documentDate = QDateTime::currentDateTime();
+    pCore->projectManager()->updateTimeline(0, false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->m_activeTimelineModel = timeline;
+    pCore->projectManager()->testSetActiveDocument(&document, timeline);
+
+    int tid1;
+    REQUIRE(timeline->requestTrackInsertion(-1, tid1));
+    QString binId = createProducer(pCore->getProjectProfile(), "red", binModel, 50);
+
+    // Four instances of the same clip, the second one with a different in point
+    int cid1;
+    int cid2;
+    int cid3;
+    int cid4;
+    REQUIRE(timeline->requestClipInsertion(binId, tid1, 0, cid1));
+    REQUIRE(timeline->requestClipInsertion(binId, tid1, 100, cid2));
+    REQUIRE(timeline->requestClipInsertion(binId, tid1, 200, cid3));
+    REQUIRE(timeline->requestClipInsertion(binId, tid1, 300, cid4));
+    REQUIRE(timeline->requestItemResize(cid2, 40, false) > -1);
+    REQUIRE(timeline->getClipIn(cid2) == 10);
+
+    // Paste the effect of the first clip as linked instances on the other ones
+    std::vector<std::shared_ptr<EffectItemModel>> effects;
+    for (int cid : {cid1, cid2, cid3, cid4}) {
+        auto stack = timeline->getClipEffectStackModel(cid);
+        REQUIRE(stack->appendEffect(QStringLiteral("brightness")));
+        effects.push_back(std::static_pointer_cast<EffectItemModel>(stack->getEffectStackRow(0)));
+    }
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    const QString linkId = timeline->getClipEffectStackModel(cid1)->linkEffect(0, QStringLiteral("brightness"), undo, redo);
+    REQUIRE_FALSE(linkId.isEmpty());
+    for (size_t i = 1; i < effects.size(); ++i) {
+        effects[i]->setLinkId(linkId);
+    }
+    REQUIRE(effects[0]->linkedEffects().size() == 3);
+
+    const QString defaultLevel = effects[1]->getParamFromName(QStringLiteral("level")).toString();
+    // The fourth instance overrides the shared definition
+    effects[3]->setParameter(QStringLiteral("level"), QStringLiteral("0.8"));
+    const QString overrideLevel = effects[3]->getParamFromName(QStringLiteral("level")).toString();
+    REQUIRE(overrideLevel != defaultLevel);
+
+    SECTION("Update keeps overrides and converts keyframes")
+    {
+        const QString keyframes = QStringLiteral("0=0.5;20=1");
+        effects[0]->setParameter(QStringLiteral("level"), keyframes);
+        // Keyframes are moved by the in point difference on the second clip
+        const QString shifted = KeyframeModel::getAnimationStringWithOffset(effects[1], keyframes, 10, 10 + 40 - 1);
+        REQUIRE(shifted != keyframes);
+        auto stateUpdated = [&]() {
+            REQUIRE(effects[1]->getParamFromName(QStringLiteral("level")).toString() == shifted);
+            REQUIRE(effects[2]->getParamFromName(QStringLiteral("level")).toString() == keyframes);
+            REQUIRE(effects[3]->getParamFromName(QStringLiteral("level")).toString() == overrideLevel);
+        };
+        auto stateInitial = [&]() {
+            REQUIRE(effects[1]->getParamFromName(QStringLiteral("level")).toString() == defaultLevel);
+            REQUIRE(effects[2]->getParamFromName(QStringLiteral("level")).toString() == defaultLevel);
+            REQUIRE(effects[3]->getParamFromName(QStringLiteral("level")).toString() == overrideLevel);
+        };
+        REQUIRE(effects[0]->updateLinkedEffects());
+        stateUpdated();
+        undoStack->undo();
+        stateInitial();
+        undoStack->redo();
+        stateUpdated();
+    }
+
+    SECTION("Unlink an instance")
+    {
+        effects[3]->unlinkEffect();
+        REQUIRE(effects[3]->linkId().isEmpty());
+        REQUIRE(effects[3]->linkedEffects().empty());
+        REQUIRE(effects[0]->linkedEffects().size() == 2);
+
+        // The unlinked instance is not updated anymore
+        effects[0]->setParameter(QStringLiteral("level"), QStringLiteral("0.3"));
+        const QString level = effects[0]->getParamFromName(QStringLiteral("level")).toString();
+        REQUIRE(effects[0]->updateLinkedEffects());
+        REQUIRE(effects[1]->getParamFromName(QStringLiteral("level")).toString() == level);
+        REQUIRE(effects[2]->getParamFromName(QStringLiteral("level")).toString() == level);
+        REQUIRE(effects[3]->getParamFromName(QStringLiteral("level")).toString() == overrideLevel);
+
+        // Undo the update, then the unlink
+        undoStack->undo();
+        REQUIRE(effects[1]->getParamFromName(QStringLiteral("level")).toString() == defaultLevel);
+        undoStack->undo();
+        REQUIRE(effects[3]->linkId() == linkId);
+        REQUIRE(effects[0]->linkedEffects().size() == 3);
+        undoStack->redo();
+        REQUIRE(effects[3]->linkId().isEmpty());
+        REQUIRE(effects[0]->linkedEffects().size() == 2);
+    }
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
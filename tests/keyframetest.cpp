@@ -261,4 +261,63 @@ TEST_CASE("Keyframe model", "[KeyframeModel]")
         undoStack->undo();
         state1(6.1);
     }
+
+    SECTION("Modifications are sent to the asset once")
+    {
+        REQUIRE(model->addKeyframe(GenTime(1.1), KeyframeType::Linear, 42));
+        REQUIRE(model->addKeyframe(GenTime(12.6), KeyframeType::Discrete, 33));
+        // Nothing is serialized before the event loop runs
+        REQUIRE(model->m_pendingModification);
+        REQUIRE(effect->data(index, AssetParameterModel::ValueRole).toString() != model->getAnimProperty());
+        QCoreApplication::processEvents();
+        REQUIRE_FALSE(model->m_pendingModification);
+        REQUIRE(effect->data(index, AssetParameterModel::ValueRole).toString() == model->getAnimProperty());
+        REQUIRE(check_anim_identity(model));
+    }
+
+    SECTION("Identical keyframes are shared until modified")
+    {
+        REQUIRE(model->addKeyframe(GenTime(1.1), KeyframeType::Linear, 42));
+        auto model2 = std::make_shared<KeyframeModel>(effect, index, undoStack);
+        REQUIRE(model2->addKeyframe(GenTime(1.1), KeyframeType::Linear, 42));
+        REQUIRE(model2->shareKeyframes(*model.get()));
+        REQUIRE(model2->m_keyframeList.isSharedWith(model->m_keyframeList));
+        REQUIRE(model2->addKeyframe(GenTime(2.2), KeyframeType::Linear, 10));
+        REQUIRE_FALSE(model2->m_keyframeList.isSharedWith(model->m_keyframeList));
+        REQUIRE(model->rowCount() == 2);
+        REQUIRE(model2->rowCount() == 3);
+        REQUIRE_FALSE(model->shareKeyframes(*model2.get()));
+    }
+
+    SECTION("Bulk import with simplification")
+    {
+        std::shared_ptr<KeyframeModelList> list = effect->getKeyframeModel();
+        REQUIRE(list->count() == 1);
+        std::vector<Keyframe> keyframes;
+        QVector<QVariant> values;
+        for (int i = 1; i <= 20; ++i) {
+            keyframes.push_back({GenTime(i, 25), KeyframeType::Linear});
+            // A ramp followed by a step
+            values << (i < 10 ? 2. * i : 100.);
+        }
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        REQUIRE(list->addKeyframes(keyframes, {{index, values}}, 0., undo, redo));
+        REQUIRE(list->count() == 21);
+        REQUIRE(undo());
+        REQUIRE(list->count() == 1);
+
+        undo = []() { return true; };
+        redo = []() { return true; };
+        REQUIRE(list->addKeyframes(keyframes, {{index, values}}, 0.01, undo, redo));
+        // Only the ends of the ramp and of the step are needed
+        REQUIRE(list->count() == 5);
+        REQUIRE(list->hasKeyframe(9));
+        REQUIRE(list->hasKeyframe(10));
+        REQUIRE(list->getInterpolatedValue(5, index).toDouble() == Approx(10.));
+        REQUIRE(undo());
+        REQUIRE(list->count() == 1);
+        REQUIRE(redo());
+        REQUIRE(list->count() == 5);
+    }
 }
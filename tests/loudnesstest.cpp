@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+
+#include "lib/audio/loudnessMeter.h"
+
+#include <QTemporaryDir>
+#include <cmath>
+#include <vector>
+
+// Feeds @param seconds of a stereo 1kHz sine with a peak level of @param dBFS to @param meter
+static void addSine(LoudnessMeter &meter, int frequency, int seconds, double dBFS)
+{
+    const double amplitude = 32767. * std::pow(10., dBFS / 20.);
+    std::vector<qint16> buffer(size_t(frequency) * 2);
+    for (int s = 0; s < seconds; ++s) {
+        for (int i = 0; i < frequency; ++i) {
+            double t = double(s * frequency + i) / frequency;
+            auto value = qint16(std::lrint(amplitude * std::sin(2 * M_PI * 1000. * t)));
+            buffer[size_t(2 * i)] = value;
+            buffer[size_t(2 * i + 1)] = value;
+        }
+        meter.addSamples(buffer.data(), frequency, 2);
+    }
+}
+
+TEST_CASE("Loudness measurement", "[Loudness]")
+{
+    SECTION("A -23 dBFS stereo sine reads -23 LUFS")
+    {
+        for (int frequency : {44100, 48000}) {
+            LoudnessMeter meter(frequency, 2);
+            addSine(meter, frequency, 20, -23.);
+            REQUIRE(std::abs(meter.integrated() + 23.) < 0.1);
+            REQUIRE(std::abs(meter.momentary() + 23.) < 0.1);
+            REQUIRE(std::abs(meter.shortTerm() + 23.) < 0.1);
+            REQUIRE(std::abs(meter.truePeak() + 23.) < 0.2);
+        }
+    }
+
+    SECTION("Silence and quiet parts are gated out of the integrated loudness")
+    {
+        LoudnessMeter meter(48000, 2);
+        addSine(meter, 48000, 10, -20.);
+        addSine(meter, 48000, 10, -80.);
+        addSine(meter, 48000, 10, -40.);
+        REQUIRE(std::abs(meter.integrated() + 20.) < 0.1);
+        REQUIRE(meter.shortTerm() < -39.);
+    }
+
+    SECTION("Loudness maps are saved and restored")
+    {
+        LoudnessMap map;
+        map.integrated = -18.5;
+        map.truePeak = -1.2;
+        map.momentary = {-2000, -1800, -12000};
+        map.shortTerm = {-2100, -1900, -2500};
+        QTemporaryDir dir;
+        const QString path = dir.filePath(QStringLiteral("map.loudness"));
+        REQUIRE(map.save(path));
+        LoudnessMap restored = LoudnessMap::load(path);
+        REQUIRE(restored.integrated == map.integrated);
+        REQUIRE(restored.truePeak == map.truePeak);
+        REQUIRE(restored.momentary == map.momentary);
+        REQUIRE(restored.shortTerm == map.shortTerm);
+        REQUIRE(restored.shortTermAt(1) == -19.);
+        // The silent frame is gated out
+        REQUIRE(std::abs(restored.rangeLoudness(0, 3) + 18.9) < 0.1);
+        REQUIRE(LoudnessMap::load(dir.filePath(QStringLiteral("missing"))).isEmpty());
+    }
+}
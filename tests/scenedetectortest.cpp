@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+
+#include "lib/video/sceneDetector.h"
+
+#include <cstdlib>
+
+TEST_CASE("Scene detection", "[SceneDetector]")
+{
+    SECTION("Vectorized difference matches the scalar one")
+    {
+        std::vector<quint8> a(1000);
+        std::vector<quint8> b(1000);
+        quint64 expected = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = quint8(i * 7);
+            b[i] = quint8(i * 13 + 5);
+            expected += quint64(std::abs(int(a[i]) - int(b[i])));
+        }
+        REQUIRE(SceneDetector::sumAbsDiff(a.data(), b.data(), int(a.size())) == expected);
+    }
+
+    SECTION("Scene values follow FFmpeg's select filter")
+    {
+        const int w = SceneDetector::width;
+        const int h = SceneDetector::height;
+        std::vector<quint8> black(size_t(w * h), 16);
+        std::vector<quint8> white(size_t(w * h), 235);
+        auto dark = SceneDetector::fromLuma(black.data(), w, h, w);
+        auto bright = SceneDetector::fromLuma(white.data(), w, h, w);
+        double mad = SceneDetector::meanAbsDiff(dark, bright);
+        CHECK(mad == Approx(219. / 256.));
+        // A cut after still frames scores its full difference
+        CHECK(SceneDetector::sceneScore(mad, 0.) == Approx(mad));
+        // Motion changing every frame by the same amount does not
+        CHECK(SceneDetector::sceneScore(0.2, 0.2) == Approx(0.));
+    }
+}
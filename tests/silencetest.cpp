@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+
+#include "lib/audio/silenceDetector.h"
+
+// Feeds @param frames frames at @param level to @param detector
+static void addFrames(SilenceDetector &detector, int frames, double level)
+{
+    for (int i = 0; i < frames; ++i) {
+        detector.addFrame(level);
+    }
+}
+
+TEST_CASE("Silence detection", "[Silence]")
+{
+    SECTION("Short pauses are ignored and silences are padded")
+    {
+        SilenceDetector detector(-40., 10, 2);
+        addFrames(detector, 20, -60.);
+        addFrames(detector, 30, -10.);
+        // Too short to be a silence
+        addFrames(detector, 5, -60.);
+        addFrames(detector, 30, -10.);
+        addFrames(detector, 20, -60.);
+        addFrames(detector, 10, -10.);
+        QVector<QPair<int, int>> silences = detector.silences();
+        REQUIRE(silences.size() == 2);
+        // No padding at the start of the clip
+        REQUIRE(silences.at(0) == qMakePair(0, 17));
+        REQUIRE(silences.at(1) == qMakePair(87, 102));
+        QVector<QPair<int, int>> regions = detector.activeRegions();
+        REQUIRE(regions.size() == 2);
+        REQUIRE(regions.at(0) == qMakePair(18, 86));
+        REQUIRE(regions.at(1) == qMakePair(103, 114));
+    }
+
+    SECTION("A silence running until the end is not padded at the end")
+    {
+        SilenceDetector detector(-40., 10, 2);
+        addFrames(detector, 10, -10.);
+        addFrames(detector, 15, -80.);
+        QVector<QPair<int, int>> silences = detector.silences();
+        REQUIRE(silences.size() == 1);
+        REQUIRE(silences.at(0) == qMakePair(12, 24));
+        REQUIRE(detector.activeRegions().size() == 1);
+    }
+
+    SECTION("Thumbnail levels convert back to dB")
+    {
+        REQUIRE(SilenceDetector::iecToDb(1.) == 0.);
+        REQUIRE(qAbs(SilenceDetector::iecToDb(0.5) + 20.) < 0.001);
+        REQUIRE(qAbs(SilenceDetector::iecToDb(0.15) + 40.) < 0.001);
+        REQUIRE(SilenceDetector::iecToDb(0.) <= -70.);
+    }
+}